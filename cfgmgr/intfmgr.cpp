@@ -20,13 +20,14 @@ IntfMgr::IntfMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb, c
         Orch(cfgDb, tableNames),
         m_cfgIntfTable(cfgDb, CFG_INTF_TABLE_NAME),
         m_cfgVlanIntfTable(cfgDb, CFG_VLAN_INTF_TABLE_NAME),
-        m_statePortTable(stateDb, STATE_PORT_TABLE_NAME),
-        m_stateLagTable(stateDb, STATE_LAG_TABLE_NAME),
-        m_stateVlanTable(stateDb, STATE_VLAN_TABLE_NAME),
-        m_stateVrfTable(stateDb, STATE_VRF_TABLE_NAME),
         m_stateIntfTable(stateDb, STATE_INTERFACE_TABLE_NAME),
+        m_stateCache(stateDb, { STATE_PORT_TABLE_NAME, STATE_LAG_TABLE_NAME, STATE_VLAN_TABLE_NAME, STATE_VRF_TABLE_NAME }),
         m_appIntfTableProducer(appDb, APP_INTF_TABLE_NAME)
 {
+    for (auto executor : m_stateCache.createExecutors(this))
+    {
+        addExecutor(executor);
+    }
 }
 
 void IntfMgr::setIntfIp(const string &alias, const string &opCmd,
@@ -68,11 +69,9 @@ void IntfMgr::setIntfVrf(const string &alias, const string vrfName)
 
 bool IntfMgr::isIntfStateOk(const string &alias)
 {
-    vector<FieldValueTuple> temp;
-
     if (!alias.compare(0, strlen(VLAN_PREFIX), VLAN_PREFIX))
     {
-        if (m_stateVlanTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_VLAN_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("Vlan %s is ready", alias.c_str());
             return true;
@@ -80,7 +79,7 @@ bool IntfMgr::isIntfStateOk(const string &alias)
     }
     else if (!alias.compare(0, strlen(LAG_PREFIX), LAG_PREFIX))
     {
-        if (m_stateLagTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_LAG_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("Lag %s is ready", alias.c_str());
             return true;
@@ -88,13 +87,13 @@ bool IntfMgr::isIntfStateOk(const string &alias)
     }
     else if (!alias.compare(0, strlen(VNET_PREFIX), VNET_PREFIX))
     {
-        if (m_stateVrfTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_VRF_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("Vnet %s is ready", alias.c_str());
             return true;
         }
     }
-    else if (m_statePortTable.get(alias, temp))
+    else if (m_stateCache.isReady(STATE_PORT_TABLE_NAME, alias))
     {
         SWSS_LOG_DEBUG("Port %s is ready", alias.c_str());
         return true;
@@ -0,0 +1,141 @@
+#include <net/if.h>
+#include <netlink/cache.h>
+#include <netlink/route/link.h>
+
+#include "logger.h"
+#include "netlink.h"
+#include "netdispatcher.h"
+#include "linkcache.h"
+
+using namespace std;
+using namespace swss;
+
+LinkCache::LinkCache()
+{
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, this);
+    NetDispatcher::getInstance().registerMessageHandler(RTM_DELLINK, this);
+}
+
+Executor *LinkCache::createExecutor(Orch *orch)
+{
+    auto netlink = new NetLink();
+
+    netlink->registerGroup(RTNLGRP_LINK);
+    netlink->dumpRequest(RTM_GETLINK);
+
+    return new Executor(netlink, orch, "NETLINK_LINK");
+}
+
+bool LinkCache::snapshot()
+{
+    SWSS_LOG_ENTER();
+
+    struct nl_sock *sock = nl_socket_alloc();
+    if (!sock)
+    {
+        SWSS_LOG_ERROR("Netlink socket alloc failed");
+        return false;
+    }
+
+    struct nl_cache *cache = nullptr;
+    int err = nl_connect(sock, NETLINK_ROUTE);
+    if (err >= 0)
+    {
+        err = rtnl_link_alloc_cache(sock, AF_UNSPEC, &cache);
+    }
+
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Netlink link dump failed, error '%s'", nl_geterror(err));
+        nl_socket_free(sock);
+        return false;
+    }
+
+    m_links.clear();
+    for (struct nl_object *obj = nl_cache_get_first(cache); obj; obj = nl_cache_get_next(obj))
+    {
+        update((struct rtnl_link *)obj);
+    }
+
+    SWSS_LOG_NOTICE("Loaded %zu kernel links", m_links.size());
+
+    nl_cache_free(cache);
+    nl_socket_free(sock);
+    return true;
+}
+
+void LinkCache::invalidate(const string &name)
+{
+    m_links.erase(name);
+}
+
+int LinkCache::getIfIndex(const string &name)
+{
+    auto it = m_links.find(name);
+    if (it != m_links.end())
+    {
+        return it->second.ifindex;
+    }
+
+    /*
+     * The notification may not have been processed yet, ask the kernel.
+     * The link is not cached since its state is not known.
+     */
+    return (int)if_nametoindex(name.c_str());
+}
+
+const LinkInfo *LinkCache::getLink(const string &name) const
+{
+    auto it = m_links.find(name);
+    if (it == m_links.end())
+    {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void LinkCache::onMsg(int nlmsg_type, struct nl_object *obj)
+{
+    struct rtnl_link *link = (struct rtnl_link *)obj;
+
+    if ((nlmsg_type != RTM_NEWLINK) && (nlmsg_type != RTM_DELLINK))
+    {
+        return;
+    }
+
+    const char *name = rtnl_link_get_name(link);
+    if (!name)
+    {
+        return;
+    }
+
+    if (nlmsg_type == RTM_DELLINK)
+    {
+        SWSS_LOG_DEBUG("Link %s removed", name);
+        m_links.erase(name);
+        return;
+    }
+
+    update(link);
+}
+
+void LinkCache::update(struct rtnl_link *link)
+{
+    const char *name = rtnl_link_get_name(link);
+    if (!name)
+    {
+        return;
+    }
+
+    LinkInfo &info = m_links[name];
+    const char *type = rtnl_link_get_type(link);
+
+    info.ifindex = rtnl_link_get_ifindex(link);
+    info.flags = rtnl_link_get_flags(link);
+    info.mtu = rtnl_link_get_mtu(link);
+    info.master = rtnl_link_get_master(link);
+    info.type = type ? type : "";
+
+    SWSS_LOG_DEBUG("Link %s ifindex %d flags 0x%x mtu %u", name, info.ifindex, info.flags, info.mtu);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <netlink/route/link.h>
+
+#include "netmsg.h"
+#include "orch.h"
+
+#include <map>
+#include <string>
+
+namespace swss {
+
+struct LinkInfo
+{
+    int             ifindex;
+    unsigned int    flags;      // IFF_* flags
+    unsigned int    mtu;
+    int             master;     // ifindex of the master device, 0 if none
+    std::string     type;       // link kind, e.g. "vxlan", empty for physical ports
+};
+
+/*
+ * Cache of the kernel links, kept up to date by listening to the rtnetlink
+ * link notifications, so that cfgmgr daemons can resolve an interface name
+ * or check the current state of a link without a system call per lookup.
+ *
+ * Only one cache can be used per process, since it registers itself to the
+ * netlink message dispatcher.
+ */
+class LinkCache : public NetMsg
+{
+public:
+    LinkCache();
+
+    /* Create the executor listening to the link notifications, to be added to the orch */
+    Executor *createExecutor(Orch *orch);
+
+    /* Load the current kernel links synchronously */
+    bool snapshot();
+
+    /* Forget a link changed by the owner, until it is seen again */
+    void invalidate(const std::string &name);
+
+    /* Return the ifindex of the link, or 0 if there is no such link */
+    int getIfIndex(const std::string &name);
+
+    /* Return the cached state of the link, or nullptr if it is not known */
+    const LinkInfo *getLink(const std::string &name) const;
+
+    const std::map<std::string, LinkInfo> &getLinks() const
+    {
+        return m_links;
+    }
+
+    void onMsg(int nlmsg_type, struct nl_object *obj) override;
+
+private:
+    std::map<std::string, LinkInfo> m_links;
+
+    void update(struct rtnl_link *link);
+};
+
+}
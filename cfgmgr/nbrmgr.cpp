@@ -1,6 +1,7 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <net/if.h>
+#include <errno.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "logger.h"
@@ -16,59 +17,28 @@ using namespace swss;
 #define VLAN_PREFIX "Vlan"
 #define LAG_PREFIX  "PortChannel"
 
-static bool send_message(struct nl_sock *sk, struct nl_msg *msg)
-{
-    bool rc = false;
-    int err = 0;
-
-    do
-    {
-        if (!sk)
-        {
-            SWSS_LOG_ERROR("Netlink socket null pointer");
-            break;
-        }
-
-        if ((err = nl_send_auto(sk, msg)) < 0)
-        {
-            SWSS_LOG_ERROR("Netlink send message failed, error '%s'", nl_geterror(err));
-            break;
-        }
-
-        rc = true;
-    } while(0);
-
-    nlmsg_free(msg);
-    return rc;
-}
-
 NbrMgr::NbrMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb, const vector<string> &tableNames) :
         Orch(cfgDb, tableNames),
-        m_statePortTable(stateDb, STATE_PORT_TABLE_NAME),
-        m_stateLagTable(stateDb, STATE_LAG_TABLE_NAME),
-        m_stateVlanTable(stateDb, STATE_VLAN_TABLE_NAME),
-        m_stateIntfTable(stateDb, STATE_INTERFACE_TABLE_NAME)
+        m_stateIntfTable(stateDb, STATE_INTERFACE_TABLE_NAME),
+        m_stateCache(stateDb, { STATE_PORT_TABLE_NAME, STATE_LAG_TABLE_NAME, STATE_VLAN_TABLE_NAME })
 {
-    int err = 0;
-
-    m_nl_sock = nl_socket_alloc();
-    if (!m_nl_sock)
+    for (auto executor : m_stateCache.createExecutors(this))
     {
-        SWSS_LOG_ERROR("Netlink socket alloc failed");
-    }
-    else if ((err = nl_connect(m_nl_sock, NETLINK_ROUTE)) < 0)
-    {
-        SWSS_LOG_ERROR("Netlink socket connect failed, error '%s'", nl_geterror(err));
+        addExecutor(executor);
     }
+
+    addExecutor(m_linkCache.createExecutor(this));
+
+    /* The neighbor requests are sent in batches, their acks are collected when the socket is selected */
+    m_nlBatch = new NetlinkBatch();
+    addExecutor(new Executor(m_nlBatch, this, "NETLINK_NEIGH_ACK"));
 }
 
 bool NbrMgr::isIntfStateOk(const string &alias)
 {
-    vector<FieldValueTuple> temp;
-
     if (!alias.compare(0, strlen(VLAN_PREFIX), VLAN_PREFIX))
     {
-        if (m_stateVlanTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_VLAN_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("Vlan %s is ready", alias.c_str());
             return true;
@@ -76,13 +46,13 @@ bool NbrMgr::isIntfStateOk(const string &alias)
     }
     else if (!alias.compare(0, strlen(LAG_PREFIX), LAG_PREFIX))
     {
-        if (m_stateLagTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_LAG_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("Lag %s is ready", alias.c_str());
             return true;
         }
     }
-    else if (m_statePortTable.get(alias, temp))
+    else if (m_stateCache.isReady(STATE_PORT_TABLE_NAME, alias))
     {
         SWSS_LOG_DEBUG("Port %s is ready", alias.c_str());
         return true;
@@ -91,7 +61,7 @@ bool NbrMgr::isIntfStateOk(const string &alias)
     return false;
 }
 
-bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddress& mac)
+struct nl_msg *NbrMgr::buildNeighMsg(int ifindex, const IpAddress& ip, const MacAddress& mac, bool add)
 {
     SWSS_LOG_ENTER();
 
@@ -99,17 +69,18 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
     if (!msg)
     {
         SWSS_LOG_ERROR("Netlink message alloc failed for '%s'", ip.to_string().c_str());
-        return false;
+        return nullptr;
     }
 
-    auto flags = (NLM_F_REQUEST | NLM_F_ACK | NLM_F_CREATE | NLM_F_REPLACE);
+    int type = add ? RTM_NEWNEIGH : RTM_DELNEIGH;
+    auto flags = add ? (NLM_F_REQUEST | NLM_F_ACK | NLM_F_CREATE | NLM_F_REPLACE) : (NLM_F_REQUEST | NLM_F_ACK);
 
-    struct nlmsghdr *hdr = nlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, RTM_NEWNEIGH, 0, flags);
+    struct nlmsghdr *hdr = nlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, type, 0, flags);
     if (!hdr)
     {
         SWSS_LOG_ERROR("Netlink message header alloc failed for '%s'", ip.to_string().c_str());
         nlmsg_free(msg);
-        return false;
+        return nullptr;
     }
 
     struct ndmsg *nd_msg = static_cast<struct ndmsg *>
@@ -118,12 +89,12 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
     {
         SWSS_LOG_ERROR("Netlink ndmsg reserve failed for '%s'", ip.to_string().c_str());
         nlmsg_free(msg);
-        return false;
+        return nullptr;
     }
 
     memset(nd_msg, 0, sizeof(struct ndmsg));
 
-    nd_msg->ndm_ifindex = if_nametoindex(alias.c_str());
+    nd_msg->ndm_ifindex = ifindex;
 
     auto addr_len = ip.isV4()? sizeof(struct in_addr) : sizeof(struct in6_addr);
 
@@ -133,7 +104,7 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
     {
         SWSS_LOG_ERROR("Netlink rtattr (IP) failed for '%s'", ip.to_string().c_str());
         nlmsg_free(msg);
-        return false;
+        return nullptr;
     }
 
     rta->rta_type = NDA_DST;
@@ -153,6 +124,11 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
         memcpy(RTA_DATA(rta), &ip_addr.ip_addr.ipv6_addr, addr_len);
     }
 
+    if (!add)
+    {
+        return msg;
+    }
+
     if (!mac)
     {
         /*
@@ -178,7 +154,7 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
         {
             SWSS_LOG_ERROR("Netlink rtattr (MAC) failed for '%s'", ip.to_string().c_str());
             nlmsg_free(msg);
-            return false;
+            return nullptr;
         }
 
         rta->rta_type = NDA_LLADDR;
@@ -186,7 +162,70 @@ bool NbrMgr::setNeighbor(const string& alias, const IpAddress& ip, const MacAddr
         memcpy(RTA_DATA(rta), mac_addr, mac_len);
     }
 
-    return send_message(m_nl_sock, msg);
+    return msg;
+}
+
+bool NbrMgr::setNeighbor(const string& key, const string& alias, const IpAddress& ip, const MacAddress& mac)
+{
+    SWSS_LOG_ENTER();
+
+    int ifindex = m_linkCache.getIfIndex(alias);
+    if (!ifindex)
+    {
+        SWSS_LOG_ERROR("Interface %s not found for '%s'", alias.c_str(), key.c_str());
+        return false;
+    }
+
+    struct nl_msg *msg = buildNeighMsg(ifindex, ip, mac, true);
+    if (!msg)
+    {
+        return false;
+    }
+
+    m_nlBatch->add(msg, key, [key](int error) {
+        if (error)
+        {
+            SWSS_LOG_ERROR("Neigh entry add failed for '%s', error '%s'", key.c_str(), strerror(-error));
+        }
+        else
+        {
+            SWSS_LOG_NOTICE("Neigh entry added for '%s'", key.c_str());
+        }
+    });
+
+    return true;
+}
+
+bool NbrMgr::delNeighbor(const string& key, const string& alias, const IpAddress& ip)
+{
+    SWSS_LOG_ENTER();
+
+    int ifindex = m_linkCache.getIfIndex(alias);
+    if (!ifindex)
+    {
+        /* The neighbors were removed along with the interface */
+        SWSS_LOG_INFO("Interface %s not found for '%s'", alias.c_str(), key.c_str());
+        return true;
+    }
+
+    struct nl_msg *msg = buildNeighMsg(ifindex, ip, MacAddress(), false);
+    if (!msg)
+    {
+        return false;
+    }
+
+    m_nlBatch->add(msg, key, [key](int error) {
+        if (error && error != -ENOENT)
+        {
+            SWSS_LOG_ERROR("Neigh entry remove failed for '%s', error '%s'", key.c_str(), strerror(-error));
+        }
+        else
+        {
+            SWSS_LOG_NOTICE("Neigh entry removed for '%s'", key.c_str());
+        }
+    });
+
+    return true;
 }
 
 void NbrMgr::doTask(Consumer &consumer)
@@ -240,18 +279,17 @@ void NbrMgr::doTask(Consumer &consumer)
                 continue;
             }
 
-            if (!setNeighbor(alias, ip, mac))
+            if (!setNeighbor(kfvKey(t), alias, ip, mac))
             {
                 SWSS_LOG_ERROR("Neigh entry add failed for '%s'", kfvKey(t).c_str());
             }
-            else
-            {
-                SWSS_LOG_NOTICE("Neigh entry added for '%s'", kfvKey(t).c_str());
-            }
         }
         else if (op == DEL_COMMAND)
         {
-            SWSS_LOG_NOTICE("Not yet implemented, key '%s'", kfvKey(t).c_str());
+            if (!delNeighbor(kfvKey(t), alias, ip))
+            {
+                SWSS_LOG_ERROR("Neigh entry remove failed for '%s'", kfvKey(t).c_str());
+            }
         }
         else
         {
@@ -260,4 +298,7 @@ void NbrMgr::doTask(Consumer &consumer)
 
         it = consumer.m_toSync.erase(it);
     }
+
+    /* Send the requests of this pass together, the results are logged as the acks arrive */
+    m_nlBatch->flush();
 }
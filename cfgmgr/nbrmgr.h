@@ -9,6 +9,9 @@
 #include "producerstatetable.h"
 #include "orch.h"
 #include "netmsg.h"
+#include "readinesscache.h"
+#include "linkcache.h"
+#include "netlinkbatch.h"
 
 using namespace std;
 
@@ -22,12 +25,16 @@ public:
 
 private:
     bool isIntfStateOk(const string &alias);
-    bool setNeighbor(const string& alias, const IpAddress& ip, const MacAddress& mac);
+    struct nl_msg *buildNeighMsg(int ifindex, const IpAddress& ip, const MacAddress& mac, bool add);
+    bool setNeighbor(const string& key, const string& alias, const IpAddress& ip, const MacAddress& mac);
+    bool delNeighbor(const string& key, const string& alias, const IpAddress& ip);
 
     void doTask(Consumer &consumer);
 
-    Table m_statePortTable, m_stateLagTable, m_stateVlanTable, m_stateIntfTable;
-    struct nl_sock *m_nl_sock;
+    Table m_stateIntfTable;
+    ReadinessCache m_stateCache;
+    LinkCache m_linkCache;
+    NetlinkBatch *m_nlBatch;    // owned by its executor
 };
 
 }
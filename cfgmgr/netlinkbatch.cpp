@@ -0,0 +1,318 @@
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <netlink/socket.h>
+#include <netlink/attr.h>
+
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "logger.h"
+#include "netlinkbatch.h"
+
+using namespace std;
+using namespace swss;
+
+/* Limits of a single sendmsg() */
+#define NETLINK_BATCH_MAX_MSGS      256
+#define NETLINK_BATCH_MAX_BYTES     (64 * 1024)
+
+/* Requests sent before waiting for their acks, so that the acks fit in the socket buffer */
+#define NETLINK_BATCH_MAX_INFLIGHT  1024
+#define NETLINK_BATCH_ACK_TIMEOUT   1000    // msecs
+#define NETLINK_BATCH_SOCK_BUF      (4 * 1024 * 1024)
+#define NETLINK_BATCH_RECV_BUF      8192
+
+struct nl_msg *swss::buildLinkMsg(int type, int flags, const string &name,
+                                  unsigned int ifflags, unsigned int ifchange)
+{
+    struct nl_msg *msg = nlmsg_alloc();
+    if (!msg)
+    {
+        return nullptr;
+    }
+
+    struct ifinfomsg ifi;
+    memset(&ifi, 0, sizeof(ifi));
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_flags = ifflags;
+    ifi.ifi_change = ifchange;
+
+    if (!nlmsg_put(msg, NL_AUTO_PORT, NL_AUTO_SEQ, type, 0, NLM_F_REQUEST | NLM_F_ACK | flags)
+     || nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO) < 0
+     || nla_put_string(msg, IFLA_IFNAME, name.c_str()) < 0)
+    {
+        nlmsg_free(msg);
+        return nullptr;
+    }
+
+    return msg;
+}
+
+NetlinkBatch::NetlinkBatch()
+{
+    int err = 0;
+
+    m_sock = nl_socket_alloc();
+    if (!m_sock)
+    {
+        SWSS_LOG_ERROR("Netlink socket alloc failed");
+        throw runtime_error("Netlink socket alloc failed");
+    }
+
+    if ((err = nl_connect(m_sock, NETLINK_ROUTE)) < 0)
+    {
+        SWSS_LOG_ERROR("Netlink socket connect failed, error '%s'", nl_geterror(err));
+        nl_socket_free(m_sock);
+        throw runtime_error("Netlink socket connect failed");
+    }
+
+    /* Every request asks for an ack, collected by readData() */
+    nl_socket_disable_auto_ack(m_sock);
+    nl_socket_set_nonblocking(m_sock);
+
+    if ((err = nl_socket_set_buffer_size(m_sock, NETLINK_BATCH_SOCK_BUF, NETLINK_BATCH_SOCK_BUF)) < 0)
+    {
+        SWSS_LOG_WARN("Netlink socket buffer size set failed, error '%s'", nl_geterror(err));
+    }
+}
+
+NetlinkBatch::~NetlinkBatch()
+{
+    for (auto &request : m_queued)
+    {
+        nlmsg_free(request.msg);
+    }
+
+    nl_socket_free(m_sock);
+}
+
+int NetlinkBatch::getFd()
+{
+    return nl_socket_get_fd(m_sock);
+}
+
+void NetlinkBatch::add(struct nl_msg *msg, const string &description, NetlinkAckCallback callback)
+{
+    nlmsg_hdr(msg)->nlmsg_flags |= NLM_F_ACK;
+
+    m_queued.push_back({ msg, description, callback });
+}
+
+void NetlinkBatch::flush()
+{
+    SWSS_LOG_ENTER();
+
+    while (!m_queued.empty())
+    {
+        if (m_inflight.size() >= NETLINK_BATCH_MAX_INFLIGHT)
+        {
+            waitAcks();
+        }
+
+        auto end = m_queued.begin();
+        size_t count = 0;
+        size_t bytes = 0;
+
+        while (end != m_queued.end() && count < NETLINK_BATCH_MAX_MSGS)
+        {
+            size_t len = nlmsg_hdr(end->msg)->nlmsg_len;
+            if (count > 0 && bytes + len > NETLINK_BATCH_MAX_BYTES)
+            {
+                break;
+            }
+
+            bytes += len;
+            count++;
+            end++;
+        }
+
+        /* Callbacks may queue new requests while the batch is completed */
+        vector<Request> requests(make_move_iterator(m_queued.begin()), make_move_iterator(end));
+        m_queued.erase(m_queued.begin(), end);
+
+        send(requests);
+    }
+}
+
+void NetlinkBatch::sync()
+{
+    SWSS_LOG_ENTER();
+
+    /* Requests queued by the callbacks are sent and waited for as well */
+    while (!m_queued.empty() || !m_inflight.empty())
+    {
+        flush();
+
+        while (!m_inflight.empty())
+        {
+            waitAcks();
+        }
+    }
+}
+
+void NetlinkBatch::send(vector<Request> &requests)
+{
+    vector<struct iovec> iov;
+
+    for (auto &request : requests)
+    {
+        nl_complete_msg(m_sock, request.msg);
+
+        struct nlmsghdr *hdr = nlmsg_hdr(request.msg);
+        iov.push_back({ hdr, hdr->nlmsg_len });
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = iov.data();
+    msg.msg_iovlen = iov.size();
+
+    ssize_t rc;
+    do
+    {
+        rc = sendmsg(getFd(), &msg, 0);
+    } while (rc < 0 && errno == EINTR);
+
+    int error = rc < 0 ? -errno : 0;
+    if (error)
+    {
+        SWSS_LOG_ERROR("Netlink send of %zu messages failed, error '%s'", iov.size(), strerror(-error));
+    }
+
+    for (auto &request : requests)
+    {
+        uint32_t seq = nlmsg_hdr(request.msg)->nlmsg_seq;
+
+        nlmsg_free(request.msg);
+        request.msg = nullptr;
+
+        if (error)
+        {
+            complete(request, error);
+        }
+        else
+        {
+            m_inflight[seq] = move(request);
+        }
+    }
+}
+
+void NetlinkBatch::waitAcks()
+{
+    SWSS_LOG_ENTER();
+
+    struct pollfd fds;
+    fds.fd = getFd();
+    fds.events = POLLIN;
+    fds.revents = 0;
+
+    int rc;
+    do
+    {
+        rc = poll(&fds, 1, NETLINK_BATCH_ACK_TIMEOUT);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc > 0)
+    {
+        readData();
+        return;
+    }
+
+    SWSS_LOG_ERROR("Netlink acks of %zu requests not received", m_inflight.size());
+
+    auto inflight = move(m_inflight);
+    m_inflight.clear();
+
+    for (auto &it : inflight)
+    {
+        complete(it.second, -ETIMEDOUT);
+    }
+}
+
+void NetlinkBatch::readData()
+{
+    char buf[NETLINK_BATCH_RECV_BUF];
+
+    while (true)
+    {
+        ssize_t len = recv(getFd(), buf, sizeof(buf), MSG_DONTWAIT);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+
+            if (errno == ENOBUFS)
+            {
+                /* Acks were dropped by the kernel, their requests can't be matched anymore */
+                SWSS_LOG_ERROR("Netlink socket overrun, %zu acks lost", m_inflight.size());
+
+                auto inflight = move(m_inflight);
+                m_inflight.clear();
+
+                for (auto &it : inflight)
+                {
+                    complete(it.second, -ENOBUFS);
+                }
+                continue;
+            }
+
+            SWSS_LOG_ERROR("Netlink receive failed, error '%s'", strerror(errno));
+            break;
+        }
+
+        for (struct nlmsghdr *hdr = (struct nlmsghdr *)buf; NLMSG_OK(hdr, len); hdr = NLMSG_NEXT(hdr, len))
+        {
+            if (hdr->nlmsg_type != NLMSG_ERROR)
+            {
+                continue;
+            }
+
+            auto it = m_inflight.find(hdr->nlmsg_seq);
+            if (it == m_inflight.end())
+            {
+                continue;
+            }
+
+            Request request = move(it->second);
+            m_inflight.erase(it);
+
+            struct nlmsgerr *err = (struct nlmsgerr *)NLMSG_DATA(hdr);
+            complete(request, err->error);
+        }
+    }
+}
+
+void NetlinkBatch::complete(Request &request, int error)
+{
+    if (request.callback)
+    {
+        request.callback(error);
+    }
+    else if (error)
+    {
+        SWSS_LOG_ERROR("Netlink request failed for '%s', error '%s'", request.description.c_str(), strerror(-error));
+    }
+    else
+    {
+        SWSS_LOG_DEBUG("Netlink request done for '%s'", request.description.c_str());
+    }
+}
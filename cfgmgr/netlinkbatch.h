@@ -0,0 +1,77 @@
+#pragma once
+
+#include <netlink/netlink.h>
+#include <netlink/msg.h>
+
+#include "selectable.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace swss {
+
+/* Called with the result of a request, 0 on success or a negative errno */
+typedef std::function<void(int error)> NetlinkAckCallback;
+
+/*
+ * Build a link request on the link named name, changing the ifchange bits
+ * of its flags to the values in ifflags. Return nullptr on failure.
+ */
+struct nl_msg *buildLinkMsg(int type, int flags, const std::string &name,
+                            unsigned int ifflags = 0, unsigned int ifchange = 0);
+
+/*
+ * Batch of rtnetlink requests. The queued requests are packed into as few
+ * sendmsg() calls as possible and the kernel acknowledgements are collected
+ * asynchronously, when the socket is selected as readable.
+ */
+class NetlinkBatch : public Selectable
+{
+public:
+    NetlinkBatch();
+    ~NetlinkBatch();
+
+    int getFd() override;
+    void readData() override;
+
+    /* Queue a request, the batch takes the ownership of the message */
+    void add(struct nl_msg *msg, const std::string &description, NetlinkAckCallback callback = nullptr);
+
+    /* Send the queued requests */
+    void flush();
+
+    /* Send the queued requests and wait for the acks of all the requests sent,
+     * including the requests queued by the callbacks meanwhile */
+    void sync();
+
+    size_t queued() const
+    {
+        return m_queued.size();
+    }
+
+    size_t inflight() const
+    {
+        return m_inflight.size();
+    }
+
+private:
+    struct Request
+    {
+        struct nl_msg       *msg;
+        std::string         description;
+        NetlinkAckCallback  callback;
+    };
+
+    struct nl_sock *m_sock;
+    std::deque<Request> m_queued;
+    std::map<uint32_t, Request> m_inflight;  // sequence number -> request
+
+    void send(std::vector<Request> &requests);
+    void waitAcks();
+    void complete(Request &request, int error);
+};
+
+}
@@ -1,11 +1,14 @@
+#include <string.h>
+#include <net/if.h>
+#include <linux/rtnetlink.h>
+#include <netlink/attr.h>
+
 #include "logger.h"
 #include "dbconnector.h"
 #include "producerstatetable.h"
 #include "tokenize.h"
 #include "ipprefix.h"
 #include "portmgr.h"
-#include "exec.h"
-#include "shellcmd.h"
 
 using namespace std;
 using namespace swss;
@@ -14,52 +17,122 @@ PortMgr::PortMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb, c
         Orch(cfgDb, tableNames),
         m_cfgPortTable(cfgDb, CFG_PORT_TABLE_NAME),
         m_cfgLagMemberTable(cfgDb, CFG_LAG_MEMBER_TABLE_NAME),
-        m_statePortTable(stateDb, STATE_PORT_TABLE_NAME),
+        m_stateCache(stateDb, { STATE_PORT_TABLE_NAME }),
         m_appPortTable(appDb, APP_PORT_TABLE_NAME)
 {
+    for (auto executor : m_stateCache.createExecutors(this))
+    {
+        addExecutor(executor);
+    }
+
+    m_linkCache.snapshot();
+    addExecutor(m_linkCache.createExecutor(this));
 }
 
-bool PortMgr::setPortMtu(const string &alias, const string &mtu)
+bool PortMgr::setPortAttributes(const string &alias, const string &mtu, const string &admin_status)
 {
-    stringstream cmd;
-    string res;
-
-    // ip link set dev <port_name> mtu <mtu>
-    cmd << IP_CMD << " link set dev " << alias << " mtu " << mtu;
-    EXEC_WITH_ERROR_THROW(cmd.str(), res);
+    SWSS_LOG_ENTER();
 
-    // Set the port MTU in application database to update both
-    // the port MTU and possibly the port based router interface MTU
     vector<FieldValueTuple> fvs;
-    FieldValueTuple fv("mtu", mtu);
-    fvs.push_back(fv);
-    m_appPortTable.set(alias, fvs);
+    unsigned int mtuValue = 0;
+    bool up = admin_status == "up";
+
+    if (!mtu.empty())
+    {
+        try
+        {
+            mtuValue = static_cast<unsigned int>(stoul(mtu));
+        }
+        catch (const std::exception &)
+        {
+            SWSS_LOG_ERROR("Invalid MTU %s for port %s", mtu.c_str(), alias.c_str());
+            return false;
+        }
+        fvs.emplace_back("mtu", mtu);
+    }
+
+    if (!admin_status.empty())
+    {
+        fvs.emplace_back("admin_status", up ? "up" : "down");
+    }
+
+    /* Skip the changes matching the kernel state */
+    const LinkInfo *link = m_linkCache.getLink(alias);
+    bool setMtu = !mtu.empty() && (!link || link->mtu != mtuValue);
+    bool setAdminStatus = !admin_status.empty() && (!link || ((link->flags & IFF_UP) != 0) != up);
+
+    /*
+     * Set the port MTU and admin status in application database to update
+     * both the port and possibly the port based router interface, once the
+     * kernel is updated
+     */
+    if (!setMtu && !setAdminStatus)
+    {
+        SWSS_LOG_INFO("Port %s kernel state is up to date", alias.c_str());
+        m_appPortTable.set(alias, fvs);
+        return true;
+    }
+
+    // ip link set dev <port_name> [mtu <mtu>] [up|down]
+    struct nl_msg *msg = buildLinkMsg(RTM_SETLINK, 0, alias, up ? IFF_UP : 0, setAdminStatus ? IFF_UP : 0);
+    if (!msg || (setMtu && nla_put_u32(msg, IFLA_MTU, mtuValue) < 0))
+    {
+        SWSS_LOG_ERROR("Failed to build the configuration of port %s", alias.c_str());
+        nlmsg_free(msg);
+        return false;
+    }
+
+    /* The state is known again once the change is notified */
+    m_linkCache.invalidate(alias);
+
+    m_nlBatch.add(msg, alias, [this, alias, fvs, up, setMtu, setAdminStatus](int error) {
+        if (error)
+        {
+            SWSS_LOG_ERROR("Failed to configure port %s, error '%s'", alias.c_str(), strerror(-error));
+
+            /* The whole request is rejected when the MTU is, still apply the admin status */
+            if (setMtu && setAdminStatus)
+            {
+                setPortAdminStatus(alias, up);
+            }
+            return;
+        }
+
+        m_appPortTable.set(alias, fvs);
+    });
 
     return true;
 }
 
-bool PortMgr::setPortAdminStatus(const string &alias, const bool up)
+/* Queue the admin status change of the port alone */
+void PortMgr::setPortAdminStatus(const string &alias, bool up)
 {
-    stringstream cmd;
-    string res;
+    SWSS_LOG_ENTER();
 
     // ip link set dev <port_name> [up|down]
-    cmd << IP_CMD << " link set dev " << alias << (up ? " up" : " down");
-    EXEC_WITH_ERROR_THROW(cmd.str(), res);
+    struct nl_msg *msg = buildLinkMsg(RTM_SETLINK, 0, alias, up ? IFF_UP : 0, IFF_UP);
+    if (!msg)
+    {
+        SWSS_LOG_ERROR("Failed to build the admin status of port %s", alias.c_str());
+        return;
+    }
 
-    vector<FieldValueTuple> fvs;
-    FieldValueTuple fv("admin_status", (up ? "up" : "down"));
-    fvs.push_back(fv);
-    m_appPortTable.set(alias, fvs);
+    m_nlBatch.add(msg, alias, [this, alias, up](int error) {
+        if (error)
+        {
+            SWSS_LOG_ERROR("Failed to set port %s admin status, error '%s'", alias.c_str(), strerror(-error));
+            return;
+        }
 
-    return true;
+        vector<FieldValueTuple> fvs;
+        fvs.emplace_back("admin_status", up ? "up" : "down");
+        m_appPortTable.set(alias, fvs);
+    });
 }
 
 bool PortMgr::isPortStateOk(const string &alias)
 {
-    vector<FieldValueTuple> temp;
-
-    if (m_statePortTable.get(alias, temp))
+    if (m_stateCache.isReady(STATE_PORT_TABLE_NAME, alias))
     {
         SWSS_LOG_INFO("Port %s is ready", alias.c_str());
         return true;
@@ -118,19 +191,23 @@ void PortMgr::doTask(Consumer &consumer)
                 }
             }
 
-            if (!mtu.empty())
+            if (setPortAttributes(alias, mtu, admin_status))
             {
-                setPortMtu(alias, mtu);
-                SWSS_LOG_NOTICE("Configure %s MTU to %s", alias.c_str(), mtu.c_str());
-            }
+                if (!mtu.empty())
+                {
+                    SWSS_LOG_NOTICE("Configure %s MTU to %s", alias.c_str(), mtu.c_str());
+                }
 
-            if (!admin_status.empty())
-            {
-                setPortAdminStatus(alias, admin_status == "up");
-                SWSS_LOG_NOTICE("Configure %s admin status to %s", alias.c_str(), admin_status.c_str());
+                if (!admin_status.empty())
+                {
+                    SWSS_LOG_NOTICE("Configure %s admin status to %s", alias.c_str(), admin_status.c_str());
+                }
             }
         }
 
         it = consumer.m_toSync.erase(it);
     }
+
+    /* Apply the changes of all ports of this pass at once */
+    m_nlBatch.sync();
 }
@@ -3,6 +3,9 @@
 #include "dbconnector.h"
 #include "orch.h"
 #include "producerstatetable.h"
+#include "readinesscache.h"
+#include "linkcache.h"
+#include "netlinkbatch.h"
 
 #include <map>
 #include <set>
@@ -23,14 +26,17 @@ public:
 private:
     Table m_cfgPortTable;
     Table m_cfgLagMemberTable;
-    Table m_statePortTable;
+    ReadinessCache m_stateCache;
     ProducerStateTable m_appPortTable;
+    LinkCache m_linkCache;
+    NetlinkBatch m_nlBatch;
 
     set<string> m_portList;
 
     void doTask(Consumer &consumer);
-    bool setPortMtu(const string &alias, const string &mtu);
-    bool setPortAdminStatus(const string &alias, const bool up);
+    /* Queue the kernel changes of the port, an empty value is left unchanged */
+    bool setPortAttributes(const string &alias, const string &mtu, const string &admin_status);
+    void setPortAdminStatus(const string &alias, bool up);
     bool isPortStateOk(const string &alias);
 };
 
@@ -0,0 +1,107 @@
+#include "logger.h"
+#include "readinesscache.h"
+
+using namespace std;
+using namespace swss;
+
+ReadinessCache::ReadinessCache(DBConnector *stateDb, const vector<string> &tableNames) :
+        m_stateDb(stateDb),
+        m_tableNames(tableNames)
+{
+    for (const auto &tableName : tableNames)
+    {
+        m_readyKeys[tableName];
+    }
+}
+
+vector<Executor *> ReadinessCache::createExecutors(Orch *orch)
+{
+    vector<Executor *> executors;
+
+    for (const auto &tableName : m_tableNames)
+    {
+        auto table = new SubscriberStateTable(m_stateDb, tableName);
+        auto executor = new ReadinessCacheExecutor(table, orch, this, tableName);
+        executor->prime();
+        executors.push_back(executor);
+    }
+
+    return executors;
+}
+
+bool ReadinessCache::isReady(const string &tableName, const string &key) const
+{
+    auto it = m_readyKeys.find(tableName);
+    if (it == m_readyKeys.end())
+    {
+        SWSS_LOG_ERROR("Table %s is not cached", tableName.c_str());
+        return false;
+    }
+
+    return it->second.find(key) != it->second.end();
+}
+
+void ReadinessCache::setReady(const string &tableName, const string &key, bool ready)
+{
+    if (ready)
+    {
+        m_readyKeys[tableName].insert(key);
+    }
+    else
+    {
+        m_readyKeys[tableName].erase(key);
+    }
+}
+
+bool ReadinessCache::update(const string &tableName, const deque<KeyOpFieldsValuesTuple> &entries)
+{
+    SWSS_LOG_ENTER();
+
+    auto &keys = m_readyKeys[tableName];
+    bool becameReady = false;
+
+    for (const auto &entry : entries)
+    {
+        const string &key = kfvKey(entry);
+
+        if (kfvOp(entry) == SET_COMMAND)
+        {
+            if (keys.insert(key).second)
+            {
+                SWSS_LOG_DEBUG("%s %s is ready", tableName.c_str(), key.c_str());
+                becameReady = true;
+            }
+        }
+        else
+        {
+            keys.erase(key);
+            SWSS_LOG_DEBUG("%s %s is not ready", tableName.c_str(), key.c_str());
+        }
+    }
+
+    return becameReady;
+}
+
+void ReadinessCacheExecutor::prime()
+{
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    getSubscriberStateTable()->pops(entries);
+
+    m_cache->update(m_tableName, entries);
+}
+
+void ReadinessCacheExecutor::execute()
+{
+    SWSS_LOG_ENTER();
+
+    ExecutorProfileScope profile(m_stats);
+
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    getSubscriberStateTable()->pops(entries);
+
+    /* Retry the pending tasks that may have been waiting for the object */
+    if (m_cache->update(m_tableName, entries))
+    {
+        m_orch->doTask();
+    }
+}
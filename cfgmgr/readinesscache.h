@@ -0,0 +1,70 @@
+#pragma once
+
+#include "dbconnector.h"
+#include "subscriberstatetable.h"
+#include "orch.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace swss {
+
+/*
+ * Cache of the objects present in STATE_DB tables, e.g. the ports, LAGs and
+ * VLANs ready in the kernel, so that cfgmgr daemons can check the readiness
+ * of an object without querying redis on every retry of a pending task.
+ *
+ * The cache is kept up to date by executors subscribing to the tables, which
+ * are added to the orch owning the cache. When an object becomes ready, the
+ * pending tasks of that orch are retried right away.
+ */
+class ReadinessCache
+{
+public:
+    ReadinessCache(DBConnector *stateDb, const std::vector<std::string> &tableNames);
+
+    /* Create the executors updating the cache, to be added to the orch */
+    std::vector<Executor *> createExecutors(Orch *orch);
+
+    bool isReady(const std::string &tableName, const std::string &key) const;
+
+    /* Record a change made to STATE_DB by the owning orch itself */
+    void setReady(const std::string &tableName, const std::string &key, bool ready);
+
+    /* Apply the changes popped from a table, return true if an object became ready */
+    bool update(const std::string &tableName, const std::deque<KeyOpFieldsValuesTuple> &entries);
+
+private:
+    DBConnector *m_stateDb;
+    std::vector<std::string> m_tableNames;
+    std::map<std::string, std::set<std::string>> m_readyKeys;
+};
+
+class ReadinessCacheExecutor : public Executor
+{
+public:
+    ReadinessCacheExecutor(SubscriberStateTable *table, Orch *orch, ReadinessCache *cache, const std::string &tableName)
+        : Executor(table, orch, "STATE_DB:" + tableName),
+          m_cache(cache),
+          m_tableName(tableName)
+    {
+    }
+
+    SubscriberStateTable *getSubscriberStateTable()
+    {
+        return static_cast<SubscriberStateTable *>(getSelectable());
+    }
+
+    /* Load the current content of the table, without retrying any task */
+    void prime();
+
+    void execute();
+
+private:
+    ReadinessCache *m_cache;
+    std::string m_tableName;
+};
+
+}
@@ -27,8 +27,8 @@ TeamMgr::TeamMgr(DBConnector *confDb, DBConnector *applDb, DBConnector *statDb,
     m_cfgLagMemberTable(confDb, CFG_LAG_MEMBER_TABLE_NAME),
     m_appPortTable(applDb, APP_PORT_TABLE_NAME),
     m_appLagTable(applDb, APP_LAG_TABLE_NAME),
-    m_statePortTable(statDb, STATE_PORT_TABLE_NAME),
-    m_stateLagTable(statDb, STATE_LAG_TABLE_NAME)
+    m_stateLagTable(statDb, STATE_LAG_TABLE_NAME),
+    m_stateCache(statDb, { STATE_PORT_TABLE_NAME, STATE_LAG_TABLE_NAME })
 {
     SWSS_LOG_ENTER();
 
@@ -41,6 +41,12 @@ TeamMgr::TeamMgr(DBConnector *confDb, DBConnector *applDb, DBConnector *statDb,
         m_stateLagTable.del(alias);
     }
 
+    // Subscribe to the port and LAG states once the stale entries are gone
+    for (auto executor : m_stateCache.createExecutors(this))
+    {
+        addExecutor(executor);
+    }
+
     // Get the MAC address from configuration database
     vector<FieldValueTuple> fvs;
     m_cfgMetadataTable.get("localhost", fvs);
@@ -60,9 +66,7 @@ bool TeamMgr::isPortStateOk(const string &alias)
 {
     SWSS_LOG_ENTER();
 
-    vector<FieldValueTuple> temp;
-
-    if (!m_statePortTable.get(alias, temp))
+    if (!m_stateCache.isReady(STATE_PORT_TABLE_NAME, alias))
     {
         SWSS_LOG_INFO("Port %s is not ready", alias.c_str());
         return false;
@@ -75,9 +79,7 @@ bool TeamMgr::isLagStateOk(const string &alias)
 {
     SWSS_LOG_ENTER();
 
-    vector<FieldValueTuple> temp;
-
-    if (!m_stateLagTable.get(alias, temp))
+    if (!m_stateCache.isReady(STATE_LAG_TABLE_NAME, alias))
     {
         SWSS_LOG_INFO("Lag %s is not ready", alias.c_str());
         return false;
@@ -7,6 +7,7 @@
 #include "netmsg.h"
 #include "orch.h"
 #include "producerstatetable.h"
+#include "readinesscache.h"
 
 namespace swss {
 
@@ -22,8 +23,8 @@ private:
     Table m_cfgPortTable;
     Table m_cfgLagTable;
     Table m_cfgLagMemberTable;
-    Table m_statePortTable;
     Table m_stateLagTable;
+    ReadinessCache m_stateCache;
 
     ProducerStateTable m_appPortTable;
     ProducerStateTable m_appLagTable;
@@ -24,15 +24,19 @@ VlanMgr::VlanMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb, c
         Orch(cfgDb, tableNames),
         m_cfgVlanTable(cfgDb, CFG_VLAN_TABLE_NAME),
         m_cfgVlanMemberTable(cfgDb, CFG_VLAN_MEMBER_TABLE_NAME),
-        m_statePortTable(stateDb, STATE_PORT_TABLE_NAME),
-        m_stateLagTable(stateDb, STATE_LAG_TABLE_NAME),
         m_stateVlanTable(stateDb, STATE_VLAN_TABLE_NAME),
         m_stateVlanMemberTable(stateDb, STATE_VLAN_MEMBER_TABLE_NAME),
+        m_stateCache(stateDb, { STATE_PORT_TABLE_NAME, STATE_LAG_TABLE_NAME, STATE_VLAN_TABLE_NAME, STATE_VLAN_MEMBER_TABLE_NAME }),
         m_appVlanTableProducer(appDb, APP_VLAN_TABLE_NAME),
         m_appVlanMemberTableProducer(appDb, APP_VLAN_MEMBER_TABLE_NAME)
 {
     SWSS_LOG_ENTER();
 
+    for (auto executor : m_stateCache.createExecutors(this))
+    {
+        addExecutor(executor);
+    }
+
     if (WarmStart::isWarmStart())
     {
         const std::string cmds = std::string("")
@@ -320,6 +324,7 @@ void VlanMgr::doVlanTask(Consumer &consumer)
             FieldValueTuple s("state", "ok");
             fvVector.push_back(s);
             m_stateVlanTable.set(key, fvVector);
+            m_stateCache.setReady(STATE_VLAN_TABLE_NAME, key, true);
 
             it = consumer.m_toSync.erase(it);
 
@@ -340,6 +345,7 @@ void VlanMgr::doVlanTask(Consumer &consumer)
                 m_vlans.erase(key);
                 m_appVlanTableProducer.del(key);
                 m_stateVlanTable.del(key);
+                m_stateCache.setReady(STATE_VLAN_TABLE_NAME, key, false);
             }
             else
             {
@@ -359,17 +365,15 @@ void VlanMgr::doVlanTask(Consumer &consumer)
 
 bool VlanMgr::isMemberStateOk(const string &alias)
 {
-    vector<FieldValueTuple> temp;
-
     if (!alias.compare(0, strlen(LAG_PREFIX), LAG_PREFIX))
     {
-        if (m_stateLagTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_LAG_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("%s is ready", alias.c_str());
             return true;
         }
     }
-    else if (m_statePortTable.get(alias, temp))
+    else if (m_stateCache.isReady(STATE_PORT_TABLE_NAME, alias))
     {
         SWSS_LOG_DEBUG("%s is ready", alias.c_str());
         return true;
@@ -380,11 +384,9 @@ bool VlanMgr::isMemberStateOk(const string &alias)
 
 bool VlanMgr::isVlanStateOk(const string &alias)
 {
-    vector<FieldValueTuple> temp;
-
     if (!alias.compare(0, strlen(VLAN_PREFIX), VLAN_PREFIX))
     {
-        if (m_stateVlanTable.get(alias, temp))
+        if (m_stateCache.isReady(STATE_VLAN_TABLE_NAME, alias))
         {
             SWSS_LOG_DEBUG("%s is ready", alias.c_str());
             return true;
@@ -396,9 +398,7 @@ bool VlanMgr::isVlanStateOk(const string &alias)
 
 bool VlanMgr::isVlanMemberStateOk(const string &vlanMemberKey)
 {
-    vector<FieldValueTuple> temp;
-
-    if (m_stateVlanMemberTable.get(vlanMemberKey, temp))
+    if (m_stateCache.isReady(STATE_VLAN_MEMBER_TABLE_NAME, vlanMemberKey))
     {
         SWSS_LOG_DEBUG("%s is ready", vlanMemberKey.c_str());
         return true;
@@ -537,6 +537,7 @@ void VlanMgr::doVlanMemberTask(Consumer &consumer)
                 FieldValueTuple s("state", "ok");
                 fvVector.push_back(s);
                 m_stateVlanMemberTable.set(kfvKey(t), fvVector);
+                m_stateCache.setReady(STATE_VLAN_MEMBER_TABLE_NAME, kfvKey(t), true);
             }
         }
         else if (op == DEL_COMMAND)
@@ -549,6 +550,7 @@ void VlanMgr::doVlanMemberTask(Consumer &consumer)
                 key += port_alias;
                 m_appVlanMemberTableProducer.del(key);
                 m_stateVlanMemberTable.del(kfvKey(t));
+                m_stateCache.setReady(STATE_VLAN_MEMBER_TABLE_NAME, kfvKey(t), false);
             }
             else
             {
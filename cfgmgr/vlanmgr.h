@@ -4,6 +4,7 @@
 #include "dbconnector.h"
 #include "producerstatetable.h"
 #include "orch.h"
+#include "readinesscache.h"
 
 #include <set>
 #include <map>
@@ -20,8 +21,8 @@ public:
 private:
     ProducerStateTable m_appVlanTableProducer, m_appVlanMemberTableProducer;
     Table m_cfgVlanTable, m_cfgVlanMemberTable;
-    Table m_statePortTable, m_stateLagTable;
     Table m_stateVlanTable, m_stateVlanMemberTable;
+    ReadinessCache m_stateCache;
     std::set<std::string> m_vlans;
 
     void doTask(Consumer &consumer);
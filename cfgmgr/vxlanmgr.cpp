@@ -1,13 +1,17 @@
 #include <algorithm>
+#include <arpa/inet.h>
+#include <string.h>
 #include <net/if.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+#include <netlink/attr.h>
 
 #include "logger.h"
 #include "producerstatetable.h"
 #include "macaddress.h"
+#include "ipaddress.h"
 #include "vxlanmgr.h"
-#include "exec.h"
 #include "tokenize.h"
-#include "shellcmd.h"
 #include "warm_restart.h"
 
 using namespace std;
@@ -34,114 +38,98 @@ static std::string getVxlanIfName(const swss::VxlanMgr::VxlanInfo & info)
     return std::string("") + VXLAN_IF_NAME_PREFIX + info.m_vni;
 }
 
-// Commands
+// Netlink requests
 
-#define RET_SUCCESS 0
-#define EXECUTE(CMD, RESULT) swss::exec(std::string() + BASH_CMD + " -c \"" + CMD + "\"", RESULT);
+#define VXLAN_DST_PORT 4789
 
-static int cmdCreateVxlan(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
+static struct nl_msg *buildCreateVxlanMsg(const swss::VxlanMgr::VxlanInfo & info)
 {
-    // ip link add {{VXLAN}} type vxlan id {{VNI}} [local {{SOURCE IP}}] dstport 4789
-    const std::string cmd = std::string("")
-         + IP_CMD " link add " 
-         + info.m_vxlan 
-         + " type vxlan id " 
-         + info.m_vni 
-         + " "
-         + (info.m_sourceIp.empty() ? "" : (" local " + info.m_sourceIp))
-         + " dstport 4789";
-    return EXECUTE(cmd, res);
-}
+    // ip link add {{VXLAN}} type vxlan id {{VNI}} [local {{SOURCE IP}}] dstport 4789 && ip link set dev {{VXLAN}} up
+    uint32_t vni = static_cast<uint32_t>(std::stoul(info.m_vni));
 
-static int cmdUpVxlan(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // ip link set dev {{VXLAN}} up
-    const std::string cmd = std::string("")
-        + IP_CMD " link set dev " 
-        + info.m_vxlan
-        + " up";
-    return EXECUTE(cmd, res);
-}
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL, info.m_vxlan, IFF_UP, IFF_UP);
+    if (!msg)
+    {
+        return nullptr;
+    }
 
-static int cmdCreateVxlanIf(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // ip link add {{VXLAN_IF}} type bridge
-    const std::string cmd = std::string("")
-        + IP_CMD " link add "
-        + info.m_vxlanIf
-        + " type bridge";
-    return EXECUTE(cmd, res);
-}
+    struct nlattr *linkInfo = nullptr;
+    struct nlattr *infoData = nullptr;
+    bool ok = (linkInfo = nla_nest_start(msg, IFLA_LINKINFO)) != nullptr
+           && nla_put_string(msg, IFLA_INFO_KIND, "vxlan") >= 0
+           && (infoData = nla_nest_start(msg, IFLA_INFO_DATA)) != nullptr
+           && nla_put_u32(msg, IFLA_VXLAN_ID, vni) >= 0
+           && nla_put_u16(msg, IFLA_VXLAN_PORT, htons(VXLAN_DST_PORT)) >= 0;
 
-static int cmdAddVxlanIntoVxlanIf(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // brctl addif {{VXLAN_IF}} {{VXLAN}}
-    const std::string cmd = std::string("")
-        + BRCTL_CMD " addif "
-        + info.m_vxlanIf
-        + " "
-        + info.m_vxlan;
-    return EXECUTE(cmd, res);
-}
+    if (ok && !info.m_sourceIp.empty())
+    {
+        IpAddress sourceIp(info.m_sourceIp);
+        auto ip = sourceIp.getIp();
+        if (sourceIp.isV4())
+        {
+            ok = nla_put(msg, IFLA_VXLAN_LOCAL, sizeof(ip.ip_addr.ipv4_addr), &ip.ip_addr.ipv4_addr) >= 0;
+        }
+        else
+        {
+            ok = nla_put(msg, IFLA_VXLAN_LOCAL6, sizeof(ip.ip_addr.ipv6_addr), &ip.ip_addr.ipv6_addr) >= 0;
+        }
+    }
 
-static int cmdAttachVxlanIfToVnet(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // ip link set dev {{VXLAN_IF}} master {{VNET}}
-    const std::string cmd = std::string("")
-        + IP_CMD " link set dev "
-        + info.m_vxlanIf
-        + " master "
-        + info.m_vnet;
-    return EXECUTE(cmd, res);
-}
+    if (!ok)
+    {
+        nlmsg_free(msg);
+        return nullptr;
+    }
 
-static int cmdUpVxlanIf(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // ip link set dev {{VXLAN_IF}} up
-    const std::string cmd = std::string("")
-        + IP_CMD " link set dev "
-        + info.m_vxlanIf
-        + " up";
-    return EXECUTE(cmd, res);
+    nla_nest_end(msg, infoData);
+    nla_nest_end(msg, linkInfo);
+    return msg;
 }
 
-static int cmdDeleteVxlan(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
+static struct nl_msg *buildCreateVxlanIfMsg(const swss::VxlanMgr::VxlanInfo & info, int vnetIfindex)
 {
-    // ip link del dev {{VXLAN}}
-    const std::string cmd = std::string("")
-        + IP_CMD " link del dev "
-        + info.m_vxlan;
-    return EXECUTE(cmd, res);
-}
+    // ip link add {{VXLAN_IF}} type bridge && ip link set dev {{VXLAN_IF}} master {{VNET}} up
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL, info.m_vxlanIf, IFF_UP, IFF_UP);
+    if (!msg)
+    {
+        return nullptr;
+    }
 
-static int cmdDeleteVxlanFromVxlanIf(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
-{
-    // brctl delif {{VXLAN_IF}} {{VXLAN}}
-    const std::string cmd = std::string("")
-        + BRCTL_CMD " delif "
-        + info.m_vxlanIf
-        + " "
-        + info.m_vxlan;
-    return EXECUTE(cmd, res);
+    struct nlattr *linkInfo = nullptr;
+    if (nla_put_u32(msg, IFLA_MASTER, static_cast<uint32_t>(vnetIfindex)) < 0
+     || (linkInfo = nla_nest_start(msg, IFLA_LINKINFO)) == nullptr
+     || nla_put_string(msg, IFLA_INFO_KIND, "bridge") < 0)
+    {
+        nlmsg_free(msg);
+        return nullptr;
+    }
+
+    nla_nest_end(msg, linkInfo);
+    return msg;
 }
 
-static int cmdDeleteVxlanIf(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
+static struct nl_msg *buildSetMasterMsg(const std::string & name, int masterIfindex)
 {
-    // ip link del {{VXLAN_IF}}
-    const std::string cmd = std::string("")
-        + IP_CMD " link del "
-        + info.m_vxlanIf;
-    return EXECUTE(cmd, res);
+    // brctl addif {{MASTER}} {{NAME}}
+    struct nl_msg *msg = buildLinkMsg(RTM_SETLINK, 0, name);
+    if (!msg)
+    {
+        return nullptr;
+    }
+
+    if (nla_put_u32(msg, IFLA_MASTER, static_cast<uint32_t>(masterIfindex)) < 0)
+    {
+        nlmsg_free(msg);
+        return nullptr;
+    }
+
+    return msg;
 }
 
-static int cmdDetachVxlanIfFromVnet(const swss::VxlanMgr::VxlanInfo & info, std::string & res)
+static struct nl_msg *buildDeleteLinkMsg(const std::string & name)
 {
-    // ip link set dev {{VXLAN_IF}} nomaster
-    const std::string cmd = std::string("")
-        + IP_CMD " link set dev "
-        + info.m_vxlanIf
-        + " nomaster";
-    return EXECUTE(cmd, res);
+    // ip link del dev {{NAME}}
+    return buildLinkMsg(RTM_DELLINK, 0, name);
 }
 
 // Vxlanmgr
@@ -155,6 +143,44 @@ VxlanMgr::VxlanMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb,
         m_stateVrfTable(stateDb, STATE_VRF_TABLE_NAME),
         m_stateVxlanTable(stateDb, STATE_VXLAN_TABLE_NAME)
 {
+    SWSS_LOG_ENTER();
+
+    // Reconcile with the devices left in the kernel by a previous instance
+    m_linkCache.snapshot();
+    for (const auto & link : m_linkCache.getLinks())
+    {
+        const std::string & name = link.first;
+        if ((link.second.type == "vxlan" && name.compare(0, strlen(VXLAN_NAME_PREFIX), VXLAN_NAME_PREFIX) == 0)
+         || (link.second.type == "bridge" && name.compare(0, strlen(VXLAN_IF_NAME_PREFIX), VXLAN_IF_NAME_PREFIX) == 0))
+        {
+            m_staleLinks.insert(name);
+        }
+    }
+
+    if (!m_staleLinks.empty())
+    {
+        SWSS_LOG_NOTICE("Found %zu vxlan devices left in the kernel", m_staleLinks.size());
+    }
+
+    addExecutor(m_linkCache.createExecutor(this));
+}
+
+void VxlanMgr::doTask()
+{
+    SWSS_LOG_ENTER();
+
+    Orch::doTask();
+
+    if (m_staleLinks.empty())
+    {
+        return;
+    }
+
+    auto consumer = dynamic_cast<Consumer *>(getExecutor(CFG_VNET_TABLE_NAME));
+    if (consumer && consumer->m_toSync.empty())
+    {
+        removeStaleLinks();
+    }
 }
 
 void VxlanMgr::doTask(Consumer &consumer)
@@ -221,6 +247,10 @@ void VxlanMgr::doTask(Consumer &consumer)
             ++it;
         }
     }
+
+    // Program the kernel devices of this pass in batch
+    createVxlans();
+    m_nlBatch.sync();
 }
 
 bool VxlanMgr::doVxlanCreateTask(const KeyOpFieldsValuesTuple & t)
@@ -292,14 +322,7 @@ bool VxlanMgr::doVxlanCreateTask(const KeyOpFieldsValuesTuple & t)
         doVxlanDeleteTask(t);
     }
 
-    if (!createVxlan(info))
-    {
-        SWSS_LOG_ERROR("Cannot create vxlan %s", info.m_vxlan.c_str());
-        return true;
-    }
-
-    m_vnetCache[info.m_vnet] = info;
-    SWSS_LOG_INFO("Create vxlan %s", info.m_vxlan.c_str());
+    createVxlan(info);
 
     return true;
 }
@@ -309,6 +332,18 @@ bool VxlanMgr::doVxlanDeleteTask(const KeyOpFieldsValuesTuple & t)
     SWSS_LOG_ENTER();
 
     const std::string & vnetName = kfvKey(t);
+
+    // The vxlan may be still waiting to be created in this pass
+    auto pending = std::find_if(
+        m_pendingVxlans.begin(),
+        m_pendingVxlans.end(),
+        [&](const VxlanInfo & info){ return info.m_vnet == vnetName; });
+    if (pending != m_pendingVxlans.end())
+    {
+        m_pendingVxlans.erase(pending);
+        return true;
+    }
+
     auto it = m_vnetCache.find(vnetName);
     if (it == m_vnetCache.end())
     {
@@ -420,111 +455,207 @@ bool VxlanMgr::isVxlanStateOk(const std::string & vxlanName)
     return false;
 }
 
-bool VxlanMgr::createVxlan(const VxlanInfo & info)
+void VxlanMgr::createVxlan(const VxlanInfo & info)
+{
+    SWSS_LOG_ENTER();
+
+    m_pendingVxlans.push_back(info);
+}
+
+void VxlanMgr::createVxlans()
 {
     SWSS_LOG_ENTER();
-    
-    std::string res;
-    int ret = 0;
-
-    // Create Vxlan
-    ret = cmdCreateVxlan(info, res);
-    if (ret != RET_SUCCESS)
-    {
-        SWSS_LOG_WARN(
-            "Failed to create vxlan %s (vni: %s, source ip %s)",
-            info.m_vxlan.c_str(),
-            info.m_vni.c_str(),
-            info.m_sourceIp.c_str());
-        return false;
-    }
 
-    // Up Vxlan
-    ret = cmdUpVxlan(info, res);
-    if (ret != RET_SUCCESS)
+    if (m_pendingVxlans.empty())
     {
-        cmdDeleteVxlan(info, res);
-        SWSS_LOG_WARN(
-            "Fail to up vxlan %s",
-            info.m_vxlan.c_str());
-        return false;
+        return;
     }
 
-    // Create Vxlan Interface
-    ret = cmdCreateVxlanIf(info, res);
-    if (ret != RET_SUCCESS)
+    std::vector<VxlanInfo> vxlans;
+    vxlans.swap(m_pendingVxlans);
+
+    // First error met while creating each vxlan
+    std::vector<int> errors(vxlans.size(), 0);
+    auto recordError = [&errors](size_t i)
     {
-        cmdDeleteVxlan(info, res);
-        SWSS_LOG_WARN(
-            "Fail to create vxlan interface %s",
-            info.m_vxlanIf.c_str());
-        return false;
-    }
+        return [&errors, i](int error)
+        {
+            if (error && !errors[i])
+            {
+                errors[i] = error;
+            }
+        };
+    };
 
-    // Add vxlan into vxlan interface
-    ret = cmdAddVxlanIntoVxlanIf(info, res);
-    if ( ret != RET_SUCCESS )
+    // Devices created for each vxlan, the only ones removed if it fails, so
+    // that devices of the same name owned by another vnet are left alone
+    std::vector<std::vector<std::string>> created(vxlans.size());
+    auto recordCreate = [&errors, &created](size_t i, const std::string & name)
     {
-        cmdDeleteVxlanIf(info, res);
-        cmdDeleteVxlan(info, res);
-        SWSS_LOG_WARN(
-            "Fail to add %s into %s",
-            info.m_vxlan.c_str(),
-            info.m_vxlanIf.c_str());
-        return false;
-    }
+        return [&errors, &created, i, name](int error)
+        {
+            if (error)
+            {
+                if (!errors[i])
+                {
+                    errors[i] = error;
+                }
+                return;
+            }
 
-    // Attach vxlan interface to vnet
-    ret = cmdAttachVxlanIfToVnet(info, res);
-    if ( ret != RET_SUCCESS )
-    {
-        cmdDeleteVxlanFromVxlanIf(info, res);
-        cmdDeleteVxlanIf(info, res);
-        cmdDeleteVxlan(info, res);
-        SWSS_LOG_WARN(
-            "Fail to set %s master %s",
-            info.m_vxlanIf.c_str(),
-            info.m_vnet.c_str());
-        return false;
-       
+            created[i].push_back(name);
+        };
+    };
+
+    // Create the bridges attached to their vnet and the vxlan devices, all up
+    for (size_t i = 0; i < vxlans.size(); i++)
+    {
+        const VxlanInfo & info = vxlans[i];
+
+        for (const auto & name : { info.m_vxlanIf, info.m_vxlan })
+        {
+            if (m_staleLinks.erase(name))
+            {
+                SWSS_LOG_INFO("Replace device %s left in the kernel", name.c_str());
+                deleteLink(name);
+            }
+        }
+
+        int vnetIfindex = m_linkCache.getIfIndex(info.m_vnet);
+        if (!vnetIfindex)
+        {
+            errors[i] = -ENODEV;
+            continue;
+        }
+
+        struct nl_msg *vxlanIfMsg = buildCreateVxlanIfMsg(info, vnetIfindex);
+        struct nl_msg *vxlanMsg = nullptr;
+        try
+        {
+            vxlanMsg = buildCreateVxlanMsg(info);
+        }
+        catch (const std::exception & e)
+        {
+            SWSS_LOG_ERROR("Invalid vxlan %s (vni: %s, source ip %s): %s",
+                info.m_vxlan.c_str(), info.m_vni.c_str(), info.m_sourceIp.c_str(), e.what());
+        }
+
+        if (!vxlanIfMsg || !vxlanMsg)
+        {
+            nlmsg_free(vxlanIfMsg);
+            nlmsg_free(vxlanMsg);
+            errors[i] = -EINVAL;
+            continue;
+        }
+
+        m_nlBatch.add(vxlanIfMsg, info.m_vxlanIf, recordCreate(i, info.m_vxlanIf));
+        m_nlBatch.add(vxlanMsg, info.m_vxlan, recordCreate(i, info.m_vxlan));
     }
 
-    // Up Vxlan Interface
-    ret = cmdUpVxlanIf(info, res);
-    if ( ret != RET_SUCCESS )
-    {
-        cmdDetachVxlanIfFromVnet(info, res);
-        cmdDeleteVxlanFromVxlanIf(info, res);
-        cmdDeleteVxlanIf(info, res);
-        cmdDeleteVxlan(info, res);
-        SWSS_LOG_WARN(
-            "Fail to up bridge %s",
-            info.m_vxlanIf.c_str());
-        return false;
+    m_nlBatch.sync();
+
+    // Add each vxlan device into its bridge, now that the bridges exist
+    for (size_t i = 0; i < vxlans.size(); i++)
+    {
+        if (errors[i])
+        {
+            continue;
+        }
+
+        const VxlanInfo & info = vxlans[i];
+        int vxlanIfIndex = m_linkCache.getIfIndex(info.m_vxlanIf);
+        struct nl_msg *msg = vxlanIfIndex ? buildSetMasterMsg(info.m_vxlan, vxlanIfIndex) : nullptr;
+        if (!msg)
+        {
+            errors[i] = -ENODEV;
+            continue;
+        }
+
+        m_nlBatch.add(msg, info.m_vxlan, recordError(i));
     }
 
+    m_nlBatch.sync();
+
     std::vector<FieldValueTuple> fvVector;
     fvVector.emplace_back("state", "ok");
-    m_stateVxlanTable.set(info.m_vxlan, fvVector);
 
-    return true;
+    for (size_t i = 0; i < vxlans.size(); i++)
+    {
+        const VxlanInfo & info = vxlans[i];
+
+        if (errors[i])
+        {
+            SWSS_LOG_WARN(
+                "Failed to create vxlan %s (vni: %s, source ip %s) in %s, error '%s'",
+                info.m_vxlan.c_str(),
+                info.m_vni.c_str(),
+                info.m_sourceIp.c_str(),
+                info.m_vnet.c_str(),
+                strerror(-errors[i]));
+            SWSS_LOG_ERROR("Cannot create vxlan %s", info.m_vxlan.c_str());
+
+            for (const auto & name : created[i])
+            {
+                deleteLink(name);
+            }
+            continue;
+        }
+
+        m_stateVxlanTable.set(info.m_vxlan, fvVector);
+        m_vnetCache[info.m_vnet] = info;
+        SWSS_LOG_INFO("Create vxlan %s", info.m_vxlan.c_str());
+    }
 }
 
 bool VxlanMgr::deleteVxlan(const VxlanInfo & info)
 {
     SWSS_LOG_ENTER();
 
-    std::string res;
-
-    cmdDetachVxlanIfFromVnet(info, res);
-    cmdDeleteVxlanFromVxlanIf(info, res);
-    cmdDeleteVxlanIf(info, res);
-    cmdDeleteVxlan(info, res);
+    // Removing the bridge also removes the vxlan device from it and detaches it from the vnet
+    deleteLink(info.m_vxlanIf);
+    deleteLink(info.m_vxlan);
 
     m_stateVxlanTable.del(info.m_vxlan);
 
     return true;
 }
 
+void VxlanMgr::deleteLink(const std::string & name)
+{
+    SWSS_LOG_ENTER();
+
+    struct nl_msg *msg = buildDeleteLinkMsg(name);
+    if (!msg)
+    {
+        SWSS_LOG_ERROR("Cannot build the removal of %s", name.c_str());
+        return;
+    }
+
+    m_linkCache.invalidate(name);
+    m_nlBatch.add(msg, name, [name](int error)
+    {
+        if (error && error != -ENODEV)
+        {
+            SWSS_LOG_WARN("Failed to delete %s, error '%s'", name.c_str(), strerror(-error));
+        }
+    });
+}
+
+void VxlanMgr::removeStaleLinks()
+{
+    SWSS_LOG_ENTER();
 
+    SWSS_LOG_NOTICE("Remove %zu vxlan devices left in the kernel", m_staleLinks.size());
 
+    for (const auto & name : m_staleLinks)
+    {
+        deleteLink(name);
+        if (name.compare(0, strlen(VXLAN_NAME_PREFIX), VXLAN_NAME_PREFIX) == 0)
+        {
+            m_stateVxlanTable.del(name);
+        }
+    }
+
+    m_staleLinks.clear();
+    m_nlBatch.sync();
+}
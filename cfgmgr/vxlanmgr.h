@@ -4,10 +4,14 @@
 #include "dbconnector.h"
 #include "producerstatetable.h"
 #include "orch.h"
+#include "linkcache.h"
+#include "netlinkbatch.h"
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace swss {
 
@@ -17,6 +21,9 @@ public:
     VxlanMgr(DBConnector *cfgDb, DBConnector *appDb, DBConnector *stateDb, const vector<std::string> &tableNames);
     using Orch::doTask;
 
+    /* Drain the consumers, then remove the stale devices once all vnets are processed */
+    void doTask() override;
+
     typedef struct VxlanInfo
     {
         std::string m_vxlanTunnel;
@@ -48,9 +55,13 @@ private:
     bool isVrfStateOk(const std::string & vrfName);
     bool isVxlanStateOk(const std::string & vxlanName);
 
-    bool createVxlan(const VxlanInfo & info);
+    /* Queue the creation of a vxlan, done in batch by createVxlans() */
+    void createVxlan(const VxlanInfo & info);
+    void createVxlans();
     bool deleteVxlan(const VxlanInfo & info);
 
+    void deleteLink(const std::string & name);
+    void removeStaleLinks();
 
     ProducerStateTable m_appVxlanTunnelTable,m_appVxlanTunnelMapTable;
     Table m_cfgVxlanTunnelTable,m_cfgVnetTable,m_stateVrfTable,m_stateVxlanTable;
@@ -67,6 +78,18 @@ private:
     * Value: Vxlan information of this vnet
     */
     std::map<std::string, VxlanInfo> m_vnetCache;
+
+    /* Vxlans waiting to be created at the end of the doTask pass */
+    std::vector<VxlanInfo> m_pendingVxlans;
+
+    LinkCache m_linkCache;
+    NetlinkBatch m_nlBatch;
+    /*
+    * Vxlan and bridge devices found in the kernel at startup, left by a
+    * previous instance. They are replaced when their vnet is created again
+    * and removed once all vnets have been processed.
+    */
+    std::set<std::string> m_staleLinks;
 };
 
 }
@@ -0,0 +1,571 @@
+/*
+ * Synthetic FPM traffic generator, to measure fpmsyncd without a routing
+ * stack. It connects to the FPM port in place of zebra, streams route add and
+ * delete netlink messages and waits for their effect on the route table of
+ * APPL_DB, read from the local redis-server.
+ * Results are printed as one JSON object per line.
+ */
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <errno.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dbconnector.h"
+#include "schema.h"
+#include "table.h"
+#include "fpm/fpm.h"
+
+using namespace std;
+using namespace swss;
+
+#define FPMGEN_SEND_BUF_SIZE    (64 * 1024)
+#define FPMGEN_POLL_INTERVAL    100     // usecs
+#define FPMGEN_MAX_ECMP         254
+
+struct Options
+{
+    unsigned short  port = FPM_DEFAULT_PORT;
+    uint32_t        prefixes = 10000;
+    uint32_t        ecmp = 1;
+    uint32_t        v6_percent = 0;
+    string          churn = "none";
+    uint32_t        rounds = 1;
+    uint32_t        samples = 100;
+    int             ifindex = 1;
+    uint32_t        timeout = 120;      // secs
+    bool            keep = false;
+};
+
+static Options options;
+
+static void usage()
+{
+    cout << "Usage: fpmgen [options]" << endl
+         << "Stream synthetic routes to fpmsyncd and measure how fast they reach APPL_DB." << endl
+         << "fpmsyncd must be running, with no routing stack connected to it." << endl
+         << endl
+         << "  -p <port>      FPM port (default " << FPM_DEFAULT_PORT << ")" << endl
+         << "  -n <count>     number of prefixes (default 10000)" << endl
+         << "  -e <width>     next hops per route, up to " << FPMGEN_MAX_ECMP << " (default 1)" << endl
+         << "  -6 <percent>   share of IPv6 prefixes (default 0)" << endl
+         << "  -c <churn>     none, flap (delete and add again) or update (new next hops)" << endl
+         << "  -r <rounds>    churn rounds (default 1)" << endl
+         << "  -s <samples>   single route latency samples (default 100)" << endl
+         << "  -i <ifindex>   next hop interface index (default 1)" << endl
+         << "  -t <secs>      timeout waiting for APPL_DB (default 120)" << endl
+         << "  -k             keep the routes in APPL_DB when done, e.g. for a warm restart" << endl;
+}
+
+/* Synthetic routes */
+
+struct Route
+{
+    int         family;
+    uint8_t     dst[16];
+    uint8_t     dst_len;
+    string      key;            // APPL_DB key written by fpmsyncd
+};
+
+static Route makeRoute(uint32_t index, bool probe)
+{
+    Route route;
+    memset(route.dst, 0, sizeof(route.dst));
+
+    bool v6 = !probe && index % 100 < options.v6_percent;
+    char addr[INET6_ADDRSTRLEN];
+
+    if (!v6)
+    {
+        /* 10.0.0.0/24 onwards, probes in 100.64.0.0/10 */
+        uint32_t ip = htonl((probe ? 0x64400000 : 0x0a000000) + (index << 8));
+        memcpy(route.dst, &ip, sizeof(ip));
+        route.family = AF_INET;
+        route.dst_len = 24;
+    }
+    else
+    {
+        /* 2001:db8:<index>::/64 */
+        route.dst[0] = 0x20;
+        route.dst[1] = 0x01;
+        route.dst[2] = 0x0d;
+        route.dst[3] = 0xb8;
+        route.dst[4] = static_cast<uint8_t>(index >> 24);
+        route.dst[5] = static_cast<uint8_t>(index >> 16);
+        route.dst[6] = static_cast<uint8_t>(index >> 8);
+        route.dst[7] = static_cast<uint8_t>(index);
+        route.family = AF_INET6;
+        route.dst_len = 64;
+    }
+
+    inet_ntop(route.family, route.dst, addr, sizeof(addr));
+    route.key = string(addr) + "/" + to_string(route.dst_len);
+    return route;
+}
+
+/* Next hop n of a route, shifted by the churn round */
+static string nextHop(int family, uint32_t n, uint32_t round, uint8_t *addr)
+{
+    uint8_t host = static_cast<uint8_t>((n + round) % FPMGEN_MAX_ECMP + 1);
+    char str[INET6_ADDRSTRLEN];
+
+    memset(addr, 0, 16);
+    if (family == AF_INET)
+    {
+        /* 192.0.2.<host> */
+        addr[0] = 192;
+        addr[2] = 2;
+        addr[3] = host;
+    }
+    else
+    {
+        /* fc00::<host> */
+        addr[0] = 0xfc;
+        addr[15] = host;
+    }
+
+    inet_ntop(family, addr, str, sizeof(str));
+    return str;
+}
+
+/* Next hops field written by fpmsyncd for the route */
+static string nextHops(const Route &route, uint32_t round)
+{
+    string result;
+    uint8_t addr[16];
+
+    for (uint32_t n = 0; n < options.ecmp; n++)
+    {
+        if (n)
+        {
+            result += ",";
+        }
+        result += nextHop(route.family, n, round, addr);
+    }
+
+    return result;
+}
+
+/* FPM messages */
+
+class MessageBuilder
+{
+public:
+    explicit MessageBuilder(vector<uint8_t> &buf) : m_buf(buf), m_start(buf.size())
+    {
+        m_buf.resize(m_start + FPM_MSG_HDR_LEN + NLMSG_HDRLEN);
+    }
+
+    void append(const void *data, size_t len)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        m_buf.insert(m_buf.end(), bytes, bytes + len);
+    }
+
+    void align()
+    {
+        m_buf.resize(m_start + FPM_MSG_HDR_LEN + NLMSG_ALIGN(m_buf.size() - m_start - FPM_MSG_HDR_LEN));
+    }
+
+    /* Start an attribute, return its offset to end it */
+    size_t beginAttr(unsigned short type)
+    {
+        align();
+
+        size_t offset = m_buf.size();
+        struct rtattr rta;
+        rta.rta_type = type;
+        rta.rta_len = 0;
+        append(&rta, sizeof(rta));
+        return offset;
+    }
+
+    void endAttr(size_t offset)
+    {
+        struct rtattr *rta = reinterpret_cast<struct rtattr *>(&m_buf[offset]);
+        rta->rta_len = static_cast<unsigned short>(m_buf.size() - offset);
+    }
+
+    void addAttr(unsigned short type, const void *data, size_t len)
+    {
+        size_t offset = beginAttr(type);
+        append(data, len);
+        endAttr(offset);
+    }
+
+    size_t offset() const
+    {
+        return m_buf.size();
+    }
+
+    uint8_t *at(size_t offset)
+    {
+        return &m_buf[offset];
+    }
+
+    /* Fill the netlink and FPM headers */
+    void finish(uint16_t type, uint32_t seq)
+    {
+        align();
+
+        size_t nl_len = m_buf.size() - m_start - FPM_MSG_HDR_LEN;
+        size_t fpm_len = fpm_data_len_to_msg_len(nl_len);
+        if (fpm_len > FPM_MAX_MSG_LEN)
+        {
+            throw runtime_error("FPM message too long, reduce the ECMP width");
+        }
+        m_buf.resize(m_start + fpm_len);
+
+        fpm_msg_hdr_t *fpm = reinterpret_cast<fpm_msg_hdr_t *>(&m_buf[m_start]);
+        fpm->version = FPM_PROTO_VERSION;
+        fpm->msg_type = FPM_MSG_TYPE_NETLINK;
+        fpm->msg_len = htons(static_cast<uint16_t>(fpm_len));
+
+        struct nlmsghdr *nlh = reinterpret_cast<struct nlmsghdr *>(&m_buf[m_start + FPM_MSG_HDR_LEN]);
+        nlh->nlmsg_len = static_cast<uint32_t>(nl_len);
+        nlh->nlmsg_type = type;
+        nlh->nlmsg_flags = static_cast<uint16_t>(NLM_F_REQUEST | (type == RTM_NEWROUTE ? NLM_F_CREATE | NLM_F_REPLACE : 0));
+        nlh->nlmsg_seq = seq;
+        nlh->nlmsg_pid = 0;
+    }
+
+private:
+    vector<uint8_t> &m_buf;
+    size_t m_start;
+};
+
+static void buildRouteMsg(vector<uint8_t> &buf, const Route &route, bool add, uint32_t round, uint32_t seq)
+{
+    MessageBuilder msg(buf);
+
+    struct rtmsg rtm;
+    memset(&rtm, 0, sizeof(rtm));
+    rtm.rtm_family = static_cast<unsigned char>(route.family);
+    rtm.rtm_dst_len = route.dst_len;
+    rtm.rtm_table = RT_TABLE_MAIN;
+    rtm.rtm_protocol = RTPROT_ZEBRA;
+    rtm.rtm_scope = RT_SCOPE_UNIVERSE;
+    rtm.rtm_type = RTN_UNICAST;
+    msg.append(&rtm, sizeof(rtm));
+
+    size_t addr_len = route.family == AF_INET ? 4 : 16;
+    msg.addAttr(RTA_DST, route.dst, addr_len);
+
+    if (add)
+    {
+        uint8_t gw[16];
+
+        if (options.ecmp == 1)
+        {
+            nextHop(route.family, 0, round, gw);
+            msg.addAttr(RTA_GATEWAY, gw, addr_len);
+            msg.addAttr(RTA_OIF, &options.ifindex, sizeof(options.ifindex));
+        }
+        else
+        {
+            size_t multipath = msg.beginAttr(RTA_MULTIPATH);
+            for (uint32_t n = 0; n < options.ecmp; n++)
+            {
+                msg.align();
+
+                size_t offset = msg.offset();
+                struct rtnexthop rtnh;
+                memset(&rtnh, 0, sizeof(rtnh));
+                rtnh.rtnh_ifindex = options.ifindex;
+                msg.append(&rtnh, sizeof(rtnh));
+
+                nextHop(route.family, n, round, gw);
+                msg.addAttr(RTA_GATEWAY, gw, addr_len);
+
+                struct rtnexthop *nh = reinterpret_cast<struct rtnexthop *>(msg.at(offset));
+                nh->rtnh_len = static_cast<unsigned short>(msg.offset() - offset);
+            }
+            msg.endAttr(multipath);
+        }
+    }
+
+    msg.finish(add ? RTM_NEWROUTE : RTM_DELROUTE, seq);
+}
+
+/* FPM connection, playing the part of zebra */
+
+class FpmClient
+{
+public:
+    FpmClient(unsigned short port) : m_seq(0)
+    {
+        m_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_fd < 0)
+        {
+            throw runtime_error(string("socket: ") + strerror(errno));
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (connect(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+        {
+            close(m_fd);
+            throw runtime_error(string("connect to fpmsyncd: ") + strerror(errno));
+        }
+    }
+
+    ~FpmClient()
+    {
+        close(m_fd);
+    }
+
+    void send(const Route &route, bool add, uint32_t round)
+    {
+        buildRouteMsg(m_buf, route, add, round, ++m_seq);
+        if (m_buf.size() >= FPMGEN_SEND_BUF_SIZE)
+        {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        size_t sent = 0;
+        while (sent < m_buf.size())
+        {
+            ssize_t rc = write(m_fd, m_buf.data() + sent, m_buf.size() - sent);
+            if (rc < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw runtime_error(string("write to fpmsyncd: ") + strerror(errno));
+            }
+            sent += static_cast<size_t>(rc);
+        }
+        m_buf.clear();
+    }
+
+private:
+    int m_fd;
+    uint32_t m_seq;
+    vector<uint8_t> m_buf;
+};
+
+/* APPL_DB checks */
+
+/* Wait for the route to be in APPL_DB with the next hops of the round, or to be gone */
+static void waitRoute(Table &table, const Route &route, bool present, uint32_t round)
+{
+    string expected = present ? nextHops(route, round) : "";
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(options.timeout);
+
+    while (true)
+    {
+        vector<FieldValueTuple> fvs;
+        bool found = table.get(route.key, fvs);
+
+        if (!present && !found)
+        {
+            return;
+        }
+
+        if (present && found)
+        {
+            for (const auto &fv : fvs)
+            {
+                if (fvField(fv) == "nexthop" && fvValue(fv) == expected)
+                {
+                    return;
+                }
+            }
+        }
+
+        if (chrono::steady_clock::now() > deadline)
+        {
+            throw runtime_error("Timeout waiting for route " + route.key + " in APPL_DB");
+        }
+
+        this_thread::sleep_for(chrono::microseconds(FPMGEN_POLL_INTERVAL));
+    }
+}
+
+static void report(const string &phase, size_t routes, chrono::nanoseconds elapsed)
+{
+    double secs = static_cast<double>(elapsed.count()) / 1e9;
+
+    cout << "{\"phase\": \"" << phase << "\""
+         << ", \"routes\": " << routes
+         << ", \"ecmp\": " << options.ecmp
+         << ", \"v6_percent\": " << options.v6_percent
+         << ", \"total_ns\": " << elapsed.count()
+         << ", \"routes_per_sec\": " << (secs > 0 ? static_cast<double>(routes) / secs : 0.0)
+         << "}" << endl;
+}
+
+/* Send an operation on all the routes and wait for the last one to reach APPL_DB */
+static void runPhase(FpmClient &fpm, Table &table, const vector<Route> &routes,
+                     const string &phase, bool add, uint32_t round)
+{
+    auto start = chrono::steady_clock::now();
+
+    for (const auto &route : routes)
+    {
+        fpm.send(route, add, round);
+    }
+    fpm.flush();
+
+    /* fpmsyncd handles the messages in order */
+    waitRoute(table, routes.back(), add, round);
+
+    report(phase, routes.size(), chrono::steady_clock::now() - start);
+}
+
+/* Time for a single route add to reach APPL_DB, with the table loaded */
+static void runLatency(FpmClient &fpm, Table &table)
+{
+    vector<int64_t> latencies;
+
+    for (uint32_t i = 0; i < options.samples; i++)
+    {
+        Route probe = makeRoute(i, true);
+
+        auto start = chrono::steady_clock::now();
+        fpm.send(probe, true, 0);
+        fpm.flush();
+        waitRoute(table, probe, true, 0);
+        latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+
+        fpm.send(probe, false, 0);
+        fpm.flush();
+        waitRoute(table, probe, false, 0);
+    }
+
+    if (latencies.empty())
+    {
+        return;
+    }
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](size_t p) { return latencies[(latencies.size() - 1) * p / 100]; };
+
+    cout << "{\"phase\": \"latency\""
+         << ", \"samples\": " << latencies.size()
+         << ", \"p50_ns\": " << percentile(50)
+         << ", \"p99_ns\": " << percentile(99)
+         << ", \"max_ns\": " << latencies.back()
+         << "}" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "p:n:e:6:c:r:s:i:t:kh")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p':
+                options.port = static_cast<unsigned short>(stoul(optarg));
+                break;
+            case 'n':
+                options.prefixes = static_cast<uint32_t>(stoul(optarg));
+                break;
+            case 'e':
+                options.ecmp = static_cast<uint32_t>(stoul(optarg));
+                break;
+            case '6':
+                options.v6_percent = min(100U, static_cast<uint32_t>(stoul(optarg)));
+                break;
+            case 'c':
+                options.churn = optarg;
+                break;
+            case 'r':
+                options.rounds = static_cast<uint32_t>(stoul(optarg));
+                break;
+            case 's':
+                options.samples = static_cast<uint32_t>(stoul(optarg));
+                break;
+            case 'i':
+                options.ifindex = stoi(optarg);
+                break;
+            case 't':
+                options.timeout = static_cast<uint32_t>(stoul(optarg));
+                break;
+            case 'k':
+                options.keep = true;
+                break;
+            case 'h':
+                usage();
+                return 0;
+            default:
+                usage();
+                return 1;
+        }
+    }
+
+    if (options.prefixes == 0 || options.ecmp == 0 || options.ecmp > FPMGEN_MAX_ECMP ||
+        (options.churn != "none" && options.churn != "flap" && options.churn != "update"))
+    {
+        usage();
+        return 1;
+    }
+
+    try
+    {
+        DBConnector db(APPL_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+        Table table(&db, APP_ROUTE_TABLE_NAME);
+
+        vector<Route> routes;
+        routes.reserve(options.prefixes);
+        for (uint32_t i = 0; i < options.prefixes; i++)
+        {
+            routes.push_back(makeRoute(i, false));
+        }
+
+        FpmClient fpm(options.port);
+
+        runPhase(fpm, table, routes, "add", true, 0);
+
+        uint32_t round = 0;
+        for (uint32_t r = 0; r < options.rounds && options.churn != "none"; r++)
+        {
+            if (options.churn == "flap")
+            {
+                runPhase(fpm, table, routes, "flap_del", false, round);
+                runPhase(fpm, table, routes, "flap_add", true, round);
+            }
+            else
+            {
+                runPhase(fpm, table, routes, "update", true, ++round);
+            }
+        }
+
+        runLatency(fpm, table);
+
+        if (!options.keep)
+        {
+            runPhase(fpm, table, routes, "del", false, round);
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << "fpmgen: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
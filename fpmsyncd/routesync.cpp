@@ -141,6 +141,7 @@ void RouteSync::onRouteMsg(int nlmsg_type, struct nl_object *obj)
     /* Get nexthop lists */
     string nexthops = getNextHopGw(route_obj);
     string ifnames = getNextHopIf(route_obj);
+    string weights = getNextHopWt(route_obj);
 
     vector<FieldValueTuple> fvVector;
     FieldValueTuple nh("nexthop", nexthops);
@@ -149,6 +150,13 @@ void RouteSync::onRouteMsg(int nlmsg_type, struct nl_object *obj)
     fvVector.push_back(nh);
     fvVector.push_back(idx);
 
+    /* Only unequal cost multipath routes carry next hop weights */
+    if (!weights.empty())
+    {
+        FieldValueTuple wt("weight", weights);
+        fvVector.push_back(wt);
+    }
+
     if (!warmRestartInProgress)
     {
         m_routeTable.set(destipprefix, fvVector);
@@ -368,3 +376,42 @@ string RouteSync::getNextHopIf(struct rtnl_route *route_obj)
 
     return result;
 }
+
+/*
+ * Get next hop weights
+ * @arg route_obj     route object
+ *
+ * Return concatenation of weights: wt0 + "," + wt1 + .... + "," + wtN,
+ * or an empty string when all the next hops have the same weight
+ */
+string RouteSync::getNextHopWt(struct rtnl_route *route_obj)
+{
+    string result = "";
+    bool weighted = false;
+    int first_weight = 0;
+
+    for (int i = 0; i < rtnl_route_get_nnexthops(route_obj); i++)
+    {
+        struct rtnl_nexthop *nexthop = rtnl_route_nexthop_n(route_obj, i);
+        /* RTA_MULTIPATH carries the weight minus one in rtnh_hops */
+        int weight = rtnl_route_nh_get_weight(nexthop) + 1;
+
+        if (i == 0)
+        {
+            first_weight = weight;
+        }
+        else if (weight != first_weight)
+        {
+            weighted = true;
+        }
+
+        result += to_string(weight);
+
+        if (i + 1 < rtnl_route_get_nnexthops(route_obj))
+        {
+            result += string(",");
+        }
+    }
+
+    return weighted ? result : "";
+}
@@ -573,6 +573,14 @@ AclRuleCounters AclRule::getCounters()
     return AclRuleCounters(counter_attr[0].value.u64, counter_attr[1].value.u64);
 }
 
+uint64_t AclRule::getMemoryUsage() const
+{
+    return sizeof(AclRule) + heapBytes(m_id) + heapBytes(m_tableId) +
+           heapBytes(m_matches) + heapBytes(m_actions) +
+           heapBytes(m_redirect_target_next_hop) + heapBytes(m_redirect_target_next_hop_group) +
+           heapBytes(m_inPorts) + heapBytes(m_outPorts);
+}
+
 shared_ptr<AclRule> AclRule::makeShared(acl_table_type_t type, AclOrch *acl, MirrorOrch *mirror, DTelOrch *dtel, const string& rule, const string& table, const KeyOpFieldsValuesTuple& data)
 {
     string action;
@@ -2271,6 +2279,27 @@ bool AclOrch::isCombinedMirrorV6Table()
     return m_isCombinedMirrorV6Table;
 }
 
+void AclOrch::getMemoryStats(MemoryStatsTable &stats)
+{
+    Orch::getMemoryStats(stats);
+
+    MemoryStats &tables = stats["AclOrch:tables"];
+    MemoryStats &rules = stats["AclOrch:rules"];
+    for (const auto &it : m_AclTables)
+    {
+        const AclTable &table = it.second;
+        tables.add(1, sizeof(it) + MEMORY_TREE_NODE_OVERHEAD +
+                      heapBytes(table.id) + heapBytes(table.description) + heapBytes(table.ports) +
+                      heapBytes(table.portSet) + heapBytes(table.pendingPortSet));
+
+        for (const auto &rule : table.rules)
+        {
+            rules.add(1, sizeof(rule) + MEMORY_TREE_NODE_OVERHEAD + MEMORY_SHARED_OVERHEAD +
+                         heapBytes(rule.first) + rule.second->getMemoryUsage());
+        }
+    }
+}
+
 void AclOrch::doAclTableTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
@@ -197,6 +197,9 @@ public:
         return m_counterOid;
     }
 
+    /* Estimated memory used by the rule, without the members of the derived rule types */
+    uint64_t getMemoryUsage() const;
+
     static shared_ptr<AclRule> makeShared(acl_table_type_t type, AclOrch *acl, MirrorOrch *mirror, DTelOrch *dtel, const string& rule, const string& table, const KeyOpFieldsValuesTuple&);
     virtual ~AclRule() {}
 
@@ -405,6 +408,8 @@ public:
 
     bool isCombinedMirrorV6Table();
 
+    void getMemoryStats(MemoryStatsTable &stats) override;
+
     bool m_isCombinedMirrorV6Table = true;
     map<acl_table_type_t, bool> m_mirrorTableCapabilities;
 
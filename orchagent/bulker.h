@@ -0,0 +1,504 @@
+#pragma once
+
+/*
+ * Bulkers queue the SAI create/remove/set operations issued by an orch and
+ * program them with the SAI bulk APIs when flushed, once the orch has finished
+ * a doTask pass. Operations are flushed in the order they were queued, runs of
+ * operations of the same kind being grouped into a single bulk call, and the
+ * result of each operation is delivered to its own callback.
+ * Attribute values pointing to memory (lists, strings) must stay valid until
+ * the bulker is flushed.
+ */
+
+#include <functional>
+#include <vector>
+#include <utility>
+
+extern "C" {
+#include "sai.h"
+}
+
+#include "logger.h"
+
+enum class BulkOp
+{
+    create,
+    remove,
+    set
+};
+
+typedef std::function<void(sai_status_t)> BulkCallback;
+typedef std::function<void(sai_status_t, sai_object_id_t)> BulkCreateCallback;
+
+class BulkerBase
+{
+public:
+    virtual ~BulkerBase() { }
+
+    virtual void flush() = 0;
+    virtual size_t size() const = 0;
+};
+
+/*
+ * Describe how to program an entry based SAI object type. The bulk functions
+ * return SAI_STATUS_NOT_IMPLEMENTED when the API has no bulk flavor, in which
+ * case the bulker falls back to one call per entry.
+ */
+template <typename T>
+struct EntityBulkerTraits;
+
+template <>
+struct EntityBulkerTraits<sai_route_api_t>
+{
+    typedef sai_route_entry_t entry_t;
+
+    static sai_status_t bulkCreate(sai_route_api_t *api, uint32_t count, const entry_t *entries,
+            const uint32_t *attr_counts, const sai_attribute_t **attr_lists, sai_status_t *statuses)
+    {
+        return api->create_route_entries(count, entries, attr_counts, attr_lists,
+                SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses);
+    }
+
+    static sai_status_t bulkRemove(sai_route_api_t *api, uint32_t count, const entry_t *entries,
+            sai_status_t *statuses)
+    {
+        return api->remove_route_entries(count, entries, SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses);
+    }
+
+    static sai_status_t bulkSet(sai_route_api_t *api, uint32_t count, const entry_t *entries,
+            const sai_attribute_t *attrs, sai_status_t *statuses)
+    {
+        return api->set_route_entries_attribute(count, entries, attrs, SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses);
+    }
+
+    static sai_status_t create(sai_route_api_t *api, const entry_t *entry, uint32_t attr_count, const sai_attribute_t *attr_list)
+    {
+        return api->create_route_entry(entry, attr_count, attr_list);
+    }
+
+    static sai_status_t remove(sai_route_api_t *api, const entry_t *entry)
+    {
+        return api->remove_route_entry(entry);
+    }
+
+    static sai_status_t set(sai_route_api_t *api, const entry_t *entry, const sai_attribute_t *attr)
+    {
+        return api->set_route_entry_attribute(entry, attr);
+    }
+};
+
+/*
+ * Traits of an entry based SAI object type whose API has no bulk flavor, every
+ * operation is programmed with its own call.
+ */
+template <typename T, typename E,
+        sai_status_t (*T::*Create)(const E *, uint32_t, const sai_attribute_t *),
+        sai_status_t (*T::*Remove)(const E *),
+        sai_status_t (*T::*Set)(const E *, const sai_attribute_t *)>
+struct NoBulkEntityBulkerTraits
+{
+    typedef E entry_t;
+
+    static sai_status_t bulkCreate(T *, uint32_t, const entry_t *,
+            const uint32_t *, const sai_attribute_t **, sai_status_t *)
+    {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    static sai_status_t bulkRemove(T *, uint32_t, const entry_t *, sai_status_t *)
+    {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    static sai_status_t bulkSet(T *, uint32_t, const entry_t *,
+            const sai_attribute_t *, sai_status_t *)
+    {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    static sai_status_t create(T *api, const entry_t *entry, uint32_t attr_count, const sai_attribute_t *attr_list)
+    {
+        return (api->*Create)(entry, attr_count, attr_list);
+    }
+
+    static sai_status_t remove(T *api, const entry_t *entry)
+    {
+        return (api->*Remove)(entry);
+    }
+
+    static sai_status_t set(T *api, const entry_t *entry, const sai_attribute_t *attr)
+    {
+        return (api->*Set)(entry, attr);
+    }
+};
+
+template <>
+struct EntityBulkerTraits<sai_neighbor_api_t> :
+    NoBulkEntityBulkerTraits<sai_neighbor_api_t, sai_neighbor_entry_t,
+            &sai_neighbor_api_t::create_neighbor_entry,
+            &sai_neighbor_api_t::remove_neighbor_entry,
+            &sai_neighbor_api_t::set_neighbor_entry_attribute>
+{
+};
+
+template <>
+struct EntityBulkerTraits<sai_fdb_api_t> :
+    NoBulkEntityBulkerTraits<sai_fdb_api_t, sai_fdb_entry_t,
+            &sai_fdb_api_t::create_fdb_entry,
+            &sai_fdb_api_t::remove_fdb_entry,
+            &sai_fdb_api_t::set_fdb_entry_attribute>
+{
+};
+
+/*
+ * Describe how to program an object id based SAI object type. The traits are a
+ * parameter of the bulker, so that an API serving several object types can
+ * have a traits struct per type.
+ */
+template <typename T>
+struct ObjectBulkerTraits;
+
+template <>
+struct ObjectBulkerTraits<sai_next_hop_group_api_t>
+{
+    static sai_status_t bulkCreate(sai_next_hop_group_api_t *api, sai_object_id_t switch_id, uint32_t count,
+            const uint32_t *attr_counts, const sai_attribute_t **attr_lists,
+            sai_object_id_t *object_ids, sai_status_t *statuses)
+    {
+        return api->create_next_hop_group_members(switch_id, count, attr_counts, attr_lists,
+                SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, object_ids, statuses);
+    }
+
+    static sai_status_t bulkRemove(sai_next_hop_group_api_t *api, uint32_t count,
+            const sai_object_id_t *object_ids, sai_status_t *statuses)
+    {
+        return api->remove_next_hop_group_members(count, object_ids, SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, statuses);
+    }
+
+    static sai_status_t bulkSet(sai_next_hop_group_api_t *, uint32_t, const sai_object_id_t *,
+            const sai_attribute_t *, sai_status_t *)
+    {
+        return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    static sai_status_t create(sai_next_hop_group_api_t *api, sai_object_id_t *object_id, sai_object_id_t switch_id,
+            uint32_t attr_count, const sai_attribute_t *attr_list)
+    {
+        return api->create_next_hop_group_member(object_id, switch_id, attr_count, attr_list);
+    }
+
+    static sai_status_t remove(sai_next_hop_group_api_t *api, sai_object_id_t object_id)
+    {
+        return api->remove_next_hop_group_member(object_id);
+    }
+
+    static sai_status_t set(sai_next_hop_group_api_t *api, sai_object_id_t object_id, const sai_attribute_t *attr)
+    {
+        return api->set_next_hop_group_member_attribute(object_id, attr);
+    }
+};
+
+static inline bool isBulkNotSupported(sai_status_t status)
+{
+    return status == SAI_STATUS_NOT_IMPLEMENTED || status == SAI_STATUS_NOT_SUPPORTED;
+}
+
+template <typename T>
+class EntityBulker : public BulkerBase
+{
+public:
+    typedef EntityBulkerTraits<T> Traits;
+    typedef typename Traits::entry_t entry_t;
+
+    explicit EntityBulker(T *api) : m_api(api) { }
+
+    void create(const entry_t &entry, const std::vector<sai_attribute_t> &attrs, BulkCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::create, entry, attrs, callback });
+    }
+
+    void remove(const entry_t &entry, BulkCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::remove, entry, {}, callback });
+    }
+
+    void set(const entry_t &entry, const sai_attribute_t &attr, BulkCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::set, entry, { attr }, callback });
+    }
+
+    size_t size() const override
+    {
+        return m_operations.size();
+    }
+
+    void flush() override
+    {
+        /* Callbacks may queue new operations, which are flushed in turn */
+        while (!m_operations.empty())
+        {
+            std::vector<Operation> operations;
+            operations.swap(m_operations);
+
+            size_t begin = 0;
+            while (begin < operations.size())
+            {
+                size_t end = begin + 1;
+                while (end < operations.size() && operations[end].op == operations[begin].op)
+                {
+                    end++;
+                }
+
+                flush(operations, begin, end);
+                begin = end;
+            }
+        }
+    }
+
+private:
+    struct Operation
+    {
+        BulkOp op;
+        entry_t entry;
+        std::vector<sai_attribute_t> attrs;
+        BulkCallback callback;
+    };
+
+    T *m_api;
+    std::vector<Operation> m_operations;
+
+    void flush(std::vector<Operation> &operations, size_t begin, size_t end)
+    {
+        SWSS_LOG_ENTER();
+
+        uint32_t count = (uint32_t)(end - begin);
+        BulkOp op = operations[begin].op;
+
+        std::vector<entry_t> entries;
+        std::vector<uint32_t> attr_counts;
+        std::vector<const sai_attribute_t *> attr_lists;
+        std::vector<sai_attribute_t> set_attrs;
+        /* Entries the bulk call does not fill in are reported as failed */
+        std::vector<sai_status_t> statuses(count, SAI_STATUS_FAILURE);
+
+        for (size_t i = begin; i < end; i++)
+        {
+            entries.push_back(operations[i].entry);
+            attr_counts.push_back((uint32_t)operations[i].attrs.size());
+            attr_lists.push_back(operations[i].attrs.data());
+            if (op == BulkOp::set)
+            {
+                set_attrs.push_back(operations[i].attrs[0]);
+            }
+        }
+
+        sai_status_t status;
+        switch (op)
+        {
+            case BulkOp::create:
+                status = Traits::bulkCreate(m_api, count, entries.data(), attr_counts.data(), attr_lists.data(), statuses.data());
+                break;
+            case BulkOp::remove:
+                status = Traits::bulkRemove(m_api, count, entries.data(), statuses.data());
+                break;
+            default:
+                status = Traits::bulkSet(m_api, count, entries.data(), set_attrs.data(), statuses.data());
+                break;
+        }
+
+        if (status != SAI_STATUS_SUCCESS && !isBulkNotSupported(status))
+        {
+            SWSS_LOG_ERROR("Bulk operation on %u entries failed, rv:%d", count, status);
+            for (auto &entry_status : statuses)
+            {
+                if (entry_status == SAI_STATUS_FAILURE)
+                {
+                    entry_status = status;
+                }
+            }
+        }
+
+        if (isBulkNotSupported(status))
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                switch (op)
+                {
+                    case BulkOp::create:
+                        statuses[i] = Traits::create(m_api, &entries[i], attr_counts[i], attr_lists[i]);
+                        break;
+                    case BulkOp::remove:
+                        statuses[i] = Traits::remove(m_api, &entries[i]);
+                        break;
+                    default:
+                        statuses[i] = Traits::set(m_api, &entries[i], &set_attrs[i]);
+                        break;
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto &callback = operations[begin + i].callback;
+            if (callback)
+            {
+                callback(statuses[i]);
+            }
+        }
+    }
+};
+
+template <typename T, typename TraitsT = ObjectBulkerTraits<T>>
+class ObjectBulker : public BulkerBase
+{
+public:
+    typedef TraitsT Traits;
+
+    ObjectBulker(T *api, sai_object_id_t switch_id) : m_api(api), m_switchId(switch_id) { }
+
+    void create(const std::vector<sai_attribute_t> &attrs, BulkCreateCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::create, SAI_NULL_OBJECT_ID, attrs, callback, nullptr });
+    }
+
+    void remove(sai_object_id_t object_id, BulkCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::remove, object_id, {}, nullptr, callback });
+    }
+
+    void set(sai_object_id_t object_id, const sai_attribute_t &attr, BulkCallback callback = nullptr)
+    {
+        m_operations.push_back({ BulkOp::set, object_id, { attr }, nullptr, callback });
+    }
+
+    size_t size() const override
+    {
+        return m_operations.size();
+    }
+
+    void flush() override
+    {
+        /* Callbacks may queue new operations, which are flushed in turn */
+        while (!m_operations.empty())
+        {
+            std::vector<Operation> operations;
+            operations.swap(m_operations);
+
+            size_t begin = 0;
+            while (begin < operations.size())
+            {
+                size_t end = begin + 1;
+                while (end < operations.size() && operations[end].op == operations[begin].op)
+                {
+                    end++;
+                }
+
+                flush(operations, begin, end);
+                begin = end;
+            }
+        }
+    }
+
+private:
+    struct Operation
+    {
+        BulkOp op;
+        sai_object_id_t object_id;
+        std::vector<sai_attribute_t> attrs;
+        BulkCreateCallback create_callback;
+        BulkCallback callback;
+    };
+
+    T *m_api;
+    sai_object_id_t m_switchId;
+    std::vector<Operation> m_operations;
+
+    void flush(std::vector<Operation> &operations, size_t begin, size_t end)
+    {
+        SWSS_LOG_ENTER();
+
+        uint32_t count = (uint32_t)(end - begin);
+        BulkOp op = operations[begin].op;
+
+        std::vector<sai_object_id_t> object_ids;
+        std::vector<uint32_t> attr_counts;
+        std::vector<const sai_attribute_t *> attr_lists;
+        std::vector<sai_attribute_t> set_attrs;
+        /* Entries the bulk call does not fill in are reported as failed */
+        std::vector<sai_status_t> statuses(count, SAI_STATUS_FAILURE);
+
+        for (size_t i = begin; i < end; i++)
+        {
+            object_ids.push_back(operations[i].object_id);
+            attr_counts.push_back((uint32_t)operations[i].attrs.size());
+            attr_lists.push_back(operations[i].attrs.data());
+            if (op == BulkOp::set)
+            {
+                set_attrs.push_back(operations[i].attrs[0]);
+            }
+        }
+
+        sai_status_t status;
+        switch (op)
+        {
+            case BulkOp::create:
+                status = Traits::bulkCreate(m_api, m_switchId, count, attr_counts.data(), attr_lists.data(),
+                        object_ids.data(), statuses.data());
+                break;
+            case BulkOp::remove:
+                status = Traits::bulkRemove(m_api, count, object_ids.data(), statuses.data());
+                break;
+            default:
+                status = Traits::bulkSet(m_api, count, object_ids.data(), set_attrs.data(), statuses.data());
+                break;
+        }
+
+        if (status != SAI_STATUS_SUCCESS && !isBulkNotSupported(status))
+        {
+            SWSS_LOG_ERROR("Bulk operation on %u entries failed, rv:%d", count, status);
+            for (auto &entry_status : statuses)
+            {
+                if (entry_status == SAI_STATUS_FAILURE)
+                {
+                    entry_status = status;
+                }
+            }
+        }
+
+        if (isBulkNotSupported(status))
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                switch (op)
+                {
+                    case BulkOp::create:
+                        statuses[i] = Traits::create(m_api, &object_ids[i], m_switchId, attr_counts[i], attr_lists[i]);
+                        break;
+                    case BulkOp::remove:
+                        statuses[i] = Traits::remove(m_api, object_ids[i]);
+                        break;
+                    default:
+                        statuses[i] = Traits::set(m_api, object_ids[i], &set_attrs[i]);
+                        break;
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto &operation = operations[begin + i];
+            if (op == BulkOp::create)
+            {
+                if (operation.create_callback)
+                {
+                    operation.create_callback(statuses[i],
+                            statuses[i] == SAI_STATUS_SUCCESS ? object_ids[i] : SAI_NULL_OBJECT_ID);
+                }
+            }
+            else if (operation.callback)
+            {
+                operation.callback(statuses[i]);
+            }
+        }
+    }
+};
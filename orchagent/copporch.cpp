@@ -6,6 +6,8 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <set>
 
 using namespace swss;
 using namespace std;
@@ -87,6 +89,28 @@ const vector<sai_hostif_trap_type_t> default_trap_ids = {
     SAI_HOSTIF_TRAP_TYPE_TTL_ERROR
 };
 
+/* Policer attributes which can only be set when the policer is created */
+const set<sai_attr_id_t> policer_create_only_attrs = {
+    SAI_POLICER_ATTR_METER_TYPE,
+    SAI_POLICER_ATTR_MODE,
+    SAI_POLICER_ATTR_COLOR_SOURCE
+};
+
+/*
+ * Return true if the attribute value differs from the applied one.
+ * The attributes are compared as a whole, so they must be zero initialized.
+ */
+static bool isAttrChanged(const CoppAttrValues &applied, const sai_attribute_t &attr)
+{
+    auto it = applied.find(attr.id);
+    if (it == applied.end())
+    {
+        return true;
+    }
+
+    return memcmp(&it->second, &attr.value, sizeof(attr.value)) != 0;
+}
+
 CoppOrch::CoppOrch(DBConnector *db, string tableName) :
     Orch(db, tableName)
 {
@@ -131,6 +155,7 @@ void CoppOrch::initDefaultTrapIds()
     sai_attribute_t attr;
     vector<sai_attribute_t> trap_id_attrs;
 
+    memset(&attr, 0, sizeof(attr));
     attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
     attr.value.s32 = SAI_PACKET_ACTION_TRAP;
     trap_id_attrs.push_back(attr);
@@ -192,30 +217,95 @@ bool CoppOrch::applyAttributesToTrapIds(sai_object_id_t trap_group_id,
                                         const vector<sai_hostif_trap_type_t> &trap_id_list,
                                         vector<sai_attribute_t> &trap_id_attribs)
 {
+    SWSS_LOG_ENTER();
+
     for (auto trap_id : trap_id_list)
     {
-        sai_attribute_t attr;
-        vector<sai_attribute_t> attrs;
+        auto it = m_syncdTrapIds.find(trap_id);
+
+        /* Create the trap with all its attributes */
+        if (it == m_syncdTrapIds.end())
+        {
+            sai_attribute_t attr;
+            vector<sai_attribute_t> attrs;
+
+            attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_TYPE;
+            attr.value.s32 = trap_id;
+            attrs.push_back(attr);
 
-        attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_TYPE;
-        attr.value.s32 = trap_id;
-        attrs.push_back(attr);
+            attrs.insert(attrs.end(), trap_id_attribs.begin(), trap_id_attribs.end());
 
-        attrs.insert(attrs.end(), trap_id_attribs.begin(), trap_id_attribs.end());
+            sai_object_id_t hostif_trap_id;
+            sai_status_t status = sai_hostif_api->create_hostif_trap(&hostif_trap_id, gSwitchId, (uint32_t)attrs.size(), attrs.data());
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to create trap %d, rv:%d", trap_id, status);
+                return false;
+            }
 
-        sai_object_id_t hostif_trap_id;
-        sai_status_t status = sai_hostif_api->create_hostif_trap(&hostif_trap_id, gSwitchId, (uint32_t)attrs.size(), attrs.data());
-        if (status != SAI_STATUS_SUCCESS)
+            CoppTrapEntry &entry = m_syncdTrapIds[trap_id];
+            entry.trap_obj = hostif_trap_id;
+            entry.trap_group = trap_group_id;
+            for (auto &trap_attr : trap_id_attribs)
+            {
+                entry.attrs[trap_attr.id] = trap_attr.value;
+            }
+
+            SWSS_LOG_INFO("Create trap %d", trap_id);
+            continue;
+        }
+
+        /* Set only the attributes which changed on the existing trap */
+        CoppTrapEntry &entry = it->second;
+        for (auto &trap_attr : trap_id_attribs)
         {
-            SWSS_LOG_ERROR("Failed to create trap %d, rv:%d", trap_id, status);
-            return false;
+            if (!isAttrChanged(entry.attrs, trap_attr))
+            {
+                continue;
+            }
+
+            sai_status_t status = sai_hostif_api->set_hostif_trap_attribute(entry.trap_obj, &trap_attr);
+            if (status != SAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to set attribute %d to trap %d, rv:%d", trap_attr.id, trap_id, status);
+                return false;
+            }
+
+            entry.attrs[trap_attr.id] = trap_attr.value;
+            SWSS_LOG_INFO("Set attribute %d to trap %d", trap_attr.id, trap_id);
         }
-        m_syncdTrapIds[trap_id] = hostif_trap_id;
+        entry.trap_group = trap_group_id;
     }
 
     return true;
 }
 
+bool CoppOrch::resetTrapIds(const vector<sai_hostif_trap_type_t> &trap_id_list)
+{
+    SWSS_LOG_ENTER();
+
+    if (trap_id_list.empty())
+    {
+        return true;
+    }
+
+    /* Move the trap IDs back to the default trap group with default attributes */
+    sai_attribute_t attr;
+    vector<sai_attribute_t> default_trap_attrs;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
+    default_trap_attrs.push_back(attr);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
+    attr.value.oid = m_trap_group_map[default_trap_group];
+    default_trap_attrs.push_back(attr);
+
+    return applyAttributesToTrapIds(m_trap_group_map[default_trap_group], trap_id_list, default_trap_attrs);
+}
+
 bool CoppOrch::applyTrapIds(sai_object_id_t trap_group, vector<string> &trap_id_name_list, vector<sai_attribute_t> &trap_id_attribs)
 {
     SWSS_LOG_ENTER();
@@ -225,6 +315,7 @@ bool CoppOrch::applyTrapIds(sai_object_id_t trap_group, vector<string> &trap_id_
     getTrapIdList(trap_id_name_list, trap_id_list);
 
     sai_attribute_t attr;
+    memset(&attr, 0, sizeof(attr));
     attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
     attr.value.oid = trap_group;
     trap_id_attribs.push_back(attr);
@@ -265,6 +356,7 @@ bool CoppOrch::removePolicer(string trap_group_name)
 
     SWSS_LOG_NOTICE("Remove policer for trap group %s", trap_group_name.c_str());
     m_trap_group_policer_map.erase(m_trap_group_map[trap_group_name]);
+    m_policer_attrs.erase(trap_group_name);
     return true;
 }
 
@@ -315,6 +407,100 @@ bool CoppOrch::createPolicer(string trap_group_name, vector<sai_attribute_t> &po
 
     SWSS_LOG_NOTICE("Bind policer to trap group %s:", trap_group_name.c_str());
     m_trap_group_policer_map[m_trap_group_map[trap_group_name]] = policer_id;
+
+    CoppAttrValues &applied = m_policer_attrs[trap_group_name];
+    applied.clear();
+    for (auto &policer_attr : policer_attribs)
+    {
+        applied[policer_attr.id] = policer_attr.value;
+    }
+    return true;
+}
+
+bool CoppOrch::setPolicerAttributes(string trap_group_name, sai_object_id_t policer_id, const vector<sai_attribute_t> &policer_attribs)
+{
+    SWSS_LOG_ENTER();
+
+    const CoppAttrValues &applied = m_policer_attrs[trap_group_name];
+    vector<sai_attribute_t> changed_attribs;
+    bool recreate = false;
+
+    for (auto &policer_attr : policer_attribs)
+    {
+        if (isAttrChanged(applied, policer_attr))
+        {
+            changed_attribs.push_back(policer_attr);
+            recreate |= policer_create_only_attrs.find(policer_attr.id) != policer_create_only_attrs.end();
+        }
+    }
+
+    if (changed_attribs.empty())
+    {
+        SWSS_LOG_DEBUG("Policer for trap group %s is up to date", trap_group_name.c_str());
+        return true;
+    }
+
+    /* Create only attributes changed, replace the policer keeping the other applied attributes */
+    if (recreate)
+    {
+        CoppAttrValues values = applied;
+        for (auto &policer_attr : changed_attribs)
+        {
+            values[policer_attr.id] = policer_attr.value;
+        }
+
+        vector<sai_attribute_t> attribs;
+        for (auto &value : values)
+        {
+            sai_attribute_t attr;
+            attr.id = value.first;
+            attr.value = value.second;
+            attribs.push_back(attr);
+        }
+
+        SWSS_LOG_NOTICE("Recreate policer for trap group %s", trap_group_name.c_str());
+        return removePolicer(trap_group_name) && createPolicer(trap_group_name, attribs);
+    }
+
+    for (auto &policer_attr : changed_attribs)
+    {
+        sai_status_t sai_status = sai_policer_api->set_policer_attribute(policer_id, &policer_attr);
+        if (sai_status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to apply attribute id=%d to policer for trap group:%s, error:%d\n", policer_attr.id, trap_group_name.c_str(), sai_status);
+            return false;
+        }
+
+        m_policer_attrs[trap_group_name][policer_attr.id] = policer_attr.value;
+    }
+
+    return true;
+}
+
+bool CoppOrch::setTrapGroupAttributes(string trap_group_name, const vector<sai_attribute_t> &trap_gr_attribs)
+{
+    SWSS_LOG_ENTER();
+
+    CoppAttrValues &applied = m_trap_group_attrs[trap_group_name];
+
+    for (auto &trap_gr_attr : trap_gr_attribs)
+    {
+        if (!isAttrChanged(applied, trap_gr_attr))
+        {
+            continue;
+        }
+
+        sai_status_t sai_status = sai_hostif_api->set_hostif_trap_group_attribute(m_trap_group_map[trap_group_name], &trap_gr_attr);
+        if (sai_status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to apply attribute:%d to trap group:%lx, name:%s, error:%d\n", trap_gr_attr.id, m_trap_group_map[trap_group_name], trap_group_name.c_str(), sai_status);
+            return false;
+        }
+
+        applied[trap_gr_attr.id] = trap_gr_attr.value;
+        SWSS_LOG_NOTICE("Set trap group %s to host interface", trap_group_name.c_str());
+    }
+
     return true;
 }
 
@@ -324,6 +510,7 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
     sai_status_t sai_status;
     vector<string> trap_id_list;
+    bool has_trap_id_list = false;
     string queue_ind;
     auto it = consumer.m_toSync.begin();
     KeyOpFieldsValuesTuple tuple = it->second;
@@ -336,13 +523,22 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
     if (op == SET_COMMAND)
     {
+        auto fields = m_trap_group_fields.find(trap_group_name);
+        if (fields != m_trap_group_fields.end() && fields->second == kfvFieldsValues(tuple))
+        {
+            SWSS_LOG_INFO("Trap group %s is up to date", trap_group_name.c_str());
+            return task_process_status::task_ignore;
+        }
+
         for (auto i = kfvFieldsValues(tuple).begin(); i != kfvFieldsValues(tuple).end(); i++)
         {
             sai_attribute_t attr;
+            memset(&attr, 0, sizeof(attr));
 
             if (fvField(*i) == copp_trap_id_list)
             {
                 trap_id_list = tokenize(fvValue(*i), list_item_delimiter);
+                has_trap_id_list = true;
             }
             else if (fvField(*i) == copp_queue_field)
             {
@@ -463,34 +659,15 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
                     }
                     SWSS_LOG_DEBUG("Created policer:%lx for existing trap group", policer_id);
                 }
-                else
+                else if (!setPolicerAttributes(trap_group_name, policer_id, policer_attribs))
                 {
-                /* TODO: We should really only set changed attributes.
-                The changes need to detected either by orch agent submodule or by the orch agent framework. */
-                    for (sai_uint32_t ind = 0; ind < policer_attribs.size(); ind++)
-                    {
-                        auto policer_attr = policer_attribs[ind];
-                        sai_status = sai_policer_api->set_policer_attribute(policer_id, &policer_attr);
-                        if (sai_status != SAI_STATUS_SUCCESS)
-                        {
-                            SWSS_LOG_ERROR("Failed to apply attribute[%d].id=%d to policer for trap group:%s, error:%d\n", ind, policer_attr.id, trap_group_name.c_str(), sai_status);
-                            return task_process_status::task_failed;
-                        }
-                    }
+                    return task_process_status::task_failed;
                 }
             }
 
-            for (sai_uint32_t ind = 0; ind < trap_gr_attribs.size(); ind++)
+            if (!setTrapGroupAttributes(trap_group_name, trap_gr_attribs))
             {
-                auto trap_gr_attr = trap_gr_attribs[ind];
-
-                sai_status = sai_hostif_api->set_hostif_trap_group_attribute(m_trap_group_map[trap_group_name], &trap_gr_attr);
-                if (sai_status != SAI_STATUS_SUCCESS)
-                {
-                    SWSS_LOG_ERROR("Failed to apply attribute:%d to trap group:%lx, name:%s, error:%d\n", trap_gr_attr.id, m_trap_group_map[trap_group_name], trap_group_name.c_str(), sai_status);
-                    return task_process_status::task_failed;
-                }
-                SWSS_LOG_NOTICE("Set trap group %s to host interface", trap_group_name.c_str());
+                return task_process_status::task_failed;
             }
         }
         /* Create host interface trap group */
@@ -508,6 +685,12 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
             SWSS_LOG_NOTICE("Create host interface trap group %s", trap_group_name.c_str());
             m_trap_group_map[trap_group_name] = new_trap;
 
+            CoppAttrValues &applied = m_trap_group_attrs[trap_group_name];
+            for (auto &trap_gr_attr : trap_gr_attribs)
+            {
+                applied[trap_gr_attr.id] = trap_gr_attr.value;
+            }
+
             /* Create policer */
             if (!policer_attribs.empty())
             {
@@ -518,14 +701,41 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
             }
         }
 
+        /* Reset the trap IDs removed from the trap group */
+        if (has_trap_id_list)
+        {
+            vector<sai_hostif_trap_type_t> new_trap_ids;
+            vector<sai_hostif_trap_type_t> trap_ids_to_reset;
+
+            getTrapIdList(trap_id_list, new_trap_ids);
+            for (auto &trap : m_syncdTrapIds)
+            {
+                if (trap.second.trap_group == m_trap_group_map[trap_group_name]
+                    && find(new_trap_ids.begin(), new_trap_ids.end(), trap.first) == new_trap_ids.end())
+                {
+                    trap_ids_to_reset.push_back(trap.first);
+                }
+            }
+
+            if (!resetTrapIds(trap_ids_to_reset))
+            {
+                SWSS_LOG_ERROR("Failed to reset traps removed from trap group %s", trap_group_name.c_str());
+                return task_process_status::task_failed;
+            }
+        }
+
         /* Apply traps to trap group */
         if (!applyTrapIds(m_trap_group_map[trap_group_name], trap_id_list, trap_id_attribs))
         {
             return task_process_status::task_failed;
         }
+
+        m_trap_group_fields[trap_group_name] = kfvFieldsValues(tuple);
     }
     else if (op == DEL_COMMAND)
     {
+        m_trap_group_fields.erase(trap_group_name);
+
         /* Remove policer if any */
         if (!removePolicer(trap_group_name))
         {
@@ -542,26 +752,15 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
         /* Reset the trap IDs to default trap group with default attributes */
         vector<sai_hostif_trap_type_t> trap_ids_to_reset;
-        for (auto it : m_syncdTrapIds)
+        for (auto &trap : m_syncdTrapIds)
         {
-            if (it.second == m_trap_group_map[trap_group_name])
+            if (trap.second.trap_group == m_trap_group_map[trap_group_name])
             {
-                trap_ids_to_reset.push_back(it.first);
+                trap_ids_to_reset.push_back(trap.first);
             }
         }
 
-        sai_attribute_t attr;
-        vector<sai_attribute_t> default_trap_attrs;
-
-        attr.id = SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION;
-        attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-        default_trap_attrs.push_back(attr);
-
-        attr.id = SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP;
-        attr.value.oid = m_trap_group_map[default_trap_group];
-        default_trap_attrs.push_back(attr);
-
-        if (!applyAttributesToTrapIds(m_trap_group_map[default_trap_group], trap_ids_to_reset, default_trap_attrs))
+        if (!resetTrapIds(trap_ids_to_reset))
         {
             SWSS_LOG_ERROR("Failed to reset traps to default trap group with default attributes");
             return task_process_status::task_failed;
@@ -576,6 +775,7 @@ task_process_status CoppOrch::processCoppRule(Consumer& consumer)
 
         auto it_del = m_trap_group_map.find(trap_group_name);
         m_trap_group_map.erase(it_del);
+        m_trap_group_attrs.erase(trap_group_name);
     }
     else
     {
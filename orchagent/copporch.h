@@ -26,8 +26,19 @@ const string copp_policer_action_yellow_field = "yellow_action";
 
 /* TrapGroupPolicerTable: trap group ID, policer ID */
 typedef map<sai_object_id_t, sai_object_id_t> TrapGroupPolicerTable;
-/* TrapIdTrapGroupTable: trap ID, trap group ID */
-typedef map<sai_hostif_trap_type_t, sai_object_id_t> TrapIdTrapGroupTable;
+
+/* CoppAttrValues: attribute ID, value as last applied to SAI */
+typedef map<sai_attr_id_t, sai_attribute_value_t> CoppAttrValues;
+
+struct CoppTrapEntry
+{
+    sai_object_id_t trap_obj;       // hostif trap object
+    sai_object_id_t trap_group;     // trap group the trap ID belongs to
+    CoppAttrValues  attrs;          // applied trap attributes
+};
+
+/* TrapIdTable: trap ID, hostif trap */
+typedef map<sai_hostif_trap_type_t, CoppTrapEntry> TrapIdTable;
 
 class CoppOrch : public Orch
 {
@@ -37,7 +48,13 @@ protected:
     object_map m_trap_group_map;
 
     TrapGroupPolicerTable m_trap_group_policer_map;
-    TrapIdTrapGroupTable m_syncdTrapIds;
+    TrapIdTable m_syncdTrapIds;
+
+    /* Applied trap group and policer attributes, per trap group name */
+    map<string, CoppAttrValues> m_trap_group_attrs;
+    map<string, CoppAttrValues> m_policer_attrs;
+    /* Last applied fields, per trap group name */
+    map<string, vector<FieldValueTuple>> m_trap_group_fields;
 
     void initDefaultHostIntfTable();
     void initDefaultTrapGroup();
@@ -48,6 +65,10 @@ protected:
     void getTrapIdList(vector<string> &trap_id_name_list, vector<sai_hostif_trap_type_t> &trap_id_list) const;
     bool applyTrapIds(sai_object_id_t trap_group, vector<string> &trap_id_name_list, vector<sai_attribute_t> &trap_id_attribs);
     bool applyAttributesToTrapIds(sai_object_id_t trap_group_id, const vector<sai_hostif_trap_type_t> &trap_id_list, vector<sai_attribute_t> &trap_id_attribs);
+    bool resetTrapIds(const vector<sai_hostif_trap_type_t> &trap_id_list);
+
+    bool setPolicerAttributes(string trap_group_name, sai_object_id_t policer_id, const vector<sai_attribute_t> &policer_attribs);
+    bool setTrapGroupAttributes(string trap_group_name, const vector<sai_attribute_t> &trap_gr_attribs);
 
     bool createPolicer(string trap_group, vector<sai_attribute_t> &policer_attribs);
     bool removePolicer(string trap_group_name);
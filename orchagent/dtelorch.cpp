@@ -6,6 +6,8 @@
 #include "ipprefix.h"
 #include "swssnet.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace swss;
 
@@ -265,7 +267,6 @@ bool DTelOrch::addPortQueue(const string& port, const string& queue, DTelQueueRe
         return false;
     }
 
-    m_dTelPortTable[port] = DTelPortEntry();
     m_dTelPortTable[port].queueTable[queue] = DTelQueueReportEntry();
     *qreport = &m_dTelPortTable[port].queueTable[queue];
     return true;
@@ -335,32 +336,48 @@ sai_status_t DTelOrch::updateSinkPortList()
     attr.id = SAI_DTEL_ATTR_SINK_PORT_LIST;
     sai_status_t status = SAI_STATUS_SUCCESS;
 
-    vector<sai_object_id_t> port_list;
+    attr.value.objlist.count = (uint32_t)sinkPortOids.size();
+    attr.value.objlist.list = sinkPortOids.data();
 
-    for (auto it = sinkPortList.begin(); it != sinkPortList.end(); it++)
+    status = sai_dtel_api->set_dtel_attribute(dtelId, &attr);
+    if (status != SAI_STATUS_SUCCESS)
     {
-        if (it->second != 0)
-        {
-            port_list.push_back(it->second);
-        }
+        SWSS_LOG_ERROR("DTEL ERROR: Failed to set INT sink port list");
+        return status;
     }
 
-    attr.value.objlist.count = (uint32_t)port_list.size();
-    if (port_list.size() == 0)
+    return status;
+}
+
+/*
+ * Set the oid of a sink port, 0 when the port is not present, and keep the
+ * programmed list in sync. Return true if the sink port list changed.
+ */
+bool DTelOrch::setSinkPort(const string& port_alias, sai_object_id_t port_oid)
+{
+    auto it = sinkPortList.find(port_alias);
+    if (it == sinkPortList.end())
     {
-        attr.value.objlist.list = {};
-    } else {
-        attr.value.objlist.list = port_list.data();
+        it = sinkPortList.emplace(port_alias, 0).first;
     }
 
-    status = sai_dtel_api->set_dtel_attribute(dtelId, &attr);
-    if (status != SAI_STATUS_SUCCESS)
+    if (it->second == port_oid)
     {
-        SWSS_LOG_ERROR("DTEL ERROR: Failed to set INT sink port list");
-        return status;
+        return false;
     }
 
-    return status;
+    if (it->second != 0)
+    {
+        sinkPortOids.erase(find(sinkPortOids.begin(), sinkPortOids.end(), it->second));
+    }
+
+    if (port_oid != 0)
+    {
+        sinkPortOids.push_back(port_oid);
+    }
+
+    it->second = port_oid;
+    return true;
 }
 
 bool DTelOrch::addSinkPortToCache(const Port& port)
@@ -376,8 +393,7 @@ bool DTelOrch::addSinkPortToCache(const Port& port)
         return false;
     }
 
-    sinkPortList[port.m_alias] = port.m_port_id;
-    return true;
+    return setSinkPort(port.m_alias, port.m_port_id);
 }
 
 bool DTelOrch::removeSinkPortFromCache(const string &port_alias)
@@ -387,8 +403,7 @@ bool DTelOrch::removeSinkPortFromCache(const string &port_alias)
         return false;
     }
 
-    sinkPortList[port_alias] = 0;
-    return true;
+    return setSinkPort(port_alias, 0);
 }
 
 void DTelOrch::update(SubjectType type, void *cntx)
@@ -434,45 +449,39 @@ void DTelOrch::update(SubjectType type, void *cntx)
         return;
     }
 
-    dTelPortQueueTable_t qTable = port_entry_iter->second.queueTable;
+    dTelPortQueueTable_t &qTable = port_entry_iter->second.queueTable;
 
     for (auto it = qTable.begin(); it != qTable.end(); it++ )
     {
-        DTelQueueReportEntry qreport = it->second;
+        DTelQueueReportEntry &qreport = it->second;
         if (update->add)
         {
             if (qreport.queueReportOid != 0)
             {
                 SWSS_LOG_ERROR("DTEL ERROR: Queue report already enabled for port %s, queue %d", update->port.m_alias.c_str(), qreport.q_ind);
-                return;
+                continue;
             }
 
             if (update->port.m_type != Port::PHY)
             {
                 SWSS_LOG_ERROR("DTEL ERROR: Queue reporting applies only to physical ports. %s is not a physical port", update->port.m_alias.c_str());
-                return;
+                break;
             }
 
             qreport.queueOid = update->port.m_queue_ids[qreport.q_ind];
 
-            status = enableQueueReport(update->port.m_alias, qreport);
-            if (status != SAI_STATUS_SUCCESS)
-            {
-                SWSS_LOG_ERROR("DTEL ERROR: Failed to update queue report for queue %d on port add %s", qreport.q_ind, update->port.m_alias.c_str());
-                return;
-            }
+            enableQueueReport(update->port.m_alias, qreport);
         } else {
             if (qreport.queueReportOid == 0)
             {
                 SWSS_LOG_ERROR("DTEL ERROR: Queue report already disabled for port %s, queue %d", update->port.m_alias.c_str(), qreport.q_ind);
-                return;
+                continue;
             }
 
-            status = disableQueueReport(update->port.m_alias, it->first);
-            if (status != SAI_STATUS_SUCCESS)
+            if (!disableQueueReport(update->port.m_alias, it->first))
             {
                 SWSS_LOG_ERROR("DTEL ERROR: Failed to update queue report for queue %d on port remove %s", qreport.q_ind, update->port.m_alias.c_str());
-                return;
+                continue;
             }
 
             qreport.queueOid = 0;
@@ -604,20 +613,25 @@ void DTelOrch::doDtelTableTask(Consumer &consumer)
             {
                 Port port;
 
+                /* Reject the whole list before any sink port is recorded, so
+                 * that it is programmed in full once it is valid */
                 for (auto i : kfvFieldsValues(t))
                 {
-                    if (m_portOrch->getPort(fvField(i), port))
+                    if (m_portOrch->getPort(fvField(i), port) && port.m_type != Port::PHY)
                     {
-                        if (port.m_type != Port::PHY)
-                        {
-                            SWSS_LOG_ERROR("DTEL ERROR: Only physical ports supported as INT sink. %s is not a physical port", fvField(i).c_str());
-                            goto dtel_table_continue;
-                        }
+                        SWSS_LOG_ERROR("DTEL ERROR: Only physical ports supported as INT sink. %s is not a physical port", fvField(i).c_str());
+                        goto dtel_table_continue;
+                    }
+                }
 
-                        sinkPortList[fvField(i)] = port.m_port_id;
+                for (auto i : kfvFieldsValues(t))
+                {
+                    if (m_portOrch->getPort(fvField(i), port))
+                    {
+                        setSinkPort(fvField(i), port.m_port_id);
                     } else {
                         SWSS_LOG_ERROR("DTEL ERROR: Port to be added a sink port %s doesn't exist", fvField(i).c_str());
-                        sinkPortList[fvField(i)] = 0;
+                        setSinkPort(fvField(i), 0);
                     }
                 }
 
@@ -627,6 +641,8 @@ void DTelOrch::doDtelTableTask(Consumer &consumer)
                     goto dtel_table_continue;
                 }
 
+                /* Always program the list, so that a list which failed to
+                 * be programmed before is pushed again */
                 status = updateSinkPortList();
                 if (status != SAI_STATUS_SUCCESS)
                 {
@@ -772,6 +788,7 @@ void DTelOrch::doDtelTableTask(Consumer &consumer)
             else if (table_attr == SINK_PORT_LIST)
             {
                 sinkPortList.clear();
+                sinkPortOids.clear();
                 status = updateSinkPortList();
                 if (status != SAI_STATUS_SUCCESS)
                 {
@@ -1093,7 +1110,6 @@ int_session_table_continue:
 bool DTelOrch::disableQueueReport(const string &port, const string &queue)
 {
     sai_object_id_t queue_report_oid;
-    sai_status_t status;
 
     if (!isQueueReportEnabled(port, queue))
     {
@@ -1112,7 +1128,7 @@ bool DTelOrch::disableQueueReport(const string &port, const string &queue)
         return true;
     }
 
-    status = sai_dtel_api->remove_dtel_queue_report(queue_report_oid);
+    sai_status_t status = sai_dtel_api->remove_dtel_queue_report(queue_report_oid);
     if (status != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("DTEL ERROR: Failed to disable queue report for port %s, queue %s", port.c_str(), queue.c_str());
@@ -1124,38 +1140,36 @@ bool DTelOrch::disableQueueReport(const string &port, const string &queue)
     return true;
 }
 
-sai_status_t DTelOrch::enableQueueReport(const string& port, DTelQueueReportEntry& qreport)
+void DTelOrch::enableQueueReport(const string& port, DTelQueueReportEntry& qreport)
 {
     sai_attribute_t qr_attr;
-    sai_status_t status = SAI_STATUS_SUCCESS;
+
+    qreport.queueReportOid = 0;
 
     if (qreport.queueOid == 0)
     {
-        qreport.queueReportOid = 0;
-        return status;
+        return;
     }
 
+    vector<sai_attribute_t> queue_report_attr(qreport.queue_report_attr);
+
     qr_attr.id = SAI_DTEL_QUEUE_REPORT_ATTR_QUEUE_ID;
     qr_attr.value.oid = qreport.queueOid;
-    qreport.queue_report_attr.push_back(qr_attr);
+    queue_report_attr.push_back(qr_attr);
 
-    status = sai_dtel_api->create_dtel_queue_report(&qreport.queueReportOid,
-                gSwitchId, (uint32_t)qreport.queue_report_attr.size(), qreport.queue_report_attr.data());
+    sai_status_t status = sai_dtel_api->create_dtel_queue_report(&qreport.queueReportOid,
+                gSwitchId, (uint32_t)queue_report_attr.size(), queue_report_attr.data());
     if (status != SAI_STATUS_SUCCESS)
     {
         SWSS_LOG_ERROR("DTEL ERROR: Failed to enable queue report on port %s, queue %d", port.c_str(), qreport.q_ind);
-        return status;
+        qreport.queueReportOid = 0;
     }
-
-    return status;
 }
 
 void DTelOrch::doDtelQueueReportTableTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
 
-    sai_status_t status;
-
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
@@ -1237,11 +1251,7 @@ void DTelOrch::doDtelQueueReportTableTask(Consumer &consumer)
                 qreport->queueOid = 0;
             }
 
-            status = enableQueueReport(port, *qreport);
-            if (status != SAI_STATUS_SUCCESS)
-            {
-                goto queue_report_table_continue;
-            }
+            enableQueueReport(port, *qreport);
         }
         else if (op == DEL_COMMAND)
         {
@@ -158,9 +158,10 @@ private:
     bool disableQueueReport(const string& port, const string& queue);
     bool unConfigureEvent(string& event);
     sai_status_t updateSinkPortList();
+    bool setSinkPort(const string& port_alias, sai_object_id_t port_oid);
     bool addSinkPortToCache(const Port& port);
     bool removeSinkPortFromCache(const string& port_alias);
-    sai_status_t enableQueueReport(const string& port, DTelQueueReportEntry& qreport);
+    void enableQueueReport(const string& port, DTelQueueReportEntry& qreport);
 
     PortsOrch *m_portOrch;
     dTelINTSessionTable_t m_dTelINTSessionTable;
@@ -169,6 +170,7 @@ private:
     dtelEventTable_t m_dtelEventTable;
     sai_object_id_t dtelId;
     dtelSinkPortList_t sinkPortList;
+    vector<sai_object_id_t> sinkPortOids;   // oids of the sink ports present, as programmed
 };
 
 #endif /* SWSS_DTELORCH_H */
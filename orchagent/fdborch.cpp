@@ -37,6 +37,26 @@ FdbOrch::FdbOrch(TableConnector applDbConnector, TableConnector stateDbConnector
     Orch::addExecutor(fdbNotifier);
 }
 
+void FdbOrch::getMemoryStats(MemoryStatsTable &stats)
+{
+    Orch::getMemoryStats(stats);
+
+    stats["FdbOrch:entries"] = containerMemoryStats(m_entries);
+
+    /* Entries saved until their port comes up, accounted one by one */
+    MemoryStats &saved = stats["FdbOrch:saved_entries"];
+    saved = containerMemoryStats(saved_fdb_entries);
+    saved.entries = 0;
+    for (const auto &it : saved_fdb_entries)
+    {
+        saved.entries += it.second.size();
+        for (const auto &entry : it.second)
+        {
+            saved.bytes += heapBytes(entry.type);
+        }
+    }
+}
+
 bool FdbOrch::bake()
 {
     Orch::bake();
@@ -47,17 +47,22 @@ static const vector<sai_router_interface_stat_t> rifStatIds =
 };
 
 IntfsOrch::IntfsOrch(DBConnector *db, string tableName, VRFOrch *vrf_orch) :
-        Orch(db, tableName, intfsorch_pri), m_vrfOrch(vrf_orch)
+        Orch(db, tableName, intfsorch_pri), m_vrfOrch(vrf_orch), m_routeBulker(sai_route_api)
 {
     SWSS_LOG_ENTER();
 
+    addBulker(&m_routeBulker);
+
     /* Initialize DB connectors */ 
     m_counter_db = shared_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
     m_flex_db = shared_ptr<DBConnector>(new DBConnector(FLEX_COUNTER_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
     m_asic_db = shared_ptr<DBConnector>(new DBConnector(ASIC_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    /* Counter map and flex counter updates are buffered and flushed once per batch */
+    m_counter_pipeline = unique_ptr<RedisPipeline>(new RedisPipeline(m_counter_db.get()));
+    m_flex_pipeline = unique_ptr<RedisPipeline>(new RedisPipeline(m_flex_db.get()));
     /* Initialize COUNTER_DB tables */
-    m_rifNameTable = unique_ptr<Table>(new Table(m_counter_db.get(), COUNTERS_RIF_NAME_MAP));
-    m_rifTypeTable = unique_ptr<Table>(new Table(m_counter_db.get(), COUNTERS_RIF_TYPE_MAP));
+    m_rifNameTable = unique_ptr<Table>(new Table(m_counter_pipeline.get(), COUNTERS_RIF_NAME_MAP, true));
+    m_rifTypeTable = unique_ptr<Table>(new Table(m_counter_pipeline.get(), COUNTERS_RIF_TYPE_MAP, true));
 
     m_vidToRidTable = unique_ptr<Table>(new Table(m_asic_db.get(), "VIDTORID"));
     auto intervT = timespec { .tv_sec = UPDATE_MAPS_SEC , .tv_nsec = 0 };
@@ -65,7 +70,7 @@ IntfsOrch::IntfsOrch(DBConnector *db, string tableName, VRFOrch *vrf_orch) :
     auto executorT = new ExecutableTimer(m_updateMapsTimer, this, "UPDATE_MAPS_TIMER");
     Orch::addExecutor(executorT);
     /* Initialize FLEX_COUNTER_DB tables */
-    m_flexCounterTable = unique_ptr<ProducerTable>(new ProducerTable(m_flex_db.get(), FLEX_COUNTER_TABLE));
+    m_flexCounterTable = unique_ptr<ProducerTable>(new ProducerTable(m_flex_pipeline.get(), FLEX_COUNTER_TABLE, true));
     m_flexCounterGroupTable = unique_ptr<ProducerTable>(new ProducerTable(m_flex_db.get(), FLEX_COUNTER_GROUP_TABLE));
 
     vector<FieldValueTuple> fieldValues;
@@ -232,6 +237,9 @@ bool IntfsOrch::removeIntf(const string& alias, sai_object_id_t vrf_id, const Ip
     /* Remove router interface that no IP addresses are associated with */
     if (m_syncdIntfses[alias].ip_addresses.size() == 0)
     {
+        /* The subnet routes must be removed before the router interface */
+        flushRoutes();
+
         if (removeRouterIntfs(port))
         {
             m_syncdIntfses.erase(alias);
@@ -255,6 +263,8 @@ void IntfsOrch::doTask(Consumer &consumer)
         return;
     }
 
+    m_bulkRoutes = true;
+
     auto it = consumer.m_toSync.begin();
     while (it != consumer.m_toSync.end())
     {
@@ -465,6 +475,11 @@ void IntfsOrch::doTask(Consumer &consumer)
             }
         }
     }
+
+    /* Queued routes are programmed by the bulker flush following doTask */
+    m_bulkRoutes = false;
+
+    flushFlexCounterUpdates();
 }
 
 bool IntfsOrch::addRouterIntfs(sai_object_id_t vrf_id, Port &port)
@@ -580,110 +595,136 @@ bool IntfsOrch::removeRouterIntfs(Port &port)
 
 void IntfsOrch::addSubnetRoute(const Port &port, const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = port.m_vr_id;
-    copy(unicast_route_entry.destination, ip_prefix);
-    subnet(unicast_route_entry.destination, unicast_route_entry.destination);
+    IntfsRouteEntry route;
+    route.route_entry.switch_id = gSwitchId;
+    route.route_entry.vr_id = port.m_vr_id;
+    copy(route.route_entry.destination, ip_prefix);
+    subnet(route.route_entry.destination, route.route_entry.destination);
 
     sai_attribute_t attr;
-    vector<sai_attribute_t> attrs;
 
     attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
     attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-    attrs.push_back(attr);
+    route.attrs.push_back(attr);
 
     attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
     attr.value.oid = port.m_rif_id;
-    attrs.push_back(attr);
+    route.attrs.push_back(attr);
 
-    sai_status_t status = sai_route_api->create_route_entry(&unicast_route_entry, (uint32_t)attrs.size(), attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
-    {
-        SWSS_LOG_ERROR("Failed to create subnet route to %s from %s, rv:%d",
-                       ip_prefix.to_string().c_str(), port.m_alias.c_str(), status);
-        throw runtime_error("Failed to create subnet route.");
-    }
+    route.description = "subnet route to " + ip_prefix.to_string() + " from " + port.m_alias;
+    route.ip_prefix = ip_prefix;
+    route.subnet = true;
 
-    SWSS_LOG_NOTICE("Create subnet route to %s from %s",
-                    ip_prefix.to_string().c_str(), port.m_alias.c_str());
     increaseRouterIntfsRefCount(port.m_alias);
-
-    if (unicast_route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
-    {
-        gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
-    }
-    else
-    {
-        gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
-    }
-
-    gRouteOrch->notifyNextHopChangeObservers(ip_prefix, IpAddresses(), true);
+    queueRoute(true, route);
 }
 
 void IntfsOrch::removeSubnetRoute(const Port &port, const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = port.m_vr_id;
-    copy(unicast_route_entry.destination, ip_prefix);
-    subnet(unicast_route_entry.destination, unicast_route_entry.destination);
+    IntfsRouteEntry route;
+    route.route_entry.switch_id = gSwitchId;
+    route.route_entry.vr_id = port.m_vr_id;
+    copy(route.route_entry.destination, ip_prefix);
+    subnet(route.route_entry.destination, route.route_entry.destination);
 
-    sai_status_t status = sai_route_api->remove_route_entry(&unicast_route_entry);
-    if (status != SAI_STATUS_SUCCESS)
-    {
-        SWSS_LOG_ERROR("Failed to remove subnet route to %s from %s, rv:%d",
-                       ip_prefix.to_string().c_str(), port.m_alias.c_str(), status);
-        throw runtime_error("Failed to remove subnet route.");
-    }
+    route.description = "subnet route to " + ip_prefix.to_string() + " from " + port.m_alias;
+    route.ip_prefix = ip_prefix;
+    route.subnet = true;
 
-    SWSS_LOG_NOTICE("Remove subnet route to %s from %s",
-                    ip_prefix.to_string().c_str(), port.m_alias.c_str());
     decreaseRouterIntfsRefCount(port.m_alias);
-
-    if (unicast_route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
-    {
-        gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
-    }
-    else
-    {
-        gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
-    }
-
-    gRouteOrch->notifyNextHopChangeObservers(ip_prefix, IpAddresses(), false);
+    queueRoute(false, route);
 }
 
 void IntfsOrch::addIp2MeRoute(sai_object_id_t vrf_id, const IpPrefix &ip_prefix)
 {
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = vrf_id;
-    copy(unicast_route_entry.destination, ip_prefix.getIp());
+    IntfsRouteEntry route;
+    route.route_entry.switch_id = gSwitchId;
+    route.route_entry.vr_id = vrf_id;
+    copy(route.route_entry.destination, ip_prefix.getIp());
 
     sai_attribute_t attr;
-    vector<sai_attribute_t> attrs;
 
     attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
     attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
-    attrs.push_back(attr);
+    route.attrs.push_back(attr);
 
     Port cpu_port;
     gPortsOrch->getCpuPort(cpu_port);
 
     attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
     attr.value.oid = cpu_port.m_port_id;
-    attrs.push_back(attr);
+    route.attrs.push_back(attr);
 
-    sai_status_t status = sai_route_api->create_route_entry(&unicast_route_entry, (uint32_t)attrs.size(), attrs.data());
-    if (status != SAI_STATUS_SUCCESS)
+    route.description = "IP2me route ip:" + ip_prefix.getIp().to_string();
+    route.ip_prefix = ip_prefix;
+    route.subnet = false;
+
+    queueRoute(true, route);
+}
+
+void IntfsOrch::removeIp2MeRoute(sai_object_id_t vrf_id, const IpPrefix &ip_prefix)
+{
+    IntfsRouteEntry route;
+    route.route_entry.switch_id = gSwitchId;
+    route.route_entry.vr_id = vrf_id;
+    copy(route.route_entry.destination, ip_prefix.getIp());
+
+    route.description = "IP2me route ip:" + ip_prefix.getIp().to_string();
+    route.ip_prefix = ip_prefix;
+    route.subnet = false;
+
+    queueRoute(false, route);
+}
+
+/*
+ * Queue a route to be programmed in bulk once the doTask pass is over.
+ * Outside of doTask the route is programmed right away.
+ */
+void IntfsOrch::queueRoute(bool create, IntfsRouteEntry &route)
+{
+    if (create)
+    {
+        m_routeBulker.create(route.route_entry, route.attrs,
+                [this, route](sai_status_t status)
+                {
+                    if (status != SAI_STATUS_SUCCESS)
+                    {
+                        SWSS_LOG_ERROR("Failed to create %s, rv:%d", route.description.c_str(), status);
+                        throw runtime_error("Failed to create route.");
+                    }
+                    onRouteCreated(route);
+                });
+    }
+    else
+    {
+        m_routeBulker.remove(route.route_entry,
+                [this, route](sai_status_t status)
+                {
+                    if (status != SAI_STATUS_SUCCESS)
+                    {
+                        SWSS_LOG_ERROR("Failed to remove %s, rv:%d", route.description.c_str(), status);
+                        throw runtime_error("Failed to remove route.");
+                    }
+                    onRouteRemoved(route);
+                });
+    }
+
+    if (!m_bulkRoutes)
     {
-        SWSS_LOG_ERROR("Failed to create IP2me route ip:%s, rv:%d", ip_prefix.getIp().to_string().c_str(), status);
-        throw runtime_error("Failed to create IP2me route.");
+        flushRoutes();
     }
+}
 
-    SWSS_LOG_NOTICE("Create IP2me route ip:%s", ip_prefix.getIp().to_string().c_str());
+void IntfsOrch::flushRoutes()
+{
+    m_routeBulker.flush();
+}
+
+void IntfsOrch::onRouteCreated(const IntfsRouteEntry &route)
+{
+    SWSS_LOG_NOTICE("Create %s", route.description.c_str());
 
-    if (unicast_route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    if (route.route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
     {
         gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
     }
@@ -691,25 +732,18 @@ void IntfsOrch::addIp2MeRoute(sai_object_id_t vrf_id, const IpPrefix &ip_prefix)
     {
         gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
     }
-}
 
-void IntfsOrch::removeIp2MeRoute(sai_object_id_t vrf_id, const IpPrefix &ip_prefix)
-{
-    sai_route_entry_t unicast_route_entry;
-    unicast_route_entry.switch_id = gSwitchId;
-    unicast_route_entry.vr_id = vrf_id;
-    copy(unicast_route_entry.destination, ip_prefix.getIp());
-
-    sai_status_t status = sai_route_api->remove_route_entry(&unicast_route_entry);
-    if (status != SAI_STATUS_SUCCESS)
+    if (route.subnet)
     {
-        SWSS_LOG_ERROR("Failed to remove IP2me route ip:%s, rv:%d", ip_prefix.getIp().to_string().c_str(), status);
-        throw runtime_error("Failed to remove IP2me route.");
+        gRouteOrch->notifyNextHopChangeObservers(route.ip_prefix, IpAddresses(), true);
     }
+}
 
-    SWSS_LOG_NOTICE("Remove packet action trap route ip:%s", ip_prefix.getIp().to_string().c_str());
+void IntfsOrch::onRouteRemoved(const IntfsRouteEntry &route)
+{
+    SWSS_LOG_NOTICE("Remove %s", route.description.c_str());
 
-    if (unicast_route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    if (route.route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
     {
         gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
     }
@@ -717,6 +751,11 @@ void IntfsOrch::removeIp2MeRoute(sai_object_id_t vrf_id, const IpPrefix &ip_pref
     {
         gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
     }
+
+    if (route.subnet)
+    {
+        gRouteOrch->notifyNextHopChangeObservers(route.ip_prefix, IpAddresses(), false);
+    }
 }
 
 void IntfsOrch::addDirectedBroadcast(const Port &port, const IpPrefix &ip_prefix)
@@ -836,6 +875,12 @@ void IntfsOrch::removeRifFromFlexCounter(const string &id, const string &name)
     SWSS_LOG_DEBUG("Unregistered interface %s from Flex counter", name.c_str());
 }
 
+void IntfsOrch::flushFlexCounterUpdates()
+{
+    m_counter_pipeline->flush();
+    m_flex_pipeline->flush();
+}
+
 string IntfsOrch::getRifFlexCounterTableKey(string key)
 {
     return string(RIF_STAT_COUNTER_FLEX_COUNTER_GROUP) + ":" + key;
@@ -882,4 +927,6 @@ void IntfsOrch::doTask(SelectableTimer &timer)
             ++it;
         }
     }
+
+    flushFlexCounterUpdates();
 }
@@ -5,6 +5,8 @@
 #include "portsorch.h"
 #include "vrforch.h"
 #include "timer.h"
+#include "redispipeline.h"
+#include "bulker.h"
 
 #include "ipaddresses.h"
 #include "ipprefix.h"
@@ -26,6 +28,16 @@ struct IntfsEntry
 
 typedef map<string, IntfsEntry> IntfsTable;
 
+/* Subnet or IP2me route waiting to be programmed in bulk */
+struct IntfsRouteEntry
+{
+    sai_route_entry_t           route_entry;
+    vector<sai_attribute_t>     attrs;
+    string                      description;    // route description for logs
+    IpPrefix                    ip_prefix;      // prefix of the subnet route
+    bool                        subnet;         // true for a subnet route
+};
+
 class IntfsOrch : public Orch
 {
 public:
@@ -65,9 +77,15 @@ private:
     void doTask(Consumer &consumer);
     void doTask(SelectableTimer &timer);
 
+    /* Routes are queued and programmed in bulk while processing the consumer */
+    bool m_bulkRoutes = false;
+    EntityBulker<sai_route_api_t> m_routeBulker;
+
     shared_ptr<DBConnector> m_counter_db;
     shared_ptr<DBConnector> m_flex_db;
     shared_ptr<DBConnector> m_asic_db;
+    unique_ptr<RedisPipeline> m_counter_pipeline;
+    unique_ptr<RedisPipeline> m_flex_pipeline;
     unique_ptr<Table> m_rifNameTable;
     unique_ptr<Table> m_rifTypeTable;
     unique_ptr<Table> m_vidToRidTable;
@@ -86,6 +104,13 @@ private:
 
     void addDirectedBroadcast(const Port &port, const IpPrefix &ip_prefix);
     void removeDirectedBroadcast(const Port &port, const IpPrefix &ip_prefix);
+
+    void queueRoute(bool create, IntfsRouteEntry &route);
+    void flushRoutes();
+    void onRouteCreated(const IntfsRouteEntry &route);
+    void onRouteRemoved(const IntfsRouteEntry &route);
+
+    void flushFlexCounterUpdates();
 };
 
 #endif /* SWSS_INTFSORCH_H */
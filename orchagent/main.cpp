@@ -43,6 +43,10 @@ MacAddress gVxlanMacAddress;
 #define DEFAULT_BATCH_SIZE  128
 int gBatchSize = DEFAULT_BATCH_SIZE;
 
+/* Number of buckets of resilient next hop groups, 0 to use regular ECMP */
+#define MAX_RESILIENT_ECMP_BUCKETS  4096
+int gResilientEcmpBuckets = 0;
+
 bool gSairedisRecord = true;
 bool gSwssRecord = true;
 bool gLogRotate = false;
@@ -51,7 +55,7 @@ string gRecordFile;
 
 void usage()
 {
-    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-b batch_size] [-m MAC]" << endl;
+    cout << "usage: orchagent [-h] [-r record_type] [-d record_location] [-b batch_size] [-m MAC] [-e ecmp_buckets]" << endl;
     cout << "    -h: display this message" << endl;
     cout << "    -r record_type: record orchagent logs with type (default 3)" << endl;
     cout << "                    0: do not record logs" << endl;
@@ -61,6 +65,10 @@ void usage()
     cout << "    -d record_location: set record logs folder location (default .)" << endl;
     cout << "    -b batch_size: set consumer table pop operation batch size (default 128)" << endl;
     cout << "    -m MAC: set switch MAC address" << endl;
+    cout << "    -e ecmp_buckets: emulate resilient next hop groups with a fixed number of buckets, up to " << MAX_RESILIENT_ECMP_BUCKETS << endl;
+    cout << "                     (default 0, disabled). Each bucket is a group member, so next hops are repeated" << endl;
+    cout << "                     as members. Whether flows stay on their bucket when a member changes depends on" << endl;
+    cout << "                     the ASIC hashing, this is not native resilient hashing." << endl;
 }
 
 void sighup_handler(int signo)
@@ -117,7 +125,7 @@ int main(int argc, char **argv)
 
     string record_location = ".";
 
-    while ((opt = getopt(argc, argv, "b:m:r:d:h")) != -1)
+    while ((opt = getopt(argc, argv, "b:m:r:d:e:h")) != -1)
     {
         switch (opt)
         {
@@ -127,6 +135,19 @@ int main(int argc, char **argv)
         case 'm':
             gMacAddress = MacAddress(optarg);
             break;
+        case 'e':
+        {
+            char *end;
+            long buckets = strtol(optarg, &end, 10);
+            if (*optarg == '\0' || *end != '\0' || buckets < 0 || buckets > MAX_RESILIENT_ECMP_BUCKETS)
+            {
+                SWSS_LOG_ERROR("Invalid number of ECMP buckets %s", optarg);
+                usage();
+                exit(EXIT_FAILURE);
+            }
+            gResilientEcmpBuckets = (int)buckets;
+            break;
+        }
         case 'r':
             if (!strcmp(optarg, "0"))
             {
@@ -0,0 +1,177 @@
+#pragma once
+
+/*
+ * Memory accounting of the orchagent tables. Each orch reports the number of
+ * entries of its major structures and an estimate of the memory they use,
+ * computed from the sizes of the keys and values and the overhead of the
+ * container nodes. The estimates are computed on demand by walking the
+ * structures, the containers themselves are left untouched.
+ */
+
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+#include "ipaddresses.h"
+
+struct MemoryStats
+{
+    uint64_t entries = 0;           // number of entries of the structure
+    uint64_t bytes = 0;             // estimated memory used by the structure
+
+    void add(uint64_t count, uint64_t size)
+    {
+        entries += count;
+        bytes += size;
+    }
+};
+
+/* MemoryStatsTable: structure name, memory used by the structure */
+typedef std::map<std::string, MemoryStats> MemoryStatsTable;
+
+/* Allocation overhead of the container nodes beside the value they hold */
+#define MEMORY_TREE_NODE_OVERHEAD   32      // color and parent, left and right pointers
+#define MEMORY_HASH_NODE_OVERHEAD   16      // next pointer and cached hash
+#define MEMORY_LIST_NODE_OVERHEAD   16      // previous and next pointers
+#define MEMORY_SHARED_OVERHEAD      16      // use and weak counts of a shared value
+#define MEMORY_STRING_SSO_CAPACITY  15      // strings up to this size are stored inline
+
+/*
+ * Memory allocated by a value beyond its own size, e.g. the characters of a
+ * string or the nodes of a container. The overloads are declared first, so
+ * that the container templates find them for their elements.
+ */
+inline uint64_t heapBytes(const std::string &s);
+inline uint64_t heapBytes(const swss::IpAddresses &ips);
+template <typename T> inline uint64_t heapBytes(const T &);
+template <typename K, typename V> inline uint64_t heapBytes(const std::pair<K, V> &p);
+template <typename A, typename B, typename C> inline uint64_t heapBytes(const std::tuple<A, B, C> &t);
+template <typename T> inline uint64_t heapBytes(const std::shared_ptr<T> &p);
+template <typename T> inline uint64_t heapBytes(const std::vector<T> &v);
+template <typename T> inline uint64_t heapBytes(const std::list<T> &l);
+template <typename T> inline uint64_t heapBytes(const std::set<T> &s);
+template <typename K, typename V> inline uint64_t heapBytes(const std::map<K, V> &m);
+template <typename K, typename V> inline uint64_t heapBytes(const std::multimap<K, V> &m);
+template <typename K, typename V> inline uint64_t heapBytes(const std::unordered_map<K, V> &m);
+
+inline uint64_t heapBytes(const std::string &s)
+{
+    return s.capacity() > MEMORY_STRING_SSO_CAPACITY ? s.capacity() + 1 : 0;
+}
+
+/* IpAddresses only holds a set of addresses, which do not allocate */
+inline uint64_t heapBytes(const swss::IpAddresses &ips)
+{
+    return ips.getSize() * (sizeof(swss::IpAddress) + MEMORY_TREE_NODE_OVERHEAD);
+}
+
+/* Values which do not allocate: integers, oids, addresses, plain structs */
+template <typename T>
+inline uint64_t heapBytes(const T &)
+{
+    return 0;
+}
+
+template <typename K, typename V>
+inline uint64_t heapBytes(const std::pair<K, V> &p)
+{
+    return heapBytes(p.first) + heapBytes(p.second);
+}
+
+/* Tuples of three, e.g. the KeyOpFieldsValuesTuple of the pending tasks */
+template <typename A, typename B, typename C>
+inline uint64_t heapBytes(const std::tuple<A, B, C> &t)
+{
+    return heapBytes(std::get<0>(t)) + heapBytes(std::get<1>(t)) + heapBytes(std::get<2>(t));
+}
+
+/* Shared values are accounted once per owner, without their derived part */
+template <typename T>
+inline uint64_t heapBytes(const std::shared_ptr<T> &p)
+{
+    return p ? sizeof(T) + MEMORY_SHARED_OVERHEAD + heapBytes(*p) : 0;
+}
+
+template <typename T>
+inline uint64_t heapBytes(const std::vector<T> &v)
+{
+    uint64_t bytes = v.capacity() * sizeof(T);
+    for (const auto &e : v)
+    {
+        bytes += heapBytes(e);
+    }
+    return bytes;
+}
+
+template <typename T>
+inline uint64_t heapBytes(const std::list<T> &l)
+{
+    uint64_t bytes = l.size() * (sizeof(T) + MEMORY_LIST_NODE_OVERHEAD);
+    for (const auto &e : l)
+    {
+        bytes += heapBytes(e);
+    }
+    return bytes;
+}
+
+template <typename T>
+inline uint64_t heapBytes(const std::set<T> &s)
+{
+    uint64_t bytes = s.size() * (sizeof(T) + MEMORY_TREE_NODE_OVERHEAD);
+    for (const auto &e : s)
+    {
+        bytes += heapBytes(e);
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+inline uint64_t heapBytes(const std::map<K, V> &m)
+{
+    uint64_t bytes = m.size() * (sizeof(std::pair<const K, V>) + MEMORY_TREE_NODE_OVERHEAD);
+    for (const auto &e : m)
+    {
+        bytes += heapBytes(e.first) + heapBytes(e.second);
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+inline uint64_t heapBytes(const std::multimap<K, V> &m)
+{
+    uint64_t bytes = m.size() * (sizeof(std::pair<const K, V>) + MEMORY_TREE_NODE_OVERHEAD);
+    for (const auto &e : m)
+    {
+        bytes += heapBytes(e.first) + heapBytes(e.second);
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+inline uint64_t heapBytes(const std::unordered_map<K, V> &m)
+{
+    uint64_t bytes = m.size() * (sizeof(std::pair<const K, V>) + MEMORY_HASH_NODE_OVERHEAD) +
+                     m.bucket_count() * sizeof(void *);
+    for (const auto &e : m)
+    {
+        bytes += heapBytes(e.first) + heapBytes(e.second);
+    }
+    return bytes;
+}
+
+/* Entries of a container and the memory it uses, including its own size */
+template <typename C>
+inline MemoryStats containerMemoryStats(const C &container)
+{
+    MemoryStats stats;
+    stats.entries = container.size();
+    stats.bytes = sizeof(C) + heapBytes(container);
+    return stats;
+}
@@ -175,6 +175,14 @@ bool NeighOrch::isNextHopFlagSet(const IpAddress &ipaddr, const uint32_t nh_flag
     return false;
 }
 
+void NeighOrch::getMemoryStats(MemoryStatsTable &stats)
+{
+    Orch::getMemoryStats(stats);
+
+    stats["NeighOrch:syncd_neighbors"] = containerMemoryStats(m_syncdNeighbors);
+    stats["NeighOrch:syncd_next_hops"] = containerMemoryStats(m_syncdNextHops);
+}
+
 bool NeighOrch::ifChangeInformNextHop(const string &alias, bool if_up)
 {
     SWSS_LOG_ENTER();
@@ -69,6 +69,8 @@ public:
     bool ifChangeInformNextHop(const string &, bool);
     bool isNextHopFlagSet(const IpAddress &, const uint32_t);
 
+    void getMemoryStats(MemoryStatsTable &stats) override;
+
 private:
     IntfsOrch *m_intfsOrch;
 
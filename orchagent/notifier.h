@@ -14,6 +14,7 @@ public:
 
     void execute()
     {
+        ExecutorProfileScope profile(m_stats);
         m_orch->doTask(*getNotificationConsumer());
     }
 };
@@ -1,14 +1,19 @@
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <unordered_set>
 #include <sys/time.h>
 #include "timestamp.h"
 #include "orch.h"
+#include "bulker.h"
 
 #include "subscriberstatetable.h"
 #include "portsorch.h"
 #include "tokenize.h"
 #include "logger.h"
 #include "consumerstatetable.h"
+#include "redisreply.h"
+#include "redisapi.h"
 
 using namespace swss;
 
@@ -76,11 +81,23 @@ size_t Consumer::addToSync(std::deque<KeyOpFieldsValuesTuple> &entries)
         return 0;
     }
 
+    if (m_toSync.empty())
+    {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+
     for (auto& entry: entries)
     {
         string key = kfvKey(entry);
         string op  = kfvOp(entry);
 
+        m_stats.popped_tasks++;
+        m_stats.popped_bytes += key.size() + op.size();
+        for (const auto &fv : kfvFieldsValues(entry))
+        {
+            m_stats.popped_bytes += fvField(fv).size() + fvValue(fv).size();
+        }
+
         /* Record incoming tasks */
         if (gSwssRecord)
         {
@@ -123,6 +140,123 @@ size_t Consumer::addToSync(std::deque<KeyOpFieldsValuesTuple> &entries)
     return entries.size();
 }
 
+/* Number of keys asked to SCAN, and read by each table_dump.lua call */
+#define TABLE_DUMP_BATCH_SIZE 1000
+
+/* SHA of table_dump.lua, loaded once and shared by the prefetch threads */
+static string getTableDumpSha(DBConnector *db)
+{
+    static std::mutex mutex;
+    static string sha;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sha.empty())
+    {
+        string script = swss::loadLuaScript("table_dump.lua");
+        sha = swss::loadRedisScript(db, script);
+    }
+
+    return sha;
+}
+
+/* Read the fields of a batch of keys of a table through table_dump.lua */
+static void readTableKeys(DBConnector *db, const string &sha, const string &prefix,
+        const vector<string> &keys, std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    string key_count = to_string(keys.size());
+    string prefix_len = to_string(prefix.size());
+
+    vector<const char *> argv = { "EVALSHA", sha.c_str(), key_count.c_str() };
+    vector<size_t> argvlen = { 7, sha.size(), key_count.size() };
+    for (const auto &key : keys)
+    {
+        argv.push_back(key.c_str());
+        argvlen.push_back(key.size());
+    }
+    argv.push_back(prefix_len.c_str());
+    argvlen.push_back(prefix_len.size());
+
+    RedisCommand command;
+    command.formatArgv((int)argv.size(), argv.data(), argvlen.data());
+    RedisReply r(db, command, REDIS_REPLY_ARRAY);
+    redisReply *reply = r.getContext();
+
+    size_t i = 0;
+    while (i + 1 < reply->elements)
+    {
+        KeyOpFieldsValuesTuple kco;
+        kfvKey(kco) = string(reply->element[i]->str, reply->element[i]->len);
+        kfvOp(kco) = SET_COMMAND;
+
+        size_t count = (size_t)reply->element[i + 1]->integer;
+        i += 2;
+        for (size_t j = 0; j + 1 < count && i + 1 < reply->elements; j += 2, i += 2)
+        {
+            kfvFieldsValues(kco).emplace_back(
+                    string(reply->element[i]->str, reply->element[i]->len),
+                    string(reply->element[i + 1]->str, reply->element[i + 1]->len));
+        }
+
+        entries.push_back(kco);
+    }
+}
+
+/*
+ * Read all the entries of a table. The keys are listed with SCAN and their
+ * fields read in batches by table_dump.lua, so that redis is never blocked
+ * for the whole table. Return false if the table could not be read that
+ * way, e.g. when the script is not installed.
+ */
+static bool readTable(DBConnector *db, const string &tableName, const string &separator,
+        std::deque<KeyOpFieldsValuesTuple> &entries)
+{
+    SWSS_LOG_ENTER();
+
+    string prefix = tableName + separator;
+
+    try
+    {
+        string sha = getTableDumpSha(db);
+
+        /* SCAN may return a key more than once */
+        unordered_set<string> scanned;
+        string cursor = "0";
+        do
+        {
+            RedisCommand command;
+            command.format("SCAN %s MATCH %s* COUNT %d", cursor.c_str(), prefix.c_str(), TABLE_DUMP_BATCH_SIZE);
+            RedisReply r(db, command, REDIS_REPLY_ARRAY);
+            redisReply *reply = r.getContext();
+
+            cursor = string(reply->element[0]->str, reply->element[0]->len);
+
+            vector<string> keys;
+            redisReply *keys_reply = reply->element[1];
+            for (size_t i = 0; i < keys_reply->elements; i++)
+            {
+                string key(keys_reply->element[i]->str, keys_reply->element[i]->len);
+                if (scanned.insert(key).second)
+                {
+                    keys.push_back(key);
+                }
+            }
+
+            if (!keys.empty())
+            {
+                readTableKeys(db, sha, prefix, keys, entries);
+            }
+        } while (cursor != "0");
+    }
+    catch (const std::exception &e)
+    {
+        SWSS_LOG_WARN("Failed to read table %s in bulk: %s", tableName.c_str(), e.what());
+        entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
 // TODO: Table should be const
 size_t Consumer::refillToSync(Table* table)
 {
@@ -146,6 +280,32 @@ size_t Consumer::refillToSync(Table* table)
     return addToSync(entries);
 }
 
+void Consumer::prefetchToSync(DBConnector *db)
+{
+    ConsumerTableBase *consumerTable = getConsumerTable();
+
+    /* Subscriber tables are refilled from their own subscription */
+    if (dynamic_cast<SubscriberStateTable *>(consumerTable) != NULL)
+    {
+        return;
+    }
+
+    m_prefetchedEntries.clear();
+    m_prefetched = readTable(db, consumerTable->getTableName(),
+            consumerTable->getTableNameSeparator(), m_prefetchedEntries);
+}
+
+void Consumer::dropPrefetched()
+{
+    if (m_prefetched)
+    {
+        SWSS_LOG_NOTICE("Drop %zu prefetched entries of %s", m_prefetchedEntries.size(), getName().c_str());
+    }
+
+    std::deque<KeyOpFieldsValuesTuple>().swap(m_prefetchedEntries);
+    m_prefetched = false;
+}
+
 size_t Consumer::refillToSync()
 {
     ConsumerTableBase *consumerTable = getConsumerTable();
@@ -157,11 +317,25 @@ size_t Consumer::refillToSync()
         subTable->pops(entries);
         return addToSync(entries);
     }
+    else if (m_prefetched)
+    {
+        std::deque<KeyOpFieldsValuesTuple> entries;
+        entries.swap(m_prefetchedEntries);
+        m_prefetched = false;
+        return addToSync(entries);
+    }
     else
     {
         // consumerTable is either ConsumerStateTable or ConsumerTable
         auto db = consumerTable->getDbConnector();
         string tableName = consumerTable->getTableName();
+
+        std::deque<KeyOpFieldsValuesTuple> entries;
+        if (readTable(db, tableName, consumerTable->getTableNameSeparator(), entries))
+        {
+            return addToSync(entries);
+        }
+
         auto table = Table(db, tableName);
         return refillToSync(&table);
     }
@@ -182,7 +356,39 @@ void Consumer::execute()
 void Consumer::drain()
 {
     if (!m_toSync.empty())
+    {
+        ExecutorProfileScope profile(m_stats);
+
+        size_t pending = m_toSync.size();
         m_orch->doTask(*this);
+        if (m_toSync.size() < pending)
+        {
+            m_stats.completed_tasks += pending - m_toSync.size();
+        }
+        m_stats.retried_tasks += m_toSync.size();
+        /* Program the SAI operations queued while processing the tasks */
+        m_orch->flushBulkers();
+    }
+}
+
+void Consumer::retry(const KeyOpFieldsValuesTuple &entry)
+{
+    SWSS_LOG_ENTER();
+
+    /* A newer task for the same key supersedes the failed one */
+    string key = kfvKey(entry);
+    if (m_toSync.find(key) != m_toSync.end())
+    {
+        SWSS_LOG_INFO("Drop retry of %s, superseded by a pending task", key.c_str());
+        return;
+    }
+
+    if (m_toSync.empty())
+    {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+
+    m_toSync[key] = entry;
 }
 
 string Consumer::dumpTuple(KeyOpFieldsValuesTuple &tuple)
@@ -209,6 +415,39 @@ void Consumer::dumpPendingTasks(vector<string> &ts)
     }
 }
 
+void Consumer::getPendingTaskSummary(PendingTaskSummary &summary, size_t max_samples)
+{
+    summary.table = getTableName();
+    summary.set_count = 0;
+    summary.del_count = 0;
+    summary.age_msecs = 0;
+    summary.sample_keys.clear();
+
+    if (m_toSync.empty())
+    {
+        return;
+    }
+
+    for (auto &tm : m_toSync)
+    {
+        if (kfvOp(tm.second) == DEL_COMMAND)
+        {
+            summary.del_count++;
+        }
+        else
+        {
+            summary.set_count++;
+        }
+
+        if (summary.sample_keys.size() < max_samples)
+        {
+            summary.sample_keys.push_back(tm.first);
+        }
+    }
+
+    summary.age_msecs = elapsedUsecs(m_pendingSince) / 1000;
+}
+
 size_t Orch::addExistingData(const string& tableName)
 {
     auto consumer = dynamic_cast<Consumer *>(getExecutor(tableName));
@@ -385,6 +624,22 @@ void Orch::dumpPendingTasks(vector<string> &ts)
     }
 }
 
+void Orch::getPendingTaskSummary(vector<PendingTaskSummary> &summaries, size_t max_samples)
+{
+    for (auto &it : m_consumerMap)
+    {
+        Consumer* consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer == NULL || consumer->m_toSync.empty())
+        {
+            continue;
+        }
+
+        PendingTaskSummary summary;
+        consumer->getPendingTaskSummary(summary, max_samples);
+        summaries.push_back(summary);
+    }
+}
+
 void Orch::logfileReopen()
 {
     gRecordOfs.close();
@@ -541,6 +796,77 @@ Executor *Orch::getExecutor(string executorName)
     return NULL;
 }
 
+void Orch::getTaskCounters(uint64_t &completed, uint64_t &bytes)
+{
+    for (auto &it : m_consumerMap)
+    {
+        auto consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer == NULL)
+        {
+            continue;
+        }
+
+        completed += consumer->getStats().completed_tasks;
+        bytes += consumer->getStats().popped_bytes;
+    }
+}
+
+void Orch::getConsumers(vector<Consumer *> &consumers)
+{
+    for (auto &it : m_consumerMap)
+    {
+        auto consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer != NULL)
+        {
+            consumers.push_back(consumer);
+        }
+    }
+}
+
+void Orch::getExecutors(vector<Executor *> &executors)
+{
+    for (auto &it : m_consumerMap)
+    {
+        executors.push_back(it.second.get());
+    }
+}
+
+void Orch::getExecutorStats(map<string, ExecutorStats> &stats)
+{
+    for (auto &it : m_consumerMap)
+    {
+        stats[it.first] = it.second->getStats();
+    }
+}
+
+void Orch::getMemoryStats(MemoryStatsTable &stats)
+{
+    for (auto &it : m_consumerMap)
+    {
+        Consumer* consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer == NULL)
+        {
+            continue;
+        }
+
+        MemoryStats pending = containerMemoryStats(consumer->m_toSync);
+        stats[it.first + ":pending_tasks"].add(pending.entries, pending.bytes);
+    }
+}
+
+void Orch::addBulker(BulkerBase* bulker)
+{
+    m_bulkers.push_back(bulker);
+}
+
+void Orch::flushBulkers()
+{
+    for (auto bulker : m_bulkers)
+    {
+        bulker->flush();
+    }
+}
+
 void Orch2::doTask(Consumer &consumer)
 {
     SWSS_LOG_ENTER();
@@ -19,6 +19,8 @@ extern "C" {
 #include "notificationconsumer.h"
 #include "selectabletimer.h"
 #include "macaddress.h"
+#include "profiler.h"
+#include "memorystats.h"
 
 using namespace std;
 using namespace swss;
@@ -62,6 +64,17 @@ typedef map<string, KeyOpFieldsValuesTuple> SyncMap;
 typedef pair<string, int> table_name_with_pri_t;
 
 class Orch;
+class BulkerBase;
+
+/* Summary of the tasks pending in a consumer */
+struct PendingTaskSummary
+{
+    string              table;          // table name of the consumer
+    size_t              set_count;      // number of pending SET tasks
+    size_t              del_count;      // number of pending DEL tasks
+    uint64_t            age_msecs;      // time since the consumer started having pending tasks
+    vector<string>      sample_keys;    // keys of the first pending tasks
+};
 
 // Design assumption
 // 1. one Orch can have one or more Executor
@@ -99,6 +112,11 @@ public:
         return m_name;
     }
 
+    const ExecutorStats &getStats() const
+    {
+        return m_stats;
+    }
+
 protected:
     Selectable *m_selectable;
     Orch *m_orch;
@@ -106,6 +124,9 @@ protected:
     // Name for Executor
     string m_name;
 
+    // Profiling counters
+    ExecutorStats m_stats;
+
     // Get the underlying selectable
     Selectable *getSelectable() const { return m_selectable; }
 };
@@ -134,12 +155,21 @@ public:
 
     string dumpTuple(KeyOpFieldsValuesTuple &tuple);
     void dumpPendingTasks(vector<string> &ts);
+    void getPendingTaskSummary(PendingTaskSummary &summary, size_t max_samples);
 
     size_t refillToSync();
     size_t refillToSync(Table* table);
+    /* Read the table of the consumer through db, for the next refillToSync.
+     * May run on a worker thread, db being owned by that thread. */
+    void prefetchToSync(DBConnector *db);
+    /* Release the table content prefetched but not refilled from */
+    void dropPrefetched();
     void execute();
     void drain();
 
+    /* Requeue a task to be processed again, unless a newer one is pending */
+    void retry(const KeyOpFieldsValuesTuple &entry);
+
     /* Store the latest 'golden' status */
     // TODO: hide?
     SyncMap m_toSync;
@@ -147,6 +177,13 @@ public:
 protected:
     // Returns: the number of entries added to m_toSync
     size_t addToSync(std::deque<KeyOpFieldsValuesTuple> &entries);
+
+    // Time at which m_toSync last went from empty to non-empty
+    std::chrono::steady_clock::time_point m_pendingSince;
+
+    // Table content read by prefetchToSync
+    bool m_prefetched = false;
+    std::deque<KeyOpFieldsValuesTuple> m_prefetchedEntries;
 };
 
 typedef map<string, std::shared_ptr<Executor>> ConsumerMap;
@@ -195,6 +232,22 @@ public:
     static void recordTuple(Consumer &consumer, KeyOpFieldsValuesTuple &tuple);
 
     void dumpPendingTasks(vector<string> &ts);
+    /* Summarize the pending tasks of the consumers having some */
+    void getPendingTaskSummary(vector<PendingTaskSummary> &summaries, size_t max_samples);
+
+    /* Add the task counters of all consumers of this orch to the arguments */
+    void getTaskCounters(uint64_t &completed, uint64_t &bytes);
+    /* Collect the profiling counters of all executors of this orch */
+    void getExecutorStats(map<string, ExecutorStats> &stats);
+    /* Account the memory used by the structures of this orch, by default
+     * the pending tasks of its consumers */
+    virtual void getMemoryStats(MemoryStatsTable &stats);
+    /* Collect the consumers of this orch */
+    void getConsumers(vector<Consumer *> &consumers);
+    void getExecutors(vector<Executor *> &executors);
+
+    /* Flush the SAI operations queued in the bulkers of this orch */
+    void flushBulkers();
 protected:
     ConsumerMap m_consumerMap;
 
@@ -208,7 +261,12 @@ protected:
     /* Note: consumer will be owned by this class */
     void addExecutor(Executor* executor);
     Executor *getExecutor(string executorName);
+
+    /* Note: bulker is not owned by this class */
+    void addBulker(BulkerBase* bulker);
 private:
+    vector<BulkerBase*> m_bulkers;
+
     void addConsumer(DBConnector *db, string tableName, int pri = default_orch_pri);
 };
 
@@ -19,6 +19,8 @@ void printUsage()
     std::cout << "        Don't freeze orchagent even if check succeeded" << std::endl;
     std::cout << "    -s --skipPendingTaskCheck" << std::endl;
     std::cout << "        Skip pending task dependency check for orchagent" << std::endl;
+    std::cout << "    -d --dumpPendingTasks" << std::endl;
+    std::cout << "        Have orchagent log every pending task, not only the per table summary" << std::endl;
     std::cout << "    -w --waitTime" << std::endl;
     std::cout << "        Wait time for response from orchagent, in milliseconds. Default value: 1000" << std::endl;
     std::cout << "    -h --help:" << std::endl;
@@ -38,6 +40,8 @@ void printUsage()
  *            if --noFreeze option is provided, orchagent won't freeze.
  *            if --skipPendingTaskCheck option is provided, orchagent won't use
  *                 whether there is pending task existing as state check criterion.
+ *            if --dumpPendingTasks option is provided, orchagent logs every pending
+ *                 task in addition to the per table summary it replies with.
  */
 int main(int argc, char **argv)
 {
@@ -46,16 +50,18 @@ int main(int argc, char **argv)
 
     std::string skipPendingTaskCheck = "fasle";
     std::string noFreeze            = "fasle";
+    std::string dumpPendingTasks    = "false";
     /* Default wait time is 1000 millisecond */
     int waitTime = 1000;
 
-    const char* const optstring = "nsw:";
+    const char* const optstring = "nsdw:";
     while(true)
     {
         static struct option long_options[] =
         {
             { "noFreeze",                no_argument,       0, 'n' },
             { "skipPendingTaskCheck",    no_argument,       0, 's' },
+            { "dumpPendingTasks",        no_argument,       0, 'd' },
             { "waitTime",                required_argument, 0, 'w' }
         };
 
@@ -78,6 +84,10 @@ int main(int argc, char **argv)
                 SWSS_LOG_NOTICE("Skipping pending task check for orchagent");
                 skipPendingTaskCheck = "true";
                 break;
+            case 'd':
+                SWSS_LOG_NOTICE("Asking orchagent to log every pending task");
+                dumpPendingTasks = "true";
+                break;
             case 'w':
                 SWSS_LOG_NOTICE("Wait time for response from orchagent set to %s milliseconds", optarg);
                 waitTime = atoi(optarg);
@@ -106,6 +116,7 @@ int main(int argc, char **argv)
     std::vector<swss::FieldValueTuple> values;
     values.emplace_back("NoFreeze", noFreeze);
     values.emplace_back("SkipPendingTaskCheck", skipPendingTaskCheck);
+    values.emplace_back("DumpPendingTasks", dumpPendingTasks);
     std::string op = "orchagent";
     SWSS_LOG_NOTICE("requested %s to do warm restart state check", op.c_str());
     restartQuery.send(op, op, values);
@@ -120,6 +131,11 @@ int main(int argc, char **argv)
     if (result == swss::Select::OBJECT)
     {
         restartQueryReply.pop(op_ret, data, values);
+        /* Summary of the pending tasks, one field per table */
+        for (const auto &fv : values)
+        {
+            std::cout << "Pending tasks in " << fvField(fv) << ": " << fvValue(fv) << std::endl;
+        }
         if (data == "READY")
         {
             SWSS_LOG_NOTICE("RESTARTCHECK success, %s is frozen and ready for warm restart", op_ret.c_str());
@@ -1,6 +1,9 @@
 #include <unistd.h>
 #include <unordered_map>
+#include <set>
 #include <limits.h>
+#include <atomic>
+#include <thread>
 #include "orchdaemon.h"
 #include "logger.h"
 #include <sairedis.h>
@@ -14,6 +17,36 @@ using namespace swss;
 
 /* select() function timeout retry time */
 #define SELECT_TIMEOUT 1000
+
+/*
+ * The sairedis pipeline is flushed as soon as the work written to it since
+ * the last flush exceeds one of these thresholds. Below them, it is flushed
+ * once idle or at the latest FLUSH_MAX_AGE_MSECS after the first write.
+ */
+#define FLUSH_MAX_PENDING_TASKS 512
+#define FLUSH_MAX_PENDING_BYTES (256 * 1024)
+#define FLUSH_MAX_AGE_MSECS 10
+#define FLUSH_STATS_TABLE "ORCHAGENT_FLUSH_STATS"
+
+/* Profiling counters of the executors, exported every STATS_INTERVAL_SEC */
+#define PROFILE_STATS_TABLE "ORCHAGENT_PROFILE"
+#define PROFILE_DAEMON_KEY "ORCHDAEMON"
+#define STATS_INTERVAL_SEC 10
+
+/* Memory accounting of the orchs, exported every MEMORY_STATS_INTERVAL_SEC.
+ * Walking the tables takes time linear in their size, hence the longer interval */
+#define MEMORY_STATS_TABLE "ORCHAGENT_MEMORY"
+#define MEMORY_TOTAL_KEY "total"
+#define MEMORY_STATS_INTERVAL_SEC 60
+
+/* Number of keys reported per consumer in the pending task summaries */
+#define PENDING_TASK_SAMPLE_KEYS 5
+
+/* Warm restore: threads reading the consumer tables, and bound on the
+ * iterations needed for the restored tasks to reach a fixed point */
+#define WARM_RESTORE_READ_THREADS 4
+#define WARM_RESTORE_MAX_ITERATIONS 32
+
 #define PFC_WD_POLL_MSECS 100
 
 extern sai_switch_api_t*           sai_switch_api;
@@ -40,6 +73,11 @@ OrchDaemon::OrchDaemon(DBConnector *applDb, DBConnector *configDb, DBConnector *
         m_stateDb(stateDb)
 {
     SWSS_LOG_ENTER();
+
+    m_countersDb = shared_ptr<DBConnector>(new DBConnector(COUNTERS_DB, DBConnector::DEFAULT_UNIXSOCKET, 0));
+    m_flushStatsTable = unique_ptr<Table>(new Table(m_countersDb.get(), FLUSH_STATS_TABLE));
+    m_profileStatsTable = unique_ptr<Table>(new Table(m_countersDb.get(), PROFILE_STATS_TABLE));
+    m_memoryStatsTable = unique_ptr<Table>(new Table(m_countersDb.get(), MEMORY_STATS_TABLE));
 }
 
 OrchDaemon::~OrchDaemon()
@@ -322,6 +360,8 @@ void OrchDaemon::flush()
 {
     SWSS_LOG_ENTER();
 
+    ExecutorProfileScope profile(m_daemonStats);
+
     sai_attribute_t attr;
     attr.id = SAI_REDIS_SWITCH_ATTR_FLUSH;
     sai_status_t status = sai_switch_api->set_switch_attribute(gSwitchId, &attr);
@@ -330,6 +370,207 @@ void OrchDaemon::flush()
         SWSS_LOG_ERROR("Failed to flush redis pipeline %d", status);
         exit(EXIT_FAILURE);
     }
+
+    m_flushCount++;
+    m_flushedTasks += m_pendingTasks;
+    m_flushedBytes += m_pendingBytes;
+
+    m_pendingWakeups = 0;
+    m_pendingTasks = 0;
+    m_pendingBytes = 0;
+}
+
+/* Account the tasks completed since the last call as pending pipeline work */
+void OrchDaemon::updatePendingWork()
+{
+    uint64_t completed = 0;
+    uint64_t bytes = 0;
+
+    for (Orch *o : m_orchList)
+    {
+        o->getTaskCounters(completed, bytes);
+    }
+
+    m_pendingTasks += completed - m_lastCompletedTasks;
+    m_pendingBytes += bytes - m_lastPoppedBytes;
+    m_lastCompletedTasks = completed;
+    m_lastPoppedBytes = bytes;
+}
+
+/*
+ * Flush the sairedis pipeline once enough work is pending, so that tiny
+ * batches are coalesced under load, or when the oldest pending work gets too
+ * old or no more event is coming, so that the latency stays bounded.
+ */
+void OrchDaemon::flushIfNeeded(bool idle)
+{
+    if (m_pendingWakeups == 0)
+    {
+        return;
+    }
+
+    auto now = chrono::steady_clock::now();
+    auto age = chrono::duration_cast<chrono::milliseconds>(now - m_pendingSince);
+
+    if (idle ||
+        m_pendingTasks >= FLUSH_MAX_PENDING_TASKS ||
+        m_pendingBytes >= FLUSH_MAX_PENDING_BYTES ||
+        age.count() >= FLUSH_MAX_AGE_MSECS)
+    {
+        flush();
+    }
+}
+
+/* Export the flush and profiling counters and the memory accounting periodically */
+void OrchDaemon::updateStatsIfNeeded()
+{
+    auto now = chrono::steady_clock::now();
+    if (now - m_lastStatsUpdate < chrono::seconds(STATS_INTERVAL_SEC))
+    {
+        return;
+    }
+
+    updateFlushStats();
+    updateProfileStats();
+    m_lastStatsUpdate = now;
+
+    if (now - m_lastMemoryStatsUpdate >= chrono::seconds(MEMORY_STATS_INTERVAL_SEC))
+    {
+        updateMemoryStats();
+        m_lastMemoryStatsUpdate = now;
+    }
+}
+
+void OrchDaemon::updateFlushStats()
+{
+    uint64_t avg_batch_size = m_flushCount ? m_flushedTasks / m_flushCount : 0;
+
+    vector<FieldValueTuple> fvs = {
+        { "flush_count", to_string(m_flushCount) },
+        { "flushed_tasks", to_string(m_flushedTasks) },
+        { "flushed_bytes", to_string(m_flushedBytes) },
+        { "avg_batch_size", to_string(avg_batch_size) }
+    };
+
+    m_flushStatsTable->set("orchagent", fvs);
+}
+
+static vector<FieldValueTuple> serializeExecutorStats(const ExecutorStats &stats)
+{
+    vector<FieldValueTuple> fvs = {
+        { "executions", to_string(stats.executions) },
+        { "popped_tasks", to_string(stats.popped_tasks) },
+        { "popped_bytes", to_string(stats.popped_bytes) },
+        { "completed_tasks", to_string(stats.completed_tasks) },
+        { "retried_tasks", to_string(stats.retried_tasks) },
+        { "task_usecs", to_string(stats.task_usecs) },
+        { "sai_calls", to_string(stats.sai_calls) },
+        { "sai_usecs", to_string(stats.sai_usecs) }
+    };
+
+    /* Latency histogram, each bucket counting the calls below its bound */
+    for (int i = 0; i < SAI_LATENCY_BUCKETS; i++)
+    {
+        string bound = i < SAI_LATENCY_BUCKETS - 1 ? to_string(1ULL << i) : "inf";
+        fvs.emplace_back("sai_latency_lt_" + bound + "us", to_string(stats.sai_latency[i]));
+    }
+
+    return fvs;
+}
+
+void OrchDaemon::getExecutorStats(map<string, ExecutorStats> &stats)
+{
+    for (Orch *o : m_orchList)
+    {
+        o->getExecutorStats(stats);
+    }
+
+    stats[PROFILE_DAEMON_KEY] = m_daemonStats;
+}
+
+void OrchDaemon::updateProfileStats()
+{
+    map<string, ExecutorStats> stats;
+    getExecutorStats(stats);
+
+    for (const auto &it : stats)
+    {
+        m_profileStatsTable->set(it.first, serializeExecutorStats(it.second));
+    }
+}
+
+/*
+ * Export the entries and the estimated memory of the structures of every
+ * orch, one key per structure, along with the total of the estimates.
+ */
+void OrchDaemon::updateMemoryStats()
+{
+    MemoryStatsTable stats;
+    for (Orch *o : m_orchList)
+    {
+        o->getMemoryStats(stats);
+    }
+
+    uint64_t total_bytes = 0;
+    for (const auto &it : stats)
+    {
+        vector<FieldValueTuple> fvs = {
+            { "entries", to_string(it.second.entries) },
+            { "bytes", to_string(it.second.bytes) }
+        };
+
+        m_memoryStatsTable->set(it.first, fvs);
+        total_bytes += it.second.bytes;
+    }
+
+    vector<FieldValueTuple> fvs = {
+        { "bytes", to_string(total_bytes) }
+    };
+
+    m_memoryStatsTable->set(MEMORY_TOTAL_KEY, fvs);
+}
+
+/*
+ * Reply to a profile dump request with the counters of every executor, one
+ * field per executor, the counters being separated by commas.
+ */
+void OrchDaemon::profileDump()
+{
+    SWSS_LOG_ENTER();
+
+    map<string, ExecutorStats> stats;
+    getExecutorStats(stats);
+
+    vector<FieldValueTuple> values;
+    for (const auto &it : stats)
+    {
+        string counters;
+        for (const auto &fv : serializeExecutorStats(it.second))
+        {
+            if (!counters.empty())
+            {
+                counters += ",";
+            }
+            counters += fvField(fv) + "=" + fvValue(fv);
+        }
+        values.emplace_back(it.first, counters);
+    }
+
+    SWSS_LOG_NOTICE("Profile dump of %zu executors", values.size());
+    gSwitchOrch->profileDumpReply("orchagent", "DONE", values);
+}
+
+/* Program the SAI operations queued in the bulkers of all orchs */
+void OrchDaemon::flushBulkers()
+{
+    SWSS_LOG_ENTER();
+
+    ExecutorProfileScope profile(m_daemonStats);
+
+    for (Orch *o : m_orchList)
+    {
+        o->flushBulkers();
+    }
 }
 
 void OrchDaemon::start()
@@ -346,7 +587,8 @@ void OrchDaemon::start()
         Selectable *s;
         int ret;
 
-        ret = m_select->select(&s, SELECT_TIMEOUT);
+        /* Wait no longer than the flush age limit while work is pending */
+        ret = m_select->select(&s, m_pendingWakeups ? FLUSH_MAX_AGE_MSECS : SELECT_TIMEOUT);
 
         if (ret == Select::ERROR)
         {
@@ -356,26 +598,52 @@ void OrchDaemon::start()
 
         if (ret == Select::TIMEOUT)
         {
+            flushIfNeeded(true);
+            updateStatsIfNeeded();
             continue;
         }
 
+        /* Any executor may write to the pipeline, not only consumers */
+        if (m_pendingWakeups++ == 0)
+        {
+            m_pendingSince = chrono::steady_clock::now();
+        }
+
         auto *c = (Executor *)s;
         c->execute();
 
         /* After each iteration, periodically check all m_toSync map to
-         * execute all the remaining tasks that need to be retried. */
+         * execute all the remaining tasks that need to be retried.
+         * Once frozen, the remaining tasks are left for after the restart. */
 
         /* TODO: Abstract Orch class to have a specific todo list */
-        for (Orch *o : m_orchList)
-            o->doTask();
+        if (!m_frozen)
+        {
+            for (Orch *o : m_orchList)
+                o->doTask();
+        }
 
         /* Let sairedis to flush all SAI function call to ASIC DB.
          * Normally the redis pipeline will flush when enough request
          * accumulated. Still it is possible that small amount of
-         * requests live in it. When the daemon has finished events/tasks, it
-         * is a good chance to flush the pipeline before next select happened.
+         * requests live in it. Flush it when enough work is pending or
+         * when the pending work gets old, and anyway once idle.
          */
-        flush();
+        updatePendingWork();
+        flushIfNeeded(false);
+        updateStatsIfNeeded();
+
+        /* Asked to dump the profiling counters */
+        if (gSwitchOrch->checkProfileDump())
+        {
+            profileDump();
+        }
+
+        /* Asked for the pending tasks */
+        if (gSwitchOrch->checkPendingTasksQuery())
+        {
+            pendingTasksQuery();
+        }
 
         /*
          * Asked to check warm restart readiness.
@@ -384,32 +652,121 @@ void OrchDaemon::start()
          */
         if (gSwitchOrch->checkRestartReady())
         {
+            /* The state written so far must reach ASIC DB before READY is
+             * published, so flush whatever the pipeline still holds */
+            flushIfNeeded(true);
+
             bool ret = warmRestartCheck();
-            if (ret)
+            if (ret && !m_frozen && !gSwitchOrch->checkRestartNoFreeze())
+            {
+                freeze();
+            }
+        }
+    }
+}
+
+/*
+ * Orchagent is ready to perform warm restart, stop processing any new db data.
+ * FDB aging and learning are disabled and every executor which may change the
+ * switch state is removed from the select: the table consumers, the route
+ * resync sweep, the port state and FDB notifications and the PFC watchdog
+ * actions. The executors which only poll counters or serve the restart and
+ * debug queries keep being serviced until orchagent is stopped.
+ */
+void OrchDaemon::freeze()
+{
+    SWSS_LOG_ENTER();
+
+    static const set<string> executorsKeptWhenFrozen = {
+        "RESTARTCHECK",
+        "PROFILEDUMP",
+        "PENDINGTASKS",
+        "CRM_COUNTERS_POLL",
+        "MC_COUNTERS_POLL",
+        "ACL_POLL_TIMER",
+        "UPDATE_MAPS_TIMER",
+        "WM_TELEMETRY_TIMER",
+        "WM_CLEAR_NOTIFIER",
+        "PFC_WD_COUNTERS_POLL",
+    };
+
+    // Disable FDB aging
+    gSwitchOrch->setAgingFDB(0);
+
+    // Disable FDB learning on all bridge ports
+    for (auto& pair: gPortsOrch->getAllPorts())
+    {
+        auto& port = pair.second;
+        gPortsOrch->setBridgePortLearningFDB(port, SAI_BRIDGE_PORT_FDB_LEARNING_MODE_DISABLE);
+    }
+
+    // Stop taking new configuration and state changes
+    for (Orch *o : m_orchList)
+    {
+        vector<Executor *> executors;
+        o->getExecutors(executors);
+
+        for (Executor *executor : executors)
+        {
+            if (executorsKeptWhenFrozen.find(executor->getName()) == executorsKeptWhenFrozen.end())
             {
-                // Orchagent is ready to perform warm restart, stop processing any new db data.
-                // Should sleep here or continue handling timers and etc.??
-                if (!gSwitchOrch->checkRestartNoFreeze())
-                {
-                    // Disable FDB aging
-                    gSwitchOrch->setAgingFDB(0);
-
-                    // Disable FDB learning on all bridge ports
-                    for (auto& pair: gPortsOrch->getAllPorts())
-                    {
-                        auto& port = pair.second;
-                        gPortsOrch->setBridgePortLearningFDB(port, SAI_BRIDGE_PORT_FDB_LEARNING_MODE_DISABLE);
-                    }
-
-                    // Flush sairedis's redis pipeline
-                    flush();
-
-                    SWSS_LOG_WARN("Orchagent is frozen for warm restart!");
-                    sleep(UINT_MAX);
-                }
+                m_select->removeSelectable(executor);
             }
         }
     }
+
+    // Flush the queued SAI operations and sairedis's redis pipeline
+    flushBulkers();
+    flush();
+
+    m_frozen = true;
+    SWSS_LOG_WARN("Orchagent is frozen for warm restart!");
+}
+
+/*
+ * Read the tables of all consumers on worker threads, each using its own DB
+ * connections, so that the following bake() calls refill the consumers
+ * without waiting for redis.
+ */
+void OrchDaemon::prefetchWarmInput()
+{
+    SWSS_LOG_ENTER();
+
+    vector<Consumer *> consumers;
+    for (Orch *o : m_orchList)
+    {
+        o->getConsumers(consumers);
+    }
+
+    atomic<size_t> next(0);
+    auto worker = [&consumers, &next]()
+    {
+        map<int, unique_ptr<DBConnector>> dbs;
+        size_t i;
+        while ((i = next++) < consumers.size())
+        {
+            Consumer *consumer = consumers[i];
+            auto &db = dbs[consumer->getDbId()];
+            if (!db)
+            {
+                db = unique_ptr<DBConnector>(new DBConnector(consumer->getDbId(), DBConnector::DEFAULT_UNIXSOCKET, 0));
+            }
+            consumer->prefetchToSync(db.get());
+        }
+    };
+
+    vector<thread> threads;
+    for (int i = 0; i < WARM_RESTORE_READ_THREADS; i++)
+    {
+        threads.emplace_back(worker);
+    }
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    SWSS_LOG_NOTICE("Prefetched warm input of %zu consumers", consumers.size());
 }
 
 /*
@@ -420,32 +777,66 @@ bool OrchDaemon::warmRestoreAndSyncUp()
 {
     WarmStart::setWarmStartState("orchagent", WarmStart::INITIALIZED);
 
+    prefetchWarmInput();
+
     for (Orch *o : m_orchList)
     {
         o->bake();
     }
 
+    /* Some orchs refill their consumers from another table, or fall back to
+     * a cold start, so their prefetched tables were not consumed */
+    vector<Consumer *> consumers;
+    for (Orch *o : m_orchList)
+    {
+        o->getConsumers(consumers);
+    }
+
+    for (Consumer *consumer : consumers)
+    {
+        consumer->dropPrefetched();
+    }
+
     /*
-     * Four iterations are needed.
-     *
-     * First iteration: switchorch, Port init/hostif create part of portorch.
-     *
-     * Second iteratoin: gBufferOrch which requires port created,
-     *   then port speed/mtu/fec_mode/pfc_asym/admin_status config.
-     *
-     * Third iteration: other orch(s) which wait for port init done.
-     *
-     * Fourth iteration: Drain remaining data that are out of order like LAG_MEMBER_TABLE and
-     * VLAN_MEMBER_TABLE since they were checked before LAG_TABLE and VLAN_TABLE within gPortsOrch.
+     * Iterate until no more task can be completed. Orchs depend on each other,
+     * e.g. gBufferOrch requires the ports created by gPortsOrch, and some
+     * tables are processed before the tables they depend on within an orch,
+     * like LAG_MEMBER_TABLE and LAG_TABLE within gPortsOrch. Each iteration
+     * completes the tasks whose dependencies were satisfied by the previous
+     * one, and an iteration completing nothing means the next ones won't.
      */
-    for (auto it = 0; it < 4; it++)
+    uint64_t completed = 0;
+    uint64_t bytes = 0;
+    for (Orch *o : m_orchList)
+    {
+        o->getTaskCounters(completed, bytes);
+    }
+
+    int iterations = 0;
+    while (iterations < WARM_RESTORE_MAX_ITERATIONS)
     {
+        iterations++;
         for (Orch *o : m_orchList)
         {
             o->doTask();
         }
+
+        uint64_t last_completed = completed;
+        completed = 0;
+        bytes = 0;
+        for (Orch *o : m_orchList)
+        {
+            o->getTaskCounters(completed, bytes);
+        }
+
+        if (completed == last_completed)
+        {
+            break;
+        }
     }
 
+    SWSS_LOG_NOTICE("Orchagent state restore took %d iterations", iterations);
+
     /*
      * At this point, all the pre-existing data should have been processed properly, and
      * orchagent should be in exact same state of pre-shutdown.
@@ -485,6 +876,66 @@ void OrchDaemon::getTaskToSync(vector<string> &ts)
 }
 
 
+/*
+ * Summarize the pending tasks of all consumers. Unlike getTaskToSync, it does
+ * not serialize every pending tuple and is cheap enough to be polled often.
+ */
+void OrchDaemon::getPendingTaskSummary(vector<PendingTaskSummary> &summaries)
+{
+    for (Orch *o : m_orchList)
+    {
+        o->getPendingTaskSummary(summaries, PENDING_TASK_SAMPLE_KEYS);
+    }
+}
+
+static FieldValueTuple serializePendingTaskSummary(const PendingTaskSummary &summary)
+{
+    string keys;
+    for (const auto &key : summary.sample_keys)
+    {
+        if (!keys.empty())
+        {
+            keys += ";";
+        }
+        keys += key;
+    }
+
+    string value = "set=" + to_string(summary.set_count) +
+                   ",del=" + to_string(summary.del_count) +
+                   ",age_ms=" + to_string(summary.age_msecs) +
+                   ",keys=" + keys;
+
+    return FieldValueTuple(summary.table, value);
+}
+
+/* Log the pending task summary, and every pending task if asked to */
+size_t OrchDaemon::logPendingTasks(const string &prefix, bool full, vector<FieldValueTuple> &values)
+{
+    vector<PendingTaskSummary> summaries;
+    getPendingTaskSummary(summaries);
+
+    size_t count = 0;
+    for (const auto &summary : summaries)
+    {
+        auto fv = serializePendingTaskSummary(summary);
+        SWSS_LOG_NOTICE("%s %s: %s", prefix.c_str(), fvField(fv).c_str(), fvValue(fv).c_str());
+        values.push_back(fv);
+        count += summary.set_count + summary.del_count;
+    }
+
+    if (full && count != 0)
+    {
+        vector<string> ts;
+        getTaskToSync(ts);
+        for (auto &s : ts)
+        {
+            SWSS_LOG_NOTICE("    %s", s.c_str());
+        }
+    }
+
+    return count;
+}
+
 /* Perform basic validation after start restore for warm start */
 bool OrchDaemon::warmRestoreValidation()
 {
@@ -492,19 +943,11 @@ bool OrchDaemon::warmRestoreValidation()
      * No pending task should exist for any of the consumer at this point.
      * All the prexisting data in appDB and configDb have been read and processed.
      */
-    vector<string> ts;
-    getTaskToSync(ts);
-    if (ts.size() != 0)
-    {
-        // TODO: Update this section accordingly once pre-warmStart consistency validation is ready.
-        SWSS_LOG_NOTICE("There are pending consumer tasks after restore: ");
-        for(auto &s : ts)
-        {
-            SWSS_LOG_NOTICE("%s", s.c_str());
-        }
-    }
+    vector<FieldValueTuple> values;
+    // TODO: Update this section accordingly once pre-warmStart consistency validation is ready.
+    size_t count = logPendingTasks("Pending consumer tasks after restore in", false, values);
     WarmStart::setWarmStartState("orchagent", WarmStart::RESTORED);
-    return ts.empty();
+    return count == 0;
 }
 
 /*
@@ -512,6 +955,7 @@ bool OrchDaemon::warmRestoreValidation()
  * Ortherwise reply with "NOT_READY" notification and return false.
  * Further consideration is needed as to when orchagent is treated as warm restart ready.
  * For now, no pending task should exist in any orch agent.
+ * The reply carries the pending task summary of every consumer having some.
  */
 bool OrchDaemon::warmRestartCheck()
 {
@@ -520,16 +964,11 @@ bool OrchDaemon::warmRestartCheck()
     std::string data = "READY";
     bool ret = true;
 
-    vector<string> ts;
-    getTaskToSync(ts);
+    size_t count = logPendingTasks("WarmRestart check found pending tasks in",
+            gSwitchOrch->checkRestartDumpPendingTasks(), values);
 
-    if (ts.size() != 0)
+    if (count != 0)
     {
-        SWSS_LOG_NOTICE("WarmRestart check found pending tasks: ");
-        for(auto &s : ts)
-        {
-            SWSS_LOG_NOTICE("    %s", s.c_str());
-        }
         if (!gSwitchOrch->skipPendingTaskCheck())
         {
             data = "NOT_READY";
@@ -545,3 +984,17 @@ bool OrchDaemon::warmRestartCheck()
     gSwitchOrch->restartCheckReply(op,  data, values);
     return ret;
 }
+
+/*
+ * Reply to a pending task query with the pending task summary of every
+ * consumer having some, the data being the total number of pending tasks.
+ */
+void OrchDaemon::pendingTasksQuery()
+{
+    SWSS_LOG_ENTER();
+
+    std::vector<swss::FieldValueTuple> values;
+    size_t count = logPendingTasks("Pending tasks in", gSwitchOrch->checkPendingTasksQueryFull(), values);
+
+    gSwitchOrch->pendingTasksQueryReply("orchagent", to_string(count), values);
+}
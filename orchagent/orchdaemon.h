@@ -28,6 +28,9 @@
 #include "watermarkorch.h"
 #include "directory.h"
 
+#include <chrono>
+#include <memory>
+
 using namespace swss;
 
 class OrchDaemon
@@ -39,7 +42,9 @@ public:
     bool init();
     void start();
     bool warmRestoreAndSyncUp();
+    void prefetchWarmInput();
     void getTaskToSync(vector<string> &ts);
+    void getPendingTaskSummary(vector<PendingTaskSummary> &summaries);
     bool warmRestoreValidation();
 
     bool warmRestartCheck();
@@ -51,7 +56,48 @@ private:
     std::vector<Orch *> m_orchList;
     Select *m_select;
 
+    /* Work written to the sairedis pipeline since the last flush */
+    uint64_t m_pendingWakeups = 0;
+    uint64_t m_pendingTasks = 0;
+    uint64_t m_pendingBytes = 0;
+    std::chrono::steady_clock::time_point m_pendingSince;
+    uint64_t m_lastCompletedTasks = 0;
+    uint64_t m_lastPoppedBytes = 0;
+
+    /* Flush statistics, exported to COUNTERS_DB */
+    uint64_t m_flushCount = 0;
+    uint64_t m_flushedTasks = 0;
+    uint64_t m_flushedBytes = 0;
+    std::chrono::steady_clock::time_point m_lastStatsUpdate;
+    std::shared_ptr<DBConnector> m_countersDb;
+    std::unique_ptr<Table> m_flushStatsTable;
+
+    /* Profiling counters of the work done by the daemon itself */
+    ExecutorStats m_daemonStats;
+    std::unique_ptr<Table> m_profileStatsTable;
+
+    /* Memory accounting of the orchs, exported less often than the counters */
+    std::chrono::steady_clock::time_point m_lastMemoryStatsUpdate;
+    std::unique_ptr<Table> m_memoryStatsTable;
+
+    /* Frozen for warm restart, only timers and notifications are serviced */
+    bool m_frozen = false;
+
     void flush();
+    void flushBulkers();
+    void freeze();
+    void updatePendingWork();
+    void flushIfNeeded(bool idle);
+    void updateStatsIfNeeded();
+    void updateFlushStats();
+
+    void getExecutorStats(std::map<std::string, ExecutorStats> &stats);
+    void updateProfileStats();
+    void profileDump();
+    void updateMemoryStats();
+
+    size_t logPendingTasks(const string &prefix, bool full, vector<FieldValueTuple> &values);
+    void pendingTasksQuery();
 };
 
 #endif /* SWSS_ORCHDAEMON_H */
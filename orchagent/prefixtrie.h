@@ -0,0 +1,385 @@
+#pragma once
+
+/*
+ * Path compressed binary trie indexed by IP prefixes, one tree per address
+ * family. It answers the two questions asked when tracking the routes used to
+ * reach a destination without scanning a whole table: which prefixes cover an
+ * address, and which entries fall under a prefix.
+ * A node is only kept when it holds a value or when its two children diverge,
+ * so the trie holds less than two nodes per value.
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "ipaddress.h"
+#include "ipprefix.h"
+
+template <typename T>
+class PrefixTrie
+{
+public:
+    typedef std::function<void(T&)> Visitor;
+
+    PrefixTrie() : m_size(0) { }
+
+    PrefixTrie(const PrefixTrie&) = delete;
+    PrefixTrie& operator=(const PrefixTrie&) = delete;
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /* Upper bound of the memory used by the nodes: the trie being path
+     * compressed, there is at most one branching node per value node */
+    size_t memoryUsage() const
+    {
+        return 2 * m_size * sizeof(Node);
+    }
+
+    void clear()
+    {
+        m_root[0].reset();
+        m_root[1].reset();
+        m_size = 0;
+    }
+
+    /* Insert or replace the value of the prefix */
+    void insert(const swss::IpPrefix &prefix, const T &value)
+    {
+        insert(Key(prefix), value);
+    }
+
+    void insert(const swss::IpAddress &address, const T &value)
+    {
+        insert(Key(address), value);
+    }
+
+    /* Remove the value of the prefix, return false if there was none */
+    bool erase(const swss::IpPrefix &prefix)
+    {
+        return erase(Key(prefix));
+    }
+
+    bool erase(const swss::IpAddress &address)
+    {
+        return erase(Key(address));
+    }
+
+    /* Return the value of the exact prefix, or nullptr if there is none */
+    T *find(const swss::IpPrefix &prefix)
+    {
+        return find(Key(prefix));
+    }
+
+    T *find(const swss::IpAddress &address)
+    {
+        return find(Key(address));
+    }
+
+    /* Visit the values of the prefixes covering the address, shortest first */
+    void visitCovering(const swss::IpAddress &address, const Visitor &visitor)
+    {
+        Key key(address);
+        Node *node = m_root[key.family].get();
+
+        while (node && node->len <= key.len && commonLength(node->bits, key.bits, node->len) == node->len)
+        {
+            if (node->valid)
+            {
+                visitor(node->value);
+            }
+
+            if (node->len == key.len)
+            {
+                break;
+            }
+
+            node = node->child[bit(key.bits, node->len)].get();
+        }
+    }
+
+    /* Visit the values of the prefix and of all the prefixes or addresses it covers */
+    void visitCovered(const swss::IpPrefix &prefix, const Visitor &visitor)
+    {
+        Key key(prefix);
+        Node *node = m_root[key.family].get();
+
+        while (node)
+        {
+            uint8_t len = std::min(node->len, key.len);
+            if (commonLength(node->bits, key.bits, len) < len)
+            {
+                return;
+            }
+
+            if (node->len >= key.len)
+            {
+                break;
+            }
+
+            node = node->child[bit(key.bits, node->len)].get();
+        }
+
+        std::vector<Node *> stack;
+        if (node)
+        {
+            stack.push_back(node);
+        }
+
+        while (!stack.empty())
+        {
+            node = stack.back();
+            stack.pop_back();
+
+            if (node->valid)
+            {
+                visitor(node->value);
+            }
+
+            for (int i = 1; i >= 0; i--)
+            {
+                if (node->child[i])
+                {
+                    stack.push_back(node->child[i].get());
+                }
+            }
+        }
+    }
+
+private:
+    struct Key
+    {
+        uint8_t bits[16];
+        uint8_t len;
+        int     family;     // 0 for IPv4, 1 for IPv6
+
+        explicit Key(const swss::IpPrefix &prefix)
+        {
+            set(prefix.getIp(), prefix.getMaskLength());
+        }
+
+        explicit Key(const swss::IpAddress &address)
+        {
+            set(address, address.isV4() ? 32 : 128);
+        }
+
+        void set(const swss::IpAddress &address, int mask)
+        {
+            const ip_addr_t &ip = address.getIp();
+
+            memset(bits, 0, sizeof(bits));
+            if (address.isV4())
+            {
+                memcpy(bits, &ip.ip_addr.ipv4_addr, sizeof(ip.ip_addr.ipv4_addr));
+                family = 0;
+            }
+            else
+            {
+                memcpy(bits, ip.ip_addr.ipv6_addr, sizeof(ip.ip_addr.ipv6_addr));
+                family = 1;
+            }
+
+            len = static_cast<uint8_t>(mask);
+            mask_bits(bits, len);
+        }
+    };
+
+    struct Node
+    {
+        uint8_t bits[16];                   // prefix bits, in network order
+        uint8_t len;                        // prefix length
+        bool valid;                         // the node holds a value
+        T value;
+        std::unique_ptr<Node> child[2];
+
+        Node(const uint8_t *key, uint8_t length) : len(length), valid(false), value()
+        {
+            memcpy(bits, key, sizeof(bits));
+            mask_bits(bits, len);
+        }
+    };
+
+    std::unique_ptr<Node> m_root[2];
+    size_t m_size;
+
+    static int bit(const uint8_t *bits, uint8_t pos)
+    {
+        return (bits[pos / 8] >> (7 - pos % 8)) & 1;
+    }
+
+    /* Clear the bits after the first len bits */
+    static void mask_bits(uint8_t *bits, uint8_t len)
+    {
+        for (int i = len / 8; i < 16; i++)
+        {
+            int keep = len - i * 8;
+            bits[i] = keep > 0 ? static_cast<uint8_t>(bits[i] & (0xff << (8 - keep))) : 0;
+        }
+    }
+
+    /* Number of leading bits shared by a and b, up to max */
+    static uint8_t commonLength(const uint8_t *a, const uint8_t *b, uint8_t max)
+    {
+        uint8_t len = 0;
+
+        while (len < max)
+        {
+            uint8_t diff = static_cast<uint8_t>(a[len / 8] ^ b[len / 8]);
+            if (diff == 0)
+            {
+                len = static_cast<uint8_t>(len + 8);
+                continue;
+            }
+
+            while (!(diff & 0x80))
+            {
+                diff = static_cast<uint8_t>(diff << 1);
+                len++;
+            }
+            break;
+        }
+
+        return std::min(len, max);
+    }
+
+    void setValue(Node *node, const T &value)
+    {
+        if (!node->valid)
+        {
+            node->valid = true;
+            m_size++;
+        }
+        node->value = value;
+    }
+
+    void insert(const Key &key, const T &value)
+    {
+        std::unique_ptr<Node> *slot = &m_root[key.family];
+
+        while (true)
+        {
+            Node *node = slot->get();
+            if (!node)
+            {
+                slot->reset(new Node(key.bits, key.len));
+                setValue(slot->get(), value);
+                return;
+            }
+
+            uint8_t common = commonLength(node->bits, key.bits, std::min(node->len, key.len));
+            if (common == node->len)
+            {
+                if (common == key.len)
+                {
+                    setValue(node, value);
+                    return;
+                }
+
+                slot = &node->child[bit(key.bits, node->len)];
+                continue;
+            }
+
+            /* The key diverges from the node, or is a prefix of it: split */
+            std::unique_ptr<Node> parent(new Node(key.bits, common));
+            parent->child[bit(node->bits, common)] = std::move(*slot);
+
+            if (common == key.len)
+            {
+                setValue(parent.get(), value);
+            }
+            else
+            {
+                std::unique_ptr<Node> leaf(new Node(key.bits, key.len));
+                setValue(leaf.get(), value);
+                parent->child[bit(key.bits, common)] = std::move(leaf);
+            }
+
+            *slot = std::move(parent);
+            return;
+        }
+    }
+
+    bool erase(const Key &key)
+    {
+        std::unique_ptr<Node> *parent = nullptr;
+        std::unique_ptr<Node> *slot = &m_root[key.family];
+
+        while (*slot)
+        {
+            Node *node = slot->get();
+            if (node->len > key.len || commonLength(node->bits, key.bits, node->len) < node->len)
+            {
+                return false;
+            }
+
+            if (node->len == key.len)
+            {
+                break;
+            }
+
+            parent = slot;
+            slot = &node->child[bit(key.bits, node->len)];
+        }
+
+        Node *node = slot->get();
+        if (!node || !node->valid)
+        {
+            return false;
+        }
+
+        node->valid = false;
+        node->value = T();
+        m_size--;
+
+        /* Drop the nodes that are left without a value nor a branch */
+        compact(*slot);
+        if (parent && !*slot)
+        {
+            compact(*parent);
+        }
+
+        return true;
+    }
+
+    /* Remove the node if it has no value, keeping its only child if any */
+    static void compact(std::unique_ptr<Node> &slot)
+    {
+        Node *node = slot.get();
+        if (node->valid || (node->child[0] && node->child[1]))
+        {
+            return;
+        }
+
+        std::unique_ptr<Node> child = std::move(node->child[node->child[0] ? 0 : 1]);
+        slot = std::move(child);
+    }
+
+    T *find(const Key &key)
+    {
+        Node *node = m_root[key.family].get();
+
+        while (node && node->len <= key.len && commonLength(node->bits, key.bits, node->len) == node->len)
+        {
+            if (node->len == key.len)
+            {
+                return node->valid ? &node->value : nullptr;
+            }
+
+            node = node->child[bit(key.bits, node->len)].get();
+        }
+
+        return nullptr;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+ * Lightweight, always-on profiling of the orchagent executors. Each executor
+ * keeps an ExecutorStats accounting the tasks it processed, the time spent
+ * processing them and the SAI calls issued meanwhile.
+ */
+
+#include <chrono>
+#include <stdint.h>
+
+/* SAI latency histogram: bucket i counts the calls lasting less than 2^i usecs */
+#define SAI_LATENCY_BUCKETS 20
+
+struct ExecutorStats
+{
+    uint64_t executions = 0;        // number of times the executor ran
+    uint64_t popped_tasks = 0;      // tasks popped from the table
+    uint64_t popped_bytes = 0;      // size of the popped tasks
+    uint64_t completed_tasks = 0;   // tasks completed by doTask
+    uint64_t retried_tasks = 0;     // tasks left pending by doTask, to be retried
+    uint64_t task_usecs = 0;        // time spent running the executor
+    uint64_t sai_calls = 0;         // SAI calls issued while running the executor
+    uint64_t sai_usecs = 0;         // time spent in SAI calls
+    uint64_t sai_latency[SAI_LATENCY_BUCKETS] = {};
+
+    void recordSaiCall(uint64_t usecs)
+    {
+        sai_calls++;
+        sai_usecs += usecs;
+
+        int bucket = 0;
+        while (bucket < SAI_LATENCY_BUCKETS - 1 && (usecs >> bucket) != 0)
+        {
+            bucket++;
+        }
+        sai_latency[bucket]++;
+    }
+};
+
+static inline uint64_t elapsedUsecs(const std::chrono::steady_clock::time_point &start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+/* Statistics of the executor currently running, if any */
+inline ExecutorStats *&currentExecutorStats()
+{
+    static ExecutorStats *stats = nullptr;
+    return stats;
+}
+
+/* Account the lifetime of the scope as a run of the executor owning the stats */
+class ExecutorProfileScope
+{
+public:
+    explicit ExecutorProfileScope(ExecutorStats &stats) :
+        m_stats(stats),
+        m_previous(currentExecutorStats()),
+        m_start(std::chrono::steady_clock::now())
+    {
+        m_stats.executions++;
+        currentExecutorStats() = &m_stats;
+    }
+
+    ~ExecutorProfileScope()
+    {
+        m_stats.task_usecs += elapsedUsecs(m_start);
+        currentExecutorStats() = m_previous;
+    }
+
+    ExecutorProfileScope(const ExecutorProfileScope&) = delete;
+    ExecutorProfileScope& operator=(const ExecutorProfileScope&) = delete;
+
+private:
+    ExecutorStats &m_stats;
+    ExecutorStats *m_previous;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/* Account the lifetime of the scope as a SAI call of the running executor */
+class SaiCallProfileScope
+{
+public:
+    SaiCallProfileScope() :
+        m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~SaiCallProfileScope()
+    {
+        ExecutorStats *stats = currentExecutorStats();
+        if (stats != nullptr)
+        {
+            stats->recordSaiCall(elapsedUsecs(m_start));
+        }
+    }
+
+    SaiCallProfileScope(const SaiCallProfileScope&) = delete;
+    SaiCallProfileScope& operator=(const SaiCallProfileScope&) = delete;
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -3,6 +3,8 @@
 #include "logger.h"
 #include "swssnet.h"
 #include "crmorch.h"
+#include "timer.h"
+#include "tokenize.h"
 
 extern sai_object_id_t gVirtualRouterId;
 extern sai_object_id_t gSwitchId;
@@ -15,20 +17,116 @@ extern PortsOrch *gPortsOrch;
 extern IntfsOrch *gIntfsOrch;
 extern CrmOrch *gCrmOrch;
 
+extern int gResilientEcmpBuckets;
+
 /* Default maximum number of next hop groups */
 #define DEFAULT_NUMBER_OF_ECMP_GROUPS   128
 #define DEFAULT_MAX_ECMP_GROUP_SIZE     32
 
+/* Number of stale routes removed per sweep after a resync completes */
+#define RESYNC_SWEEP_BATCH_SIZE         1000
+/* Interval between two sweep batches, in nanoseconds */
+#define RESYNC_SWEEP_INTERVAL_NSEC      10000000
+
 const int routeorch_pri = 5;
 
+static uint32_t getNextHopWeight(const NextHopWeights &weights, const IpAddress &ipAddress)
+{
+    auto it = weights.find(ipAddress);
+    return it == weights.end() ? 1 : it->second;
+}
+
+/* Parse a weight, false unless it is a positive 32 bits integer */
+static bool parseNextHopWeight(const string &str, uint32_t &weight)
+{
+    try
+    {
+        size_t pos;
+        unsigned long value = stoul(str, &pos);
+        if (pos != str.size() || value == 0 || value > UINT32_MAX)
+        {
+            return false;
+        }
+
+        weight = (uint32_t)value;
+        return true;
+    }
+    catch (const logic_error &e)
+    {
+        return false;
+    }
+}
+
+/*
+ * Build the weights of the next hops from the "nexthop" and "weight" fields.
+ * The weights are left empty when the next hops all have the same cost.
+ * Return false when the weights are malformed.
+ */
+static bool parseNextHopWeights(const string &nexthops, const string &weights, NextHopWeights &result)
+{
+    result.clear();
+
+    if (weights.empty())
+    {
+        return true;
+    }
+
+    auto ip_list = tokenize(nexthops, ',');
+    auto weight_list = tokenize(weights, ',');
+    if (ip_list.size() != weight_list.size())
+    {
+        SWSS_LOG_ERROR("Mismatch between next hops %s and weights %s",
+                nexthops.c_str(), weights.c_str());
+        return false;
+    }
+
+    bool weighted = false;
+    for (size_t i = 0; i < ip_list.size(); i++)
+    {
+        uint32_t weight;
+        if (!parseNextHopWeight(weight_list[i], weight))
+        {
+            SWSS_LOG_ERROR("Invalid weight '%s' for next hop %s",
+                    weight_list[i].c_str(), ip_list[i].c_str());
+            result.clear();
+            return false;
+        }
+
+        if (!result.empty() && weight != result.begin()->second)
+        {
+            weighted = true;
+        }
+
+        result[IpAddress(ip_list[i])] = weight;
+    }
+
+    if (!weighted)
+    {
+        result.clear();
+    }
+
+    return true;
+}
+
 RouteOrch::RouteOrch(DBConnector *db, string tableName, NeighOrch *neighOrch) :
         Orch(db, tableName, routeorch_pri),
         m_neighOrch(neighOrch),
         m_nextHopGroupCount(0),
-        m_resync(false)
+        m_resync(false),
+        m_resyncGeneration(0),
+        m_nextHopGroupsChanged(false),
+        m_routeBulker(sai_route_api),
+        m_nextHopGroupMemberBulker(sai_next_hop_group_api, gSwitchId)
 {
     SWSS_LOG_ENTER();
 
+    addBulker(&m_routeBulker);
+
+    /* The sweep timer is only armed while stale routes are being removed */
+    m_resyncSweepTimer = new SelectableTimer(timespec { .tv_sec = 0, .tv_nsec = RESYNC_SWEEP_INTERVAL_NSEC });
+    auto executor = new ExecutableTimer(m_resyncSweepTimer, this, "ROUTE_RESYNC_SWEEP");
+    Orch::addExecutor(executor);
+
     sai_attribute_t attr;
     attr.id = SAI_SWITCH_ATTR_NUMBER_OF_ECMP_GROUPS;
 
@@ -58,6 +156,35 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, NeighOrch *neighOrch) :
             m_maxNextHopGroupCount /= DEFAULT_MAX_ECMP_GROUP_SIZE;
         }
     }
+
+    /*
+     * Resilient groups are emulated with one member per bucket, so every
+     * group takes as many members as there are buckets. Check the number of
+     * buckets against the members the switch supports, and bound the number
+     * of groups by the members available for them.
+     */
+    if (gResilientEcmpBuckets > 0)
+    {
+        attr.id = SAI_SWITCH_ATTR_ECMP_MEMBERS;
+
+        status = sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_WARN("Failed to get switch attribute number of ECMP members, rv:%d", status);
+        }
+        else if ((uint32_t)gResilientEcmpBuckets > attr.value.u32)
+        {
+            SWSS_LOG_ERROR("%d ECMP buckets exceed the %u ECMP members supported, use regular ECMP",
+                    gResilientEcmpBuckets, attr.value.u32);
+            gResilientEcmpBuckets = 0;
+        }
+        else
+        {
+            m_maxNextHopGroupCount = min(m_maxNextHopGroupCount,
+                    (int)(attr.value.u32 / (uint32_t)gResilientEcmpBuckets));
+        }
+    }
+
     SWSS_LOG_NOTICE("Maximum number of ECMP groups supported is %d", m_maxNextHopGroupCount);
 
     IpPrefix default_ip_prefix("0.0.0.0/0");
@@ -81,7 +208,7 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, NeighOrch *neighOrch) :
     gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
 
     /* Add default IPv4 route into the m_syncdRoutes */
-    m_syncdRoutes[default_ip_prefix] = IpAddresses();
+    setSyncdRoute(default_ip_prefix, IpAddresses());
 
     SWSS_LOG_NOTICE("Create IPv4 default route with packet action drop");
 
@@ -100,20 +227,20 @@ RouteOrch::RouteOrch(DBConnector *db, string tableName, NeighOrch *neighOrch) :
     gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
 
     /* Add default IPv6 route into the m_syncdRoutes */
-    m_syncdRoutes[v6_default_ip_prefix] = IpAddresses();
+    setSyncdRoute(v6_default_ip_prefix, IpAddresses());
 
     SWSS_LOG_NOTICE("Create IPv6 default route with packet action drop");
 }
 
-bool RouteOrch::hasNextHopGroup(const IpAddresses& ipAddresses) const
+bool RouteOrch::hasNextHopGroup(const IpAddresses& ipAddresses, const NextHopWeights &weights) const
 {
-    return m_syncdNextHopGroups.find(ipAddresses) != m_syncdNextHopGroups.end();
+    return m_syncdNextHopGroups.find(make_pair(ipAddresses, weights)) != m_syncdNextHopGroups.end();
 }
 
-sai_object_id_t RouteOrch::getNextHopGroupId(const IpAddresses& ipAddresses)
+sai_object_id_t RouteOrch::getNextHopGroupId(const IpAddresses& ipAddresses, const NextHopWeights &weights)
 {
-    assert(hasNextHopGroup(ipAddresses));
-    return m_syncdNextHopGroups[ipAddresses].next_hop_group_id;
+    assert(hasNextHopGroup(ipAddresses, weights));
+    return m_syncdNextHopGroups[make_pair(ipAddresses, weights)].next_hop_group_id;
 }
 
 void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr)
@@ -126,24 +253,22 @@ void RouteOrch::attach(Observer *observer, const IpAddress& dstAddr)
      * IP address */
     if (observerEntry == m_nextHopObservers.end())
     {
-        m_nextHopObservers.emplace(dstAddr, NextHopObserverEntry());
-        observerEntry = m_nextHopObservers.find(dstAddr);
+        observerEntry = m_nextHopObservers.emplace(dstAddr, NextHopObserverEntry()).first;
+        m_nextHopObserverTrie.insert(dstAddr, observerEntry);
+
+        RouteTable &routeTable = observerEntry->second.routeTable;
 
         /* Find the prefixes that cover the destination IP */
-        for (auto route : m_syncdRoutes)
+        m_syncdRouteTrie.visitCovering(dstAddr, [&routeTable](RouteTable::iterator &route)
         {
-            if (route.first.isAddressInSubnet(dstAddr))
-            {
-                SWSS_LOG_INFO("Prefix %s covers destination address",
-                        route.first.to_string().c_str());
-                observerEntry->second.routeTable.emplace(
-                        route.first, route.second);
-            }
-        }
+            SWSS_LOG_INFO("Prefix %s covers destination address",
+                    route->first.to_string().c_str());
+            routeTable.emplace(route->first, route->second);
+        });
 
         /* Find the subnets that cover the destination IP
          * The next hop of the subnet routes is left empty */
-        for (auto prefix : gIntfsOrch->getSubnetRoutes())
+        for (const auto &prefix : gIntfsOrch->getSubnetRoutes())
         {
             if (prefix.isAddressInSubnet(dstAddr))
             {
@@ -179,56 +304,99 @@ void RouteOrch::detach(Observer *observer, const IpAddress& dstAddr)
         assert(false);
     }
 
-    for (auto iter = observerEntry->second.observers.begin(); iter != observerEntry->second.observers.end(); ++iter)
+    auto &observers = observerEntry->second.observers;
+    for (auto iter = observers.begin(); iter != observers.end(); ++iter)
     {
         if (observer == *iter)
         {
-            m_observers.erase(iter);
+            observers.erase(iter);
             break;
         }
     }
+
+    /* Stop tracking the destination once nobody observes it anymore */
+    if (observers.empty())
+    {
+        m_nextHopObserverTrie.erase(dstAddr);
+        m_nextHopObservers.erase(observerEntry);
+    }
+}
+
+void RouteOrch::setSyncdRoute(const IpPrefix &ipPrefix, const IpAddresses &nextHops, const NextHopWeights &weights)
+{
+    auto route = m_syncdRoutes.emplace(ipPrefix, nextHops);
+    if (route.second)
+    {
+        m_syncdRouteTrie.insert(ipPrefix, route.first);
+    }
+    else
+    {
+        route.first->second = nextHops;
+    }
+
+    if (weights.empty())
+    {
+        m_syncdRouteWeights.erase(ipPrefix);
+    }
+    else
+    {
+        m_syncdRouteWeights[ipPrefix] = weights;
+    }
+}
+
+void RouteOrch::removeSyncdRoute(const IpPrefix &ipPrefix)
+{
+    m_syncdRouteTrie.erase(ipPrefix);
+    m_syncdRoutes.erase(ipPrefix);
+    m_syncdRouteWeights.erase(ipPrefix);
+}
+
+NextHopWeights RouteOrch::getSyncdRouteWeights(const IpPrefix &ipPrefix) const
+{
+    auto it = m_syncdRouteWeights.find(ipPrefix);
+    return it == m_syncdRouteWeights.end() ? NextHopWeights() : it->second;
 }
 
 bool RouteOrch::validnexthopinNextHopGroup(const IpAddress &ipaddr)
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t nexthop_id;
-    sai_status_t status;
+    /* The members of all the groups are created with one bulk call */
+    vector<sai_object_id_t *> member_ids;
 
     for (auto nhopgroup = m_syncdNextHopGroups.begin();
          nhopgroup != m_syncdNextHopGroups.end(); ++nhopgroup)
     {
 
-        if (!(nhopgroup->first.contains(ipaddr)))
+        if (!(nhopgroup->first.first.contains(ipaddr)))
         {
             continue;
         }
 
-        vector<sai_attribute_t> nhgm_attrs;
-        sai_attribute_t nhgm_attr;
-
-        nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID;
-        nhgm_attr.value.oid = nhopgroup->second.next_hop_group_id;
-        nhgm_attrs.push_back(nhgm_attr);
+        /* Give the next hop back its share of buckets */
+        if (nhopgroup->second.type == NHG_TYPE_RESILIENT)
+        {
+            if (!updateNextHopGroupBuckets(nhopgroup->first, nhopgroup->second))
+            {
+                return false;
+            }
+            continue;
+        }
 
-        nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID;
-        nhgm_attr.value.oid = m_neighOrch->getNextHopId(ipaddr);
-        nhgm_attrs.push_back(nhgm_attr);
+        sai_object_id_t &member_id = nhopgroup->second.nhopgroup_members[ipaddr];
+        queueNextHopGroupMember(nhopgroup->second.next_hop_group_id, ipaddr,
+                getNextHopWeight(nhopgroup->first.second, ipaddr), member_id);
+        member_ids.push_back(&member_id);
+    }
 
-        status = sai_next_hop_group_api->create_next_hop_group_member(&nexthop_id, gSwitchId,
-                                                                      (uint32_t)nhgm_attrs.size(),
-                                                                      nhgm_attrs.data());
+    m_nextHopGroupMemberBulker.flush();
 
-        if (status != SAI_STATUS_SUCCESS)
+    for (auto member_id : member_ids)
+    {
+        if (*member_id == SAI_NULL_OBJECT_ID)
         {
-            SWSS_LOG_ERROR("Failed to add next hop member to group %lx: %d\n",
-                           nhopgroup->second.next_hop_group_id, status);
             return false;
         }
-
-        gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
-        nhopgroup->second.nhopgroup_members[ipaddr] = nexthop_id;
     }
 
     return true;
@@ -238,34 +406,283 @@ bool RouteOrch::invalidnexthopinNextHopGroup(const IpAddress &ipaddr)
 {
     SWSS_LOG_ENTER();
 
-    sai_object_id_t nexthop_id;
-    sai_status_t status;
+    /* The members of all the groups are removed with one bulk call */
+    vector<sai_object_id_t *> member_ids;
 
     for (auto nhopgroup = m_syncdNextHopGroups.begin();
          nhopgroup != m_syncdNextHopGroups.end(); ++nhopgroup)
     {
 
-        if (!(nhopgroup->first.contains(ipaddr)))
+        if (!(nhopgroup->first.first.contains(ipaddr)))
         {
             continue;
         }
 
-        nexthop_id = nhopgroup->second.nhopgroup_members[ipaddr];
-        status = sai_next_hop_group_api->remove_next_hop_group_member(nexthop_id);
+        /* Only the buckets of the next hop are moved to the other next hops */
+        if (nhopgroup->second.type == NHG_TYPE_RESILIENT)
+        {
+            if (!updateNextHopGroupBuckets(nhopgroup->first, nhopgroup->second))
+            {
+                return false;
+            }
+            continue;
+        }
 
-        if (status != SAI_STATUS_SUCCESS)
+        sai_object_id_t &member_id = nhopgroup->second.nhopgroup_members[ipaddr];
+        if (member_id == SAI_NULL_OBJECT_ID)
+        {
+            continue;
+        }
+
+        queueNextHopGroupMemberRemoval(member_id);
+        member_ids.push_back(&member_id);
+    }
+
+    m_nextHopGroupMemberBulker.flush();
+
+    for (auto member_id : member_ids)
+    {
+        if (*member_id != SAI_NULL_OBJECT_ID)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Queue the creation of a next hop group member on the member bulker. Once the
+ * bulker is flushed, memberId holds the id of the member, or stays
+ * SAI_NULL_OBJECT_ID if the member failed to be created.
+ */
+void RouteOrch::queueNextHopGroupMember(sai_object_id_t nextHopGroupId, const IpAddress &ipAddress,
+                                        uint32_t weight, sai_object_id_t &memberId)
+{
+    SWSS_LOG_ENTER();
+
+    vector<sai_attribute_t> nhgm_attrs;
+    sai_attribute_t nhgm_attr;
+
+    nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID;
+    nhgm_attr.value.oid = nextHopGroupId;
+    nhgm_attrs.push_back(nhgm_attr);
+
+    nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID;
+    nhgm_attr.value.oid = m_neighOrch->getNextHopId(ipAddress);
+    nhgm_attrs.push_back(nhgm_attr);
+
+    /* Keep the SAI default weight for equal cost members */
+    if (weight != 1)
+    {
+        nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_WEIGHT;
+        nhgm_attr.value.u32 = weight;
+        nhgm_attrs.push_back(nhgm_attr);
+    }
+
+    memberId = SAI_NULL_OBJECT_ID;
+    m_nextHopGroupMemberBulker.create(nhgm_attrs,
+            [nextHopGroupId, ipAddress, &memberId](sai_status_t status, sai_object_id_t member_id)
+            {
+                if (status != SAI_STATUS_SUCCESS)
+                {
+                    SWSS_LOG_ERROR("Failed to add next hop %s member to group %lx: %d\n",
+                                   ipAddress.to_string().c_str(), nextHopGroupId, status);
+                    return;
+                }
+
+                gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
+                memberId = member_id;
+            });
+}
+
+/*
+ * Queue the removal of a next hop group member on the member bulker. Once the
+ * bulker is flushed, memberId is SAI_NULL_OBJECT_ID if the member was removed.
+ */
+void RouteOrch::queueNextHopGroupMemberRemoval(sai_object_id_t &memberId)
+{
+    SWSS_LOG_ENTER();
+
+    sai_object_id_t member_id = memberId;
+    m_nextHopGroupMemberBulker.remove(member_id,
+            [member_id, &memberId](sai_status_t status)
+            {
+                if (status != SAI_STATUS_SUCCESS)
+                {
+                    SWSS_LOG_ERROR("Failed to remove next hop group member %lx: %d\n", member_id, status);
+                    return;
+                }
+
+                gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
+                memberId = SAI_NULL_OBJECT_ID;
+            });
+}
+
+bool RouteOrch::addNextHopGroupMember(sai_object_id_t nextHopGroupId, const IpAddress &ipAddress,
+                                      uint32_t weight, sai_object_id_t &memberId)
+{
+    queueNextHopGroupMember(nextHopGroupId, ipAddress, weight, memberId);
+    m_nextHopGroupMemberBulker.flush();
+
+    return memberId != SAI_NULL_OBJECT_ID;
+}
+
+bool RouteOrch::removeNextHopGroupMember(sai_object_id_t memberId)
+{
+    queueNextHopGroupMemberRemoval(memberId);
+    m_nextHopGroupMemberBulker.flush();
+
+    return memberId == SAI_NULL_OBJECT_ID;
+}
+
+/*
+ * Distribute the buckets of a resilient next hop group over its next hops
+ * which are up, according to their weights. Only the buckets pointing to a
+ * next hop which is down, or to a next hop holding more than its share, are
+ * reprogrammed, so the flows hashed to the other buckets stay in place.
+ */
+bool RouteOrch::updateNextHopGroupBuckets(const NextHopGroupKey &key, NextHopGroupEntry &nhopgroup)
+{
+    SWSS_LOG_ENTER();
+
+    const IpAddresses &ipAddresses = key.first;
+    const NextHopWeights &weights = key.second;
+    auto &buckets = nhopgroup.nhopgroup_buckets;
+
+    /* Compute the share of buckets of each next hop which is up */
+    map<IpAddress, size_t> shares;
+    uint64_t total_weight = 0;
+    for (const auto &ip : ipAddresses.getIpAddresses())
+    {
+        if (m_neighOrch->isNextHopFlagSet(ip, NHFLAGS_IFDOWN))
+        {
+            continue;
+        }
+
+        shares[ip] = 0;
+        total_weight += getNextHopWeight(weights, ip);
+    }
+
+    size_t assigned = 0;
+    for (auto &share : shares)
+    {
+        share.second = (size_t)(buckets.size() * getNextHopWeight(weights, share.first) / total_weight);
+        assigned += share.second;
+    }
+
+    /* Hand out the buckets left by rounding down */
+    for (auto share = shares.begin(); assigned < buckets.size() && share != shares.end(); ++share)
+    {
+        share->second++;
+        assigned++;
+    }
+
+    /* Keep the buckets within the share of their next hop */
+    map<IpAddress, size_t> counts;
+    vector<size_t> free_buckets;
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        auto share = shares.find(buckets[i].next_hop);
+        if (buckets[i].member_id != SAI_NULL_OBJECT_ID && share != shares.end()
+            && counts[share->first] < share->second)
+        {
+            counts[share->first]++;
+            continue;
+        }
+
+        free_buckets.push_back(i);
+    }
+
+    auto share = shares.begin();
+    for (auto i : free_buckets)
+    {
+        auto &bucket = buckets[i];
+        sai_object_id_t old_member_id = bucket.member_id;
+
+        /* Program the new member before removing the old one */
+        if (!shares.empty())
+        {
+            while (counts[share->first] >= share->second)
+            {
+                ++share;
+            }
+
+            sai_object_id_t member_id;
+            if (!addNextHopGroupMember(nhopgroup.next_hop_group_id, share->first, 1, member_id))
+            {
+                return false;
+            }
+
+            counts[share->first]++;
+            bucket.next_hop = share->first;
+            bucket.member_id = member_id;
+        }
+        else
+        {
+            bucket.member_id = SAI_NULL_OBJECT_ID;
+        }
+
+        if (old_member_id != SAI_NULL_OBJECT_ID && !removeNextHopGroupMember(old_member_id))
+        {
+            return false;
+        }
+    }
+
+    SWSS_LOG_INFO("Reassigned %zu of %zu buckets of next hop group %s",
+            free_buckets.size(), buckets.size(), ipAddresses.to_string().c_str());
+
+    return true;
+}
+
+/* Remove the members of the buckets of a resilient next hop group */
+bool RouteOrch::removeNextHopGroupBuckets(NextHopGroupEntry &nhopgroup)
+{
+    SWSS_LOG_ENTER();
+
+    for (auto &bucket : nhopgroup.nhopgroup_buckets)
+    {
+        if (bucket.member_id == SAI_NULL_OBJECT_ID)
+        {
+            continue;
+        }
+
+        if (!removeNextHopGroupMember(bucket.member_id))
         {
-            SWSS_LOG_ERROR("Failed to remove next hop member %lx from group %lx: %d\n",
-                           nexthop_id, nhopgroup->second.next_hop_group_id, status);
             return false;
         }
 
-        gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
+        bucket.member_id = SAI_NULL_OBJECT_ID;
     }
 
     return true;
 }
 
+/* Check whether a next hop group still forwards to any of its next hops */
+bool RouteOrch::hasActiveNextHop(const NextHopGroupEntry &nhopgroup) const
+{
+    if (nhopgroup.type == NHG_TYPE_RESILIENT)
+    {
+        for (const auto &bucket : nhopgroup.nhopgroup_buckets)
+        {
+            if (bucket.member_id != SAI_NULL_OBJECT_ID)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (const auto &member : nhopgroup.nhopgroup_members)
+    {
+        if (!m_neighOrch->isNextHopFlagSet(member.first, NHFLAGS_IFDOWN))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void RouteOrch::doTask(Consumer& consumer)
 {
     SWSS_LOG_ENTER();
@@ -285,56 +702,60 @@ void RouteOrch::doTask(Consumer& consumer)
 
         /* Get notification from application */
         /* resync application:
-         * When routeorch receives 'resync' message, it marks all current
-         * routes as dirty and waits for 'resync complete' message. For all
-         * newly received routes, if they match current dirty routes, it unmarks
-         * them dirty. After receiving 'resync complete' message, it creates all
-         * newly added routes and removes all dirty routes.
+         * When routeorch receives 'resync' message, it starts a new resync
+         * generation. Routes keep being processed as usual, and every route
+         * updated during the resync window is stamped with the new generation.
+         * After receiving 'resync complete' message, all routes that were not
+         * stamped are stale and get removed in batches.
          */
         if (key == "resync")
         {
             if (op == "SET")
             {
-                /* Mark all current routes as dirty (DEL) in consumer.m_toSync map */
-                SWSS_LOG_NOTICE("Start resync routes\n");
-                for (auto i : m_syncdRoutes)
-                {
-                    vector<FieldValueTuple> v;
-                    auto x = KeyOpFieldsValuesTuple(i.first.to_string(), DEL_COMMAND, v);
-                    consumer.m_toSync[i.first.to_string()] = x;
-                }
-                m_resync = true;
+                startResync();
             }
             else
             {
-                SWSS_LOG_NOTICE("Complete resync routes\n");
-                m_resync = false;
+                completeResync();
             }
 
             it = consumer.m_toSync.erase(it);
             continue;
         }
 
-        if (m_resync)
-        {
-            it++;
-            continue;
-        }
-
         IpPrefix ip_prefix = IpPrefix(key);
 
+        /* A new update overrides the pending upgrade of a temporary route */
+        m_tempRoutes.erase(ip_prefix);
+
         if (op == SET_COMMAND)
         {
             IpAddresses ip_addresses;
             string alias;
+            string nexthops;
+            string weights;
 
             for (auto i : kfvFieldsValues(t))
             {
                 if (fvField(i) == "nexthop")
-                    ip_addresses = IpAddresses(fvValue(i));
+                {
+                    nexthops = fvValue(i);
+                    ip_addresses = IpAddresses(nexthops);
+                }
 
                 if (fvField(i) == "ifname")
                     alias = fvValue(i);
+
+                if (fvField(i) == "weight")
+                    weights = fvValue(i);
+            }
+
+            NextHopWeights nexthop_weights;
+            if (ip_addresses.getSize() > 1 && !parseNextHopWeights(nexthops, weights, nexthop_weights))
+            {
+                SWSS_LOG_ERROR("Failed to parse weights of route %s, drop it", key.c_str());
+                it = consumer.m_toSync.erase(it);
+                continue;
             }
 
             // TODO: set to blackhold if nexthop is empty?
@@ -362,9 +783,16 @@ void RouteOrch::doTask(Consumer& consumer)
                 continue;
             }
 
-            if (m_syncdRoutes.find(ip_prefix) == m_syncdRoutes.end() || m_syncdRoutes[ip_prefix] != ip_addresses)
+            /* Keep the route from being swept even if it fails to sync now */
+            if (isResyncInProgress())
+            {
+                m_routeGenerations[ip_prefix] = m_resyncGeneration;
+            }
+
+            if (m_syncdRoutes.find(ip_prefix) == m_syncdRoutes.end() || m_syncdRoutes[ip_prefix] != ip_addresses
+                || getSyncdRouteWeights(ip_prefix) != nexthop_weights)
             {
-                if (addRoute(ip_prefix, ip_addresses))
+                if (addRoute(ip_prefix, ip_addresses, nexthop_weights))
                     it = consumer.m_toSync.erase(it);
                 else
                     it++;
@@ -375,6 +803,8 @@ void RouteOrch::doTask(Consumer& consumer)
         }
         else if (op == DEL_COMMAND)
         {
+            m_routeGenerations.erase(ip_prefix);
+
             if (m_syncdRoutes.find(ip_prefix) != m_syncdRoutes.end())
             {
                 if (removeRoute(ip_prefix))
@@ -388,23 +818,179 @@ void RouteOrch::doTask(Consumer& consumer)
         }
         else
         {
-            SWSS_LOG_ERROR("Unknown operation type %s\n", op.c_str());
-            it = consumer.m_toSync.erase(it);
+            SWSS_LOG_ERROR("Unknown operation type %s\n", op.c_str());
+            it = consumer.m_toSync.erase(it);
+        }
+    }
+}
+
+void RouteOrch::getMemoryStats(MemoryStatsTable &stats)
+{
+    Orch::getMemoryStats(stats);
+
+    MemoryStats &routes = stats["RouteOrch:syncd_routes"];
+    routes = containerMemoryStats(m_syncdRoutes);
+    routes.bytes += m_syncdRouteTrie.memoryUsage() + containerMemoryStats(m_syncdRouteWeights).bytes;
+
+    MemoryStats &groups = stats["RouteOrch:syncd_next_hop_groups"];
+    groups.add(0, sizeof(m_syncdNextHopGroups));
+    for (const auto &it : m_syncdNextHopGroups)
+    {
+        const NextHopGroupEntry &entry = it.second;
+        groups.add(1, sizeof(it) + MEMORY_TREE_NODE_OVERHEAD + heapBytes(it.first) +
+                      heapBytes(entry.nhopgroup_members) + heapBytes(entry.nhopgroup_buckets));
+    }
+
+    MemoryStats &observers = stats["RouteOrch:next_hop_observers"];
+    observers.add(0, sizeof(m_nextHopObservers) + m_nextHopObserverTrie.memoryUsage());
+    for (const auto &it : m_nextHopObservers)
+    {
+        observers.add(1, sizeof(it) + MEMORY_TREE_NODE_OVERHEAD +
+                         heapBytes(it.second.routeTable) + heapBytes(it.second.observers));
+    }
+
+    stats["RouteOrch:temp_routes"] = containerMemoryStats(m_tempRoutes);
+
+    /* Routes tracked by the ongoing resync, if any */
+    MemoryStats &resync = stats["RouteOrch:resync_routes"];
+    resync = containerMemoryStats(m_routeGenerations);
+    resync.add(m_staleRoutes.size(), m_staleRoutes.size() * sizeof(IpPrefix));
+}
+
+void RouteOrch::doTask()
+{
+    SWSS_LOG_ENTER();
+
+    Orch::doTask();
+
+    if (m_nextHopGroupsChanged)
+    {
+        m_nextHopGroupsChanged = false;
+        upgradeTempRoutes();
+    }
+}
+
+void RouteOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    sweepStaleRoutes();
+}
+
+bool RouteOrch::isResyncInProgress() const
+{
+    return m_resync || !m_staleRoutes.empty();
+}
+
+void RouteOrch::startResync()
+{
+    SWSS_LOG_ENTER();
+
+    /* A new resync supersedes any sweep still pending from the previous one */
+    m_resyncSweepTimer->stop();
+    m_staleRoutes.clear();
+    m_routeGenerations.clear();
+
+    m_resyncGeneration++;
+    m_resync = true;
+
+    SWSS_LOG_NOTICE("Start resync routes, generation %lu", m_resyncGeneration);
+}
+
+void RouteOrch::completeResync()
+{
+    SWSS_LOG_ENTER();
+
+    if (!m_resync)
+    {
+        SWSS_LOG_WARN("Received resync complete without resync start");
+        return;
+    }
+
+    m_resync = false;
+
+    for (const auto& route : m_syncdRoutes)
+    {
+        /* Default routes without next hop are already dropped */
+        if (route.first.isDefaultRoute() && route.second.getSize() == 0)
+        {
+            continue;
+        }
+
+        auto generation = m_routeGenerations.find(route.first);
+        if (generation == m_routeGenerations.end() || generation->second != m_resyncGeneration)
+        {
+            m_staleRoutes.push_back(route.first);
         }
     }
+
+    SWSS_LOG_NOTICE("Complete resync routes, generation %lu, %zu stale routes",
+            m_resyncGeneration, m_staleRoutes.size());
+
+    if (m_staleRoutes.empty())
+    {
+        m_routeGenerations.clear();
+        return;
+    }
+
+    m_resyncSweepTimer->start();
 }
 
-void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nexthops, bool add)
+void RouteOrch::sweepStaleRoutes()
 {
     SWSS_LOG_ENTER();
 
-    for (auto& entry : m_nextHopObservers)
+    if (!gPortsOrch->isPortReady())
+    {
+        return;
+    }
+
+    size_t count = min(m_staleRoutes.size(), (size_t)RESYNC_SWEEP_BATCH_SIZE);
+    for (size_t i = 0; i < count; i++)
     {
-        if (!prefix.isAddressInSubnet(entry.first))
+        IpPrefix ip_prefix = m_staleRoutes.front();
+        m_staleRoutes.pop_front();
+
+        /* Skip routes that were updated or removed after the resync completed */
+        if (m_routeGenerations.find(ip_prefix) != m_routeGenerations.end()
+            || m_syncdRoutes.find(ip_prefix) == m_syncdRoutes.end())
         {
             continue;
         }
 
+        if (!removeRoute(ip_prefix))
+        {
+            /* Retry in a later batch */
+            m_staleRoutes.push_back(ip_prefix);
+        }
+    }
+
+    /* Routes failing to be removed once flushed are retried by the consumer */
+    m_routeBulker.flush();
+
+    if (m_staleRoutes.empty())
+    {
+        SWSS_LOG_NOTICE("Removed all stale routes of resync generation %lu", m_resyncGeneration);
+        m_resyncSweepTimer->stop();
+        m_routeGenerations.clear();
+    }
+}
+
+void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nexthops, bool add)
+{
+    SWSS_LOG_ENTER();
+
+    /* Only the destinations under the changed prefix are affected */
+    vector<NextHopObserverTable::iterator> entries;
+    m_nextHopObserverTrie.visitCovered(prefix, [&entries](NextHopObserverTable::iterator &entry)
+    {
+        entries.push_back(entry);
+    });
+
+    for (auto it : entries)
+    {
+        auto &entry = *it;
+
         if (add)
         {
             bool update_required = false;
@@ -475,7 +1061,7 @@ void RouteOrch::notifyNextHopChangeObservers(IpPrefix prefix, IpAddresses nextho
     }
 }
 
-void RouteOrch::increaseNextHopRefCount(IpAddresses ipAddresses)
+void RouteOrch::increaseNextHopRefCount(IpAddresses ipAddresses, const NextHopWeights &weights)
 {
     /* Return when there is no next hop (dropped) */
     if (ipAddresses.getSize() == 0)
@@ -489,10 +1075,10 @@ void RouteOrch::increaseNextHopRefCount(IpAddresses ipAddresses)
     }
     else
     {
-        m_syncdNextHopGroups[ipAddresses].ref_count ++;
+        m_syncdNextHopGroups[make_pair(ipAddresses, weights)].ref_count ++;
     }
 }
-void RouteOrch::decreaseNextHopRefCount(IpAddresses ipAddresses)
+void RouteOrch::decreaseNextHopRefCount(IpAddresses ipAddresses, const NextHopWeights &weights)
 {
     /* Return when there is no next hop (dropped) */
     if (ipAddresses.getSize() == 0)
@@ -507,25 +1093,25 @@ void RouteOrch::decreaseNextHopRefCount(IpAddresses ipAddresses)
     }
     else
     {
-        m_syncdNextHopGroups[ipAddresses].ref_count --;
+        m_syncdNextHopGroups[make_pair(ipAddresses, weights)].ref_count --;
     }
 }
 
-bool RouteOrch::isRefCounterZero(const IpAddresses& ipAddresses) const
+bool RouteOrch::isRefCounterZero(const IpAddresses& ipAddresses, const NextHopWeights &weights) const
 {
-    if (!hasNextHopGroup(ipAddresses))
+    if (!hasNextHopGroup(ipAddresses, weights))
     {
         return true;
     }
 
-    return m_syncdNextHopGroups.at(ipAddresses).ref_count == 0;
+    return m_syncdNextHopGroups.at(make_pair(ipAddresses, weights)).ref_count == 0;
 }
 
-bool RouteOrch::addNextHopGroup(IpAddresses ipAddresses)
+bool RouteOrch::addNextHopGroup(IpAddresses ipAddresses, const NextHopWeights &weights)
 {
     SWSS_LOG_ENTER();
 
-    assert(!hasNextHopGroup(ipAddresses));
+    assert(!hasNextHopGroup(ipAddresses, weights));
 
     if (m_nextHopGroupCount >= m_maxNextHopGroupCount)
     {
@@ -574,53 +1160,81 @@ bool RouteOrch::addNextHopGroup(IpAddresses ipAddresses)
         return false;
     }
 
-    m_nextHopGroupCount ++;
-    SWSS_LOG_NOTICE("Create next hop group %s", ipAddresses.to_string().c_str());
-
-    gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP);
-
+    NextHopGroupKey key = make_pair(ipAddresses, weights);
     NextHopGroupEntry next_hop_group_entry;
     next_hop_group_entry.next_hop_group_id = next_hop_group_id;
+    next_hop_group_entry.type = gResilientEcmpBuckets > 0 ? NHG_TYPE_RESILIENT : NHG_TYPE_ECMP;
 
-    for (auto nhid: next_hop_ids)
+    bool members_created = true;
+    if (next_hop_group_entry.type == NHG_TYPE_RESILIENT)
     {
-        // skip next hop group member create for neighbor from down port
-        if (m_neighOrch->isNextHopFlagSet(nhopgroup_members_set[nhid], NHFLAGS_IFDOWN)) {
-            continue;
+        /* Members are programmed per bucket of the fixed size bucket table */
+        next_hop_group_entry.nhopgroup_buckets.resize((size_t)gResilientEcmpBuckets,
+                NextHopGroupBucket { IpAddress(), SAI_NULL_OBJECT_ID });
+
+        members_created = updateNextHopGroupBuckets(key, next_hop_group_entry);
+    }
+    else
+    {
+        auto &members = next_hop_group_entry.nhopgroup_members;
+        for (auto nhid: next_hop_ids)
+        {
+            IpAddress ip_address = nhopgroup_members_set[nhid];
+
+            // skip next hop group member create for neighbor from down port
+            if (m_neighOrch->isNextHopFlagSet(ip_address, NHFLAGS_IFDOWN)) {
+                continue;
+            }
+
+            // Create a next hop group member, saved into the next hop structure
+            queueNextHopGroupMember(next_hop_group_id, ip_address,
+                    getNextHopWeight(weights, ip_address), members[ip_address]);
         }
 
-        // Create a next hop group member
-        vector<sai_attribute_t> nhgm_attrs;
+        /* All the members are created with one bulk call */
+        m_nextHopGroupMemberBulker.flush();
 
-        sai_attribute_t nhgm_attr;
-        nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID;
-        nhgm_attr.value.oid = next_hop_group_id;
-        nhgm_attrs.push_back(nhgm_attr);
+        for (auto member = members.begin(); member != members.end();)
+        {
+            if (member->second == SAI_NULL_OBJECT_ID)
+            {
+                members_created = false;
+                member = members.erase(member);
+            }
+            else
+            {
+                member++;
+            }
+        }
+    }
 
-        nhgm_attr.id = SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID;
-        nhgm_attr.value.oid = nhid;
-        nhgm_attrs.push_back(nhgm_attr);
+    /* Roll back the members created and the group itself, so that the
+     * route is retried from scratch, e.g. once members are freed */
+    if (!members_created)
+    {
+        SWSS_LOG_ERROR("Failed to create members of next hop group %s",
+                       ipAddresses.to_string().c_str());
 
-        sai_object_id_t next_hop_group_member_id;
-        status = sai_next_hop_group_api->create_next_hop_group_member(&next_hop_group_member_id,
-                                                                      gSwitchId,
-                                                                      (uint32_t)nhgm_attrs.size(),
-                                                                      nhgm_attrs.data());
+        removeNextHopGroupBuckets(next_hop_group_entry);
+        for (auto &member : next_hop_group_entry.nhopgroup_members)
+        {
+            queueNextHopGroupMemberRemoval(member.second);
+        }
+        m_nextHopGroupMemberBulker.flush();
 
+        status = sai_next_hop_group_api->remove_next_hop_group(next_hop_group_id);
         if (status != SAI_STATUS_SUCCESS)
         {
-            // TODO: do we need to clean up?
-            SWSS_LOG_ERROR("Failed to create next hop group %lx member %lx: %d\n",
-                           next_hop_group_id, next_hop_group_member_id, status);
-            return false;
+            SWSS_LOG_ERROR("Failed to remove next hop group %lx, rv:%d", next_hop_group_id, status);
         }
+        return false;
+    }
 
-        gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
+    m_nextHopGroupCount ++;
+    m_nextHopGroupsChanged = true;
+    SWSS_LOG_NOTICE("Create next hop group %s", ipAddresses.to_string().c_str());
 
-        // Save the membership into next hop structure
-        next_hop_group_entry.nhopgroup_members[nhopgroup_members_set.find(nhid)->second] =
-                                                                next_hop_group_member_id;
-    }
+    gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP);
 
     /* Increment the ref_count for the next hops used by the next hop group. */
     for (auto it : next_hop_set)
@@ -631,18 +1245,18 @@ bool RouteOrch::addNextHopGroup(IpAddresses ipAddresses)
      * count will increase once the route is successfully syncd.
      */
     next_hop_group_entry.ref_count = 0;
-    m_syncdNextHopGroups[ipAddresses] = next_hop_group_entry;
+    m_syncdNextHopGroups[key] = next_hop_group_entry;
 
 
     return true;
 }
 
-bool RouteOrch::removeNextHopGroup(IpAddresses ipAddresses)
+bool RouteOrch::removeNextHopGroup(IpAddresses ipAddresses, const NextHopWeights &weights)
 {
     SWSS_LOG_ENTER();
 
     sai_object_id_t next_hop_group_id;
-    auto next_hop_group_entry = m_syncdNextHopGroups.find(ipAddresses);
+    auto next_hop_group_entry = m_syncdNextHopGroups.find(make_pair(ipAddresses, weights));
     sai_status_t status;
 
     assert(next_hop_group_entry != m_syncdNextHopGroups.end());
@@ -655,27 +1269,55 @@ bool RouteOrch::removeNextHopGroup(IpAddresses ipAddresses)
     next_hop_group_id = next_hop_group_entry->second.next_hop_group_id;
     SWSS_LOG_NOTICE("Delete next hop group %s", ipAddresses.to_string().c_str());
 
-    for (auto nhop = next_hop_group_entry->second.nhopgroup_members.begin();
-         nhop != next_hop_group_entry->second.nhopgroup_members.end();)
+    if (!removeNextHopGroupBuckets(next_hop_group_entry->second))
+    {
+        return false;
+    }
+
+    auto &members = next_hop_group_entry->second.nhopgroup_members;
+    for (auto nhop = members.begin(); nhop != members.end();)
     {
 
+        /* The member was never created, or already removed */
+        if (nhop->second == SAI_NULL_OBJECT_ID)
+        {
+            nhop = members.erase(nhop);
+            continue;
+        }
+
         if (m_neighOrch->isNextHopFlagSet(nhop->first, NHFLAGS_IFDOWN))
         {
             SWSS_LOG_WARN("NHFLAGS_IFDOWN set for next hop group member %s with next_hop_id %lx",
                            nhop->first.to_string().c_str(), nhop->second);
-            nhop = next_hop_group_entry->second.nhopgroup_members.erase(nhop);
+            nhop = members.erase(nhop);
             continue;
         }
-        status = sai_next_hop_group_api->remove_next_hop_group_member(nhop->second);
-        if (status != SAI_STATUS_SUCCESS)
+
+        queueNextHopGroupMemberRemoval(nhop->second);
+        nhop++;
+    }
+
+    /* All the members are removed with one bulk call, the ones which failed
+     * to be removed are kept so the removal is retried with the group */
+    m_nextHopGroupMemberBulker.flush();
+
+    bool members_removed = true;
+    for (auto nhop = members.begin(); nhop != members.end();)
+    {
+        if (nhop->second != SAI_NULL_OBJECT_ID)
         {
-            SWSS_LOG_ERROR("Failed to remove next hop group member %lx, rv:%d",
-                           nhop->second, status);
-            return false;
+            members_removed = false;
+            nhop++;
+        }
+        else
+        {
+            nhop = members.erase(nhop);
         }
+    }
 
-        gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP_MEMBER);
-        nhop = next_hop_group_entry->second.nhopgroup_members.erase(nhop);
+    if (!members_removed)
+    {
+        return false;
     }
 
     status = sai_next_hop_group_api->remove_next_hop_group(next_hop_group_id);
@@ -686,6 +1328,7 @@ bool RouteOrch::removeNextHopGroup(IpAddresses ipAddresses)
     }
 
     m_nextHopGroupCount --;
+    m_nextHopGroupsChanged = true;
     gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_NEXTHOP_GROUP);
 
     set<IpAddress> ip_address_set = ipAddresses.getIpAddresses();
@@ -693,44 +1336,207 @@ bool RouteOrch::removeNextHopGroup(IpAddresses ipAddresses)
     {
         m_neighOrch->decreaseNextHopRefCount(it);
     }
-    m_syncdNextHopGroups.erase(ipAddresses);
+    m_syncdNextHopGroups.erase(next_hop_group_entry);
 
     return true;
 }
 
-void RouteOrch::addTempRoute(IpPrefix ipPrefix, IpAddresses nextHops)
+bool RouteOrch::addTempRoute(IpPrefix ipPrefix, IpAddresses nextHops)
 {
     SWSS_LOG_ENTER();
 
-    auto next_hop_set = nextHops.getIpAddresses();
+    /* Prefer the largest existing next hop group made of a subset of the
+     * next hops, so that the route still load balances on some of them. */
+    auto best_group = m_syncdNextHopGroups.end();
+    for (auto nhg = m_syncdNextHopGroups.begin(); nhg != m_syncdNextHopGroups.end(); ++nhg)
+    {
+        const IpAddresses &group_next_hops = nhg->first.first;
+        if (!hasActiveNextHop(nhg->second) || group_next_hops.getSize() >= nextHops.getSize())
+        {
+            continue;
+        }
+
+        if (best_group != m_syncdNextHopGroups.end()
+            && group_next_hops.getSize() <= best_group->first.first.getSize())
+        {
+            continue;
+        }
+
+        bool is_subset = true;
+        for (const auto &ip : group_next_hops.getIpAddresses())
+        {
+            if (!nextHops.contains(ip))
+            {
+                is_subset = false;
+                break;
+            }
+        }
+
+        if (is_subset)
+        {
+            best_group = nhg;
+        }
+    }
 
-    /* Remove next hops that are not in m_syncdNextHops */
-    for (auto it = next_hop_set.begin(); it != next_hop_set.end();)
+    IpAddresses tmp_next_hops;
+    NextHopWeights tmp_weights;
+    if (best_group != m_syncdNextHopGroups.end())
+    {
+        tmp_next_hops = best_group->first.first;
+        tmp_weights = best_group->first.second;
+    }
+    else
     {
-        if (!m_neighOrch->hasNextHop(*it))
+        auto next_hop_set = nextHops.getIpAddresses();
+
+        /* Remove next hops that are not in m_syncdNextHops */
+        for (auto it = next_hop_set.begin(); it != next_hop_set.end();)
         {
-            SWSS_LOG_INFO("Failed to get next hop %s for %s",
-                   (*it).to_string().c_str(), ipPrefix.to_string().c_str());
-            it = next_hop_set.erase(it);
+            if (!m_neighOrch->hasNextHop(*it))
+            {
+                SWSS_LOG_INFO("Failed to get next hop %s for %s",
+                       (*it).to_string().c_str(), ipPrefix.to_string().c_str());
+                it = next_hop_set.erase(it);
+            }
+            else
+                it++;
+        }
+
+        /* Return if next_hop_set is empty */
+        if (next_hop_set.empty())
+            return false;
+
+        /* Pick an address from the set based on the prefix, so that the
+         * choice is stable across retries and spread across prefixes. */
+        auto it = next_hop_set.begin();
+        advance(it, hash<string>()(ipPrefix.to_string()) % next_hop_set.size());
+
+        tmp_next_hops = IpAddresses((*it).to_string());
+    }
+
+    /* Nothing to do if the route already uses the temporary next hop(s) */
+    auto it_route = m_syncdRoutes.find(ipPrefix);
+    if (it_route != m_syncdRoutes.end() && it_route->second == tmp_next_hops)
+    {
+        return true;
+    }
+
+    SWSS_LOG_INFO("Add temporary route %s with next hop(s) %s instead of %s",
+            ipPrefix.to_string().c_str(), tmp_next_hops.to_string().c_str(),
+            nextHops.to_string().c_str());
+
+    return addRoute(ipPrefix, tmp_next_hops, tmp_weights);
+}
+
+/*
+ * Try to move the temporary routes to the next hop groups they should be
+ * using. Shorter prefixes are upgraded first since they usually attract
+ * more traffic. When the next hop group limit is still reached, only the
+ * routes whose next hop group already exists can be upgraded.
+ */
+void RouteOrch::upgradeTempRoutes()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_tempRoutes.empty())
+    {
+        return;
+    }
+
+    vector<IpPrefix> prefixes;
+    for (const auto &route : m_tempRoutes)
+    {
+        if (m_nextHopGroupCount < m_maxNextHopGroupCount || hasNextHopGroup(route.second.first, route.second.second))
+        {
+            prefixes.push_back(route.first);
+        }
+    }
+
+    stable_sort(prefixes.begin(), prefixes.end(),
+            [](const IpPrefix &a, const IpPrefix &b)
+            {
+                return a.getMaskLength() < b.getMaskLength();
+            });
+
+    for (const auto &prefix : prefixes)
+    {
+        auto it_temp = m_tempRoutes.find(prefix);
+        if (it_temp == m_tempRoutes.end())
+        {
+            continue;
+        }
+
+        IpAddresses nextHops = it_temp->second.first;
+        NextHopWeights weights = it_temp->second.second;
+        if (m_nextHopGroupCount >= m_maxNextHopGroupCount && !hasNextHopGroup(nextHops, weights))
+        {
+            continue;
+        }
+
+        if (!addRoute(prefix, nextHops, weights))
+        {
+            /* The upgrade failed for another reason than the next hop group
+             * limit, e.g. a next hop is not resolved anymore. Hand the route
+             * back to the consumer so it is retried like any pending route. */
+            m_tempRoutes.erase(prefix);
+            retryRoute(prefix, nextHops, weights);
+        }
+        else if (!m_tempRoutes.count(prefix))
+        {
+            SWSS_LOG_NOTICE("Upgrade temporary route %s to next hop group %s",
+                    prefix.to_string().c_str(), nextHops.to_string().c_str());
         }
-        else
-            it++;
     }
 
-    /* Return if next_hop_set is empty */
-    if (next_hop_set.empty())
+    m_routeBulker.flush();
+}
+
+/* Requeue the route task of a prefix into the route consumer */
+void RouteOrch::retryRoute(const IpPrefix &ipPrefix, const IpAddresses &nextHops, const NextHopWeights &weights)
+{
+    SWSS_LOG_ENTER();
+
+    auto consumer = dynamic_cast<Consumer *>(getExecutor(APP_ROUTE_TABLE_NAME));
+    if (consumer == NULL)
+    {
+        SWSS_LOG_ERROR("Failed to get route consumer to retry route %s", ipPrefix.to_string().c_str());
         return;
+    }
+
+    vector<FieldValueTuple> fvs;
+    fvs.push_back(FieldValueTuple("nexthop", nextHops.to_string()));
+
+    /* Weights are listed in the order of the next hops */
+    if (!weights.empty())
+    {
+        string weight_list;
+        for (const auto &ip : nextHops.getIpAddresses())
+        {
+            auto it = weights.find(ip);
+            weight_list += (weight_list.empty() ? "" : ",") + to_string(it != weights.end() ? it->second : 1);
+        }
+        fvs.push_back(FieldValueTuple("weight", weight_list));
+    }
+
+    consumer->retry(KeyOpFieldsValuesTuple(ipPrefix.to_string(), SET_COMMAND, fvs));
+}
+
+/* Requeue the removal of a prefix into the route consumer */
+void RouteOrch::retryRouteRemoval(const IpPrefix &ipPrefix)
+{
+    SWSS_LOG_ENTER();
 
-    /* Randomly pick an address from the set */
-    auto it = next_hop_set.begin();
-    advance(it, rand() % next_hop_set.size());
+    auto consumer = dynamic_cast<Consumer *>(getExecutor(APP_ROUTE_TABLE_NAME));
+    if (consumer == NULL)
+    {
+        SWSS_LOG_ERROR("Failed to get route consumer to retry route %s removal", ipPrefix.to_string().c_str());
+        return;
+    }
 
-    /* Set the route's temporary next hop to be the randomly picked one */
-    IpAddresses tmp_next_hop((*it).to_string());
-    addRoute(ipPrefix, tmp_next_hop);
+    consumer->retry(KeyOpFieldsValuesTuple(ipPrefix.to_string(), DEL_COMMAND, vector<FieldValueTuple>()));
 }
 
-bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops)
+bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops, const NextHopWeights &weights)
 {
     SWSS_LOG_ENTER();
 
@@ -756,35 +1562,34 @@ bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops)
     /* The route is pointing to a next hop group */
     else
     {
-        /* Check if there is already an existing next hop group */
-        if (!hasNextHopGroup(nextHops))
+        /* Check if there is already an existing next hop group with the
+         * same weights. Groups are never reweighted in place, since other
+         * routes may share them */
+        if (!hasNextHopGroup(nextHops, weights))
         {
             /* Try to create a new next hop group */
-            if (!addNextHopGroup(nextHops))
+            if (!addNextHopGroup(nextHops, weights))
             {
-                /* Failed to create the next hop group and check if a temporary route is needed */
-
-                /* If the current next hop is part of the next hop group to sync,
-                 * then return false and no need to add another temporary route. */
-                if (it_route != m_syncdRoutes.end() && it_route->second.getSize() == 1)
+                /* Failed to create the next hop group, sync the route with a
+                 * temporary next hop (group) in the meantime. */
+                bool synced = addTempRoute(ipPrefix, nextHops);
+
+                /* When the next hop group limit is reached, the route is
+                 * upgraded once a next hop group is freed instead of being
+                 * retried on every iteration. Otherwise some next hops are
+                 * not resolved yet and the route stays in the retry queue. */
+                if (synced && m_nextHopGroupCount >= m_maxNextHopGroupCount)
                 {
-                    IpAddress ip_address(it_route->second.to_string());
-                    if (nextHops.contains(ip_address))
-                    {
-                        return false;
-                    }
+                    m_tempRoutes[ipPrefix] = make_pair(nextHops, weights);
+                    return true;
                 }
 
-                /* Add a temporary route when a next hop group cannot be added,
-                 * and there is no temporary route right now or the current temporary
-                 * route is not pointing to a member of the next hop group to sync. */
-                addTempRoute(ipPrefix, nextHops);
                 /* Return false since the original route is not successfully added */
                 return false;
             }
         }
 
-        next_hop_id = m_syncdNextHopGroups[nextHops].next_hop_group_id;
+        next_hop_id = getNextHopGroupId(nextHops, weights);
     }
 
     /* Sync the route entry */
@@ -795,60 +1600,44 @@ bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops)
 
     sai_attribute_t route_attr;
 
-    /* If the prefix is not in m_syncdRoutes, then we need to create the route
+    /* Hold the new next hop (group) until the route is programmed, so that it
+     * is not removed by a route removal programmed in the same batch */
+    increaseNextHopRefCount(nextHops, weights);
+
+    /*
+     * If the prefix is not in m_syncdRoutes, then we need to create the route
      * for this prefix with the new next hop (group) id. If the prefix is already
      * in m_syncdRoutes, then we need to update the route with a new next hop
-     * (group) id. The old next hop (group) is then not used and the reference
-     * count will decrease by 1.
+     * (group) id. The route is programmed when the route bulker is flushed, and
+     * addRoutePost() completes the update with the status of the operation.
      */
+    auto callback = [this, ipPrefix, nextHops, weights](sai_status_t status)
+    {
+        addRoutePost(ipPrefix, nextHops, weights, status);
+    };
+
     if (it_route == m_syncdRoutes.end())
     {
         route_attr.id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
         route_attr.value.oid = next_hop_id;
 
         /* Default SAI_ROUTE_ATTR_PACKET_ACTION is SAI_PACKET_ACTION_FORWARD */
-        sai_status_t status = sai_route_api->create_route_entry(&route_entry, 1, &route_attr);
-        if (status != SAI_STATUS_SUCCESS)
-        {
-            SWSS_LOG_ERROR("Failed to create route %s with next hop(s) %s",
-                    ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
-            /* Clean up the newly created next hop group entry */
-            if (nextHops.getSize() > 1)
-            {
-                removeNextHopGroup(nextHops);
-            }
-            return false;
-        }
-
-        if (route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
-        {
-            gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
-        }
-        else
-        {
-            gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
-        }
-
-        /* Increase the ref_count for the next hop (group) entry */
-        increaseNextHopRefCount(nextHops);
-        SWSS_LOG_INFO("Create route %s with next hop(s) %s",
-                ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
+        m_routeBulker.create(route_entry, { route_attr }, callback);
     }
     else
     {
-        sai_status_t status;
-
         /* Set the packet action to forward when there was no next hop (dropped) */
         if (it_route->second.getSize() == 0)
         {
             route_attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
             route_attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
 
-            status = sai_route_api->set_route_entry_attribute(&route_entry, &route_attr);
+            sai_status_t status = sai_route_api->set_route_entry_attribute(&route_entry, &route_attr);
             if (status != SAI_STATUS_SUCCESS)
             {
                 SWSS_LOG_ERROR("Failed to set route %s with packet action forward, %d",
                                ipPrefix.to_string().c_str(), status);
+                decreaseNextHopRefCount(nextHops, weights);
                 return false;
             }
         }
@@ -857,31 +1646,87 @@ bool RouteOrch::addRoute(IpPrefix ipPrefix, IpAddresses nextHops)
         route_attr.value.oid = next_hop_id;
 
         /* Set the next hop ID to a new value */
-        status = sai_route_api->set_route_entry_attribute(&route_entry, &route_attr);
-        if (status != SAI_STATUS_SUCCESS)
+        m_routeBulker.set(route_entry, route_attr, callback);
+    }
+
+    /* The route is no longer temporary once its own next hops are programmed */
+    m_tempRoutes.erase(ipPrefix);
+
+    return true;
+}
+
+/*
+ * Complete the programming of a route with the status of its create or set
+ * operation. A route which failed to be programmed is handed back to the
+ * route consumer, so it is retried in the next iteration.
+ */
+void RouteOrch::addRoutePost(const IpPrefix &ipPrefix, const IpAddresses &nextHops,
+                             const NextHopWeights &weights, sai_status_t status)
+{
+    SWSS_LOG_ENTER();
+
+    auto it_route = m_syncdRoutes.find(ipPrefix);
+
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_ERROR("Failed to %s route %s with next hop(s) %s, rv:%d",
+                it_route == m_syncdRoutes.end() ? "create" : "set",
+                ipPrefix.to_string().c_str(), nextHops.to_string().c_str(), status);
+
+        /* Release the next hop (group) held for the route, and clean up the
+         * next hop group entry if it was created for the route */
+        decreaseNextHopRefCount(nextHops, weights);
+        if (nextHops.getSize() > 1 && isRefCounterZero(nextHops, weights))
         {
-            SWSS_LOG_ERROR("Failed to set route %s with next hop(s) %s",
-                    ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
-            return false;
+            removeNextHopGroup(nextHops, weights);
+        }
+
+        /* A temporary route is retried with the next hops it stands for */
+        auto it_temp = m_tempRoutes.find(ipPrefix);
+        if (it_temp != m_tempRoutes.end())
+        {
+            auto target = it_temp->second;
+            m_tempRoutes.erase(it_temp);
+            retryRoute(ipPrefix, target.first, target.second);
         }
+        else
+        {
+            retryRoute(ipPrefix, nextHops, weights);
+        }
+        return;
+    }
 
-        /* Increase the ref_count for the next hop (group) entry */
-        increaseNextHopRefCount(nextHops);
+    if (it_route == m_syncdRoutes.end())
+    {
+        if (ipPrefix.isV4())
+        {
+            gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
+        }
+        else
+        {
+            gCrmOrch->incCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
+        }
 
-        decreaseNextHopRefCount(it_route->second);
+        SWSS_LOG_INFO("Create route %s with next hop(s) %s",
+                ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
+    }
+    else
+    {
+        /* The old next hop (group) is not used by the route anymore */
+        NextHopWeights old_weights = getSyncdRouteWeights(ipPrefix);
+        decreaseNextHopRefCount(it_route->second, old_weights);
         if (it_route->second.getSize() > 1
-            && m_syncdNextHopGroups[it_route->second].ref_count == 0)
+            && isRefCounterZero(it_route->second, old_weights))
         {
-            removeNextHopGroup(it_route->second);
+            removeNextHopGroup(it_route->second, old_weights);
         }
         SWSS_LOG_INFO("Set route %s with next hop(s) %s",
                 ipPrefix.to_string().c_str(), nextHops.to_string().c_str());
     }
 
-    m_syncdRoutes[ipPrefix] = nextHops;
+    setSyncdRoute(ipPrefix, nextHops, weights);
 
     notifyNextHopChangeObservers(ipPrefix, nextHops, true);
-    return true;
 }
 
 bool RouteOrch::removeRoute(IpPrefix ipPrefix)
@@ -922,17 +1767,23 @@ bool RouteOrch::removeRoute(IpPrefix ipPrefix)
         }
 
         SWSS_LOG_INFO("Set route %s next hop ID to NULL", ipPrefix.to_string().c_str());
+
+        removeRoutePost(ipPrefix);
+        return true;
     }
-    else
+
+    /* The route is removed when the route bulker is flushed. A route which
+     * failed to be removed is handed back to the route consumer. */
+    m_routeBulker.remove(route_entry, [this, ipPrefix](sai_status_t status)
     {
-        sai_status_t status = sai_route_api->remove_route_entry(&route_entry);
         if (status != SAI_STATUS_SUCCESS)
         {
-            SWSS_LOG_ERROR("Failed to remove route prefix:%s\n", ipPrefix.to_string().c_str());
-            return false;
+            SWSS_LOG_ERROR("Failed to remove route prefix:%s, rv:%d", ipPrefix.to_string().c_str(), status);
+            retryRouteRemoval(ipPrefix);
+            return;
         }
 
-        if (route_entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+        if (ipPrefix.isV4())
         {
             gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV4_ROUTE);
         }
@@ -941,7 +1792,17 @@ bool RouteOrch::removeRoute(IpPrefix ipPrefix)
             gCrmOrch->decCrmResUsedCounter(CrmResourceType::CRM_IPV6_ROUTE);
         }
 
-    }
+        removeRoutePost(ipPrefix);
+    });
+
+    return true;
+}
+
+/* Release the next hop (group) of a route which was removed, or dropped for the default route */
+void RouteOrch::removeRoutePost(const IpPrefix &ipPrefix)
+{
+    SWSS_LOG_ENTER();
+
     /* Remove next hop group entry if ref_count is zero */
     auto it_route = m_syncdRoutes.find(ipPrefix);
     if (it_route != m_syncdRoutes.end())
@@ -952,30 +1813,31 @@ bool RouteOrch::removeRoute(IpPrefix ipPrefix)
          * and check whether the reference count decreases to zero. If yes, then we need
          * to remove the next hop group.
          */
-        decreaseNextHopRefCount(it_route->second);
+        NextHopWeights weights = getSyncdRouteWeights(ipPrefix);
+        decreaseNextHopRefCount(it_route->second, weights);
         if (it_route->second.getSize() > 1
-            && m_syncdNextHopGroups[it_route->second].ref_count == 0)
+            && isRefCounterZero(it_route->second, weights))
         {
-            removeNextHopGroup(it_route->second);
+            removeNextHopGroup(it_route->second, weights);
         }
+
+        SWSS_LOG_INFO("Remove route %s with next hop(s) %s",
+                ipPrefix.to_string().c_str(), it_route->second.to_string().c_str());
     }
-    SWSS_LOG_INFO("Remove route %s with next hop(s) %s",
-            ipPrefix.to_string().c_str(), it_route->second.to_string().c_str());
 
     if (ipPrefix.isDefaultRoute())
     {
-        m_syncdRoutes[ipPrefix] = IpAddresses();
+        setSyncdRoute(ipPrefix, IpAddresses());
 
         /* Notify about default route next hop change */
-        notifyNextHopChangeObservers(ipPrefix, m_syncdRoutes[ipPrefix], true);
+        notifyNextHopChangeObservers(ipPrefix, IpAddresses(), true);
     }
     else
     {
-        m_syncdRoutes.erase(ipPrefix);
+        removeSyncdRoute(ipPrefix);
+        m_tempRoutes.erase(ipPrefix);
 
         /* Notify about the route next hop removal */
         notifyNextHopChangeObservers(ipPrefix, IpAddresses(), false);
     }
-
-    return true;
 }
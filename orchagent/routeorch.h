@@ -9,19 +9,41 @@
 #include "ipaddress.h"
 #include "ipaddresses.h"
 #include "ipprefix.h"
+#include "prefixtrie.h"
+#include "bulker.h"
 
 #include <map>
+#include <deque>
+#include <vector>
 
 /* Maximum next hop group number */
 #define NHGRP_MAX_SIZE 128
 
 typedef std::map<IpAddress, sai_object_id_t> NextHopGroupMembers;
+/* NextHopWeights: next hop IP address, weight. Empty for equal cost groups */
+typedef std::map<IpAddress, uint32_t> NextHopWeights;
+
+struct NextHopGroupBucket
+{
+    IpAddress               next_hop;               // next hop the bucket points to
+    sai_object_id_t         member_id;              // id of the member, null if unassigned
+};
+
+typedef std::vector<NextHopGroupBucket> NextHopGroupBuckets;
+
+enum NextHopGroupType
+{
+    NHG_TYPE_ECMP,                                  // one member per next hop
+    NHG_TYPE_RESILIENT                              // one member per bucket
+};
 
 struct NextHopGroupEntry
 {
     sai_object_id_t         next_hop_group_id;      // next hop group id
+    NextHopGroupType        type;                   // how members are programmed
     int                     ref_count;              // reference count
     NextHopGroupMembers     nhopgroup_members;      // ids of members indexed by ip address
+    NextHopGroupBuckets     nhopgroup_buckets;      // bucket table, only for resilient groups
 };
 
 struct NextHopUpdate
@@ -33,12 +55,22 @@ struct NextHopUpdate
 
 struct NextHopObserverEntry;
 
-/* NextHopGroupTable: next hop group IP addersses, NextHopGroupEntry */
-typedef std::map<IpAddresses, NextHopGroupEntry> NextHopGroupTable;
+/* NextHopGroupKey: next hop group IP addresses and their weights, so that
+ * routes with the same next hops but different weights use different groups */
+typedef std::pair<IpAddresses, NextHopWeights> NextHopGroupKey;
+/* NextHopGroupTable: next hop group IP addresses and weights, NextHopGroupEntry */
+typedef std::map<NextHopGroupKey, NextHopGroupEntry> NextHopGroupTable;
 /* RouteTable: destination network, next hop IP address(es) */
 typedef std::map<IpPrefix, IpAddresses> RouteTable;
+/* RouteWeightTable: destination network, weights of its next hops. Only
+ * routes using a weighted next hop group are present */
+typedef std::map<IpPrefix, NextHopWeights> RouteWeightTable;
 /* NextHopObserverTable: Destination IP address, next hop observer entry */
 typedef std::map<IpAddress, NextHopObserverEntry> NextHopObserverTable;
+/* TempRouteTable: destination network, next hop IP address(es) and weights to upgrade to */
+typedef std::map<IpPrefix, std::pair<IpAddresses, NextHopWeights>> TempRouteTable;
+/* RouteGenerationTable: destination network, resync generation it was last updated in */
+typedef std::map<IpPrefix, uint64_t> RouteGenerationTable;
 
 struct NextHopObserverEntry
 {
@@ -51,23 +83,26 @@ class RouteOrch : public Orch, public Subject
 public:
     RouteOrch(DBConnector *db, string tableName, NeighOrch *neighOrch);
 
-    bool hasNextHopGroup(const IpAddresses&) const;
-    sai_object_id_t getNextHopGroupId(const IpAddresses&);
+    bool hasNextHopGroup(const IpAddresses&, const NextHopWeights &weights = NextHopWeights()) const;
+    sai_object_id_t getNextHopGroupId(const IpAddresses&, const NextHopWeights &weights = NextHopWeights());
 
     void attach(Observer *, const IpAddress&);
     void detach(Observer *, const IpAddress&);
 
-    void increaseNextHopRefCount(IpAddresses);
-    void decreaseNextHopRefCount(IpAddresses);
-    bool isRefCounterZero(const IpAddresses&) const;
+    void increaseNextHopRefCount(IpAddresses, const NextHopWeights &weights = NextHopWeights());
+    void decreaseNextHopRefCount(IpAddresses, const NextHopWeights &weights = NextHopWeights());
+    bool isRefCounterZero(const IpAddresses&, const NextHopWeights &weights = NextHopWeights()) const;
 
-    bool addNextHopGroup(IpAddresses);
-    bool removeNextHopGroup(IpAddresses);
+    bool addNextHopGroup(IpAddresses, const NextHopWeights &weights = NextHopWeights());
+    bool removeNextHopGroup(IpAddresses, const NextHopWeights &weights = NextHopWeights());
 
     bool validnexthopinNextHopGroup(const IpAddress &);
     bool invalidnexthopinNextHopGroup(const IpAddress &);
 
     void notifyNextHopChangeObservers(IpPrefix, IpAddresses, bool);
+
+    void doTask();
+    void getMemoryStats(MemoryStatsTable &stats) override;
 private:
     NeighOrch *m_neighOrch;
 
@@ -75,16 +110,61 @@ private:
     int m_maxNextHopGroupCount;
     bool m_resync;
 
+    /* Current resync generation and the routes updated during it */
+    uint64_t m_resyncGeneration;
+    RouteGenerationTable m_routeGenerations;
+    /* Routes left untouched by the last resync, removed in batches */
+    std::deque<IpPrefix> m_staleRoutes;
+    SelectableTimer *m_resyncSweepTimer;
+
     RouteTable m_syncdRoutes;
+    /* Synced routes indexed by prefix, to find the routes covering an address */
+    PrefixTrie<RouteTable::iterator> m_syncdRouteTrie;
+    RouteWeightTable m_syncdRouteWeights;
     NextHopGroupTable m_syncdNextHopGroups;
 
-    NextHopObserverTable m_nextHopObservers;
+    /* Routes synced with a fallback next hop (group) because the next hop
+     * group limit was reached, with the next hops they should be using */
+    TempRouteTable m_tempRoutes;
+    bool m_nextHopGroupsChanged;
 
-    void addTempRoute(IpPrefix, IpAddresses);
-    bool addRoute(IpPrefix, IpAddresses);
+    NextHopObserverTable m_nextHopObservers;
+    /* Observed destinations indexed by address, to find the ones under a route */
+    PrefixTrie<NextHopObserverTable::iterator> m_nextHopObserverTrie;
+
+    /* Route entries are programmed when the consumer flushes the bulkers */
+    EntityBulker<sai_route_api_t> m_routeBulker;
+    /* Members are flushed by the next hop group operation queuing them */
+    ObjectBulker<sai_next_hop_group_api_t> m_nextHopGroupMemberBulker;
+
+    void setSyncdRoute(const IpPrefix &, const IpAddresses &, const NextHopWeights &weights = NextHopWeights());
+    void removeSyncdRoute(const IpPrefix &);
+    NextHopWeights getSyncdRouteWeights(const IpPrefix &) const;
+
+    void queueNextHopGroupMember(sai_object_id_t, const IpAddress &, uint32_t, sai_object_id_t &);
+    void queueNextHopGroupMemberRemoval(sai_object_id_t &);
+    bool addNextHopGroupMember(sai_object_id_t, const IpAddress &, uint32_t, sai_object_id_t &);
+    bool removeNextHopGroupMember(sai_object_id_t);
+    bool updateNextHopGroupBuckets(const NextHopGroupKey &, NextHopGroupEntry &);
+    bool removeNextHopGroupBuckets(NextHopGroupEntry &);
+    bool hasActiveNextHop(const NextHopGroupEntry &) const;
+
+    bool addTempRoute(IpPrefix, IpAddresses);
+    void upgradeTempRoutes();
+    void retryRoute(const IpPrefix &, const IpAddresses &, const NextHopWeights &);
+    void retryRouteRemoval(const IpPrefix &);
+    bool addRoute(IpPrefix, IpAddresses, const NextHopWeights &weights = NextHopWeights());
+    void addRoutePost(const IpPrefix &, const IpAddresses &, const NextHopWeights &, sai_status_t);
     bool removeRoute(IpPrefix);
+    void removeRoutePost(const IpPrefix &);
+
+    void startResync();
+    void completeResync();
+    bool isResyncInProgress() const;
+    void sweepStaleRoutes();
 
     void doTask(Consumer& consumer);
+    void doTask(SelectableTimer &timer);
 };
 
 #endif /* SWSS_ROUTEORCH_H */
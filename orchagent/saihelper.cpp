@@ -7,10 +7,12 @@ extern "C" {
 
 #include <fstream>
 #include <map>
+#include <type_traits>
 #include <logger.h>
 #include <sairedis.h>
 #include "timestamp.h"
 #include "saihelper.h"
+#include "profiler.h"
 
 using namespace std;
 using namespace swss;
@@ -99,6 +101,243 @@ const sai_service_method_table_t test_services = {
     test_profile_get_next_value
 };
 
+/*
+ * Time the SAI calls of the executors. Each method called by orchagent is
+ * replaced in a copy of its API table by a wrapper accounting the call in a
+ * SaiCallProfileScope. The tables returned by sai_api_query are left intact.
+ */
+template <typename Method, int Id>
+struct SaiProfiledMethod;
+
+template <int Id, typename... Args>
+struct SaiProfiledMethod<sai_status_t (*)(Args...), Id>
+{
+    static sai_status_t (*method)(Args...);
+
+    static sai_status_t call(Args... args)
+    {
+        SaiCallProfileScope profile;
+        return method(args...);
+    }
+};
+
+template <int Id, typename... Args>
+sai_status_t (*SaiProfiledMethod<sai_status_t (*)(Args...), Id>::method)(Args...) = nullptr;
+
+template <int Id, typename Api, typename Method>
+static void profileSaiMethod(Api *api, Method Api::*member)
+{
+    if (api == nullptr || api->*member == nullptr)
+    {
+        return;
+    }
+
+    SaiProfiledMethod<Method, Id>::method = api->*member;
+    api->*member = SaiProfiledMethod<Method, Id>::call;
+}
+
+template <typename Api>
+static Api *copySaiApi(Api *api)
+{
+    static Api copy;
+
+    if (api == nullptr)
+    {
+        return nullptr;
+    }
+
+    copy = *api;
+    return &copy;
+}
+
+/* Each wrapper needs its own instance, even for methods of the same type */
+#define PROFILE_SAI_METHOD(api, method) \
+    profileSaiMethod<__COUNTER__>(api, &std::remove_pointer<decltype(api)>::type::method)
+
+static void profileSaiApi()
+{
+    SWSS_LOG_ENTER();
+
+    sai_switch_api = copySaiApi(sai_switch_api);
+    PROFILE_SAI_METHOD(sai_switch_api, create_switch);
+    PROFILE_SAI_METHOD(sai_switch_api, get_switch_attribute);
+    PROFILE_SAI_METHOD(sai_switch_api, set_switch_attribute);
+
+    sai_bridge_api = copySaiApi(sai_bridge_api);
+    PROFILE_SAI_METHOD(sai_bridge_api, create_bridge);
+    PROFILE_SAI_METHOD(sai_bridge_api, create_bridge_port);
+    PROFILE_SAI_METHOD(sai_bridge_api, get_bridge_attribute);
+    PROFILE_SAI_METHOD(sai_bridge_api, get_bridge_port_attribute);
+    PROFILE_SAI_METHOD(sai_bridge_api, remove_bridge);
+    PROFILE_SAI_METHOD(sai_bridge_api, remove_bridge_port);
+    PROFILE_SAI_METHOD(sai_bridge_api, set_bridge_port_attribute);
+
+    sai_virtual_router_api = copySaiApi(sai_virtual_router_api);
+    PROFILE_SAI_METHOD(sai_virtual_router_api, create_virtual_router);
+    PROFILE_SAI_METHOD(sai_virtual_router_api, remove_virtual_router);
+    PROFILE_SAI_METHOD(sai_virtual_router_api, set_virtual_router_attribute);
+
+    sai_port_api = copySaiApi(sai_port_api);
+    PROFILE_SAI_METHOD(sai_port_api, create_port);
+    PROFILE_SAI_METHOD(sai_port_api, get_port_attribute);
+    PROFILE_SAI_METHOD(sai_port_api, remove_port);
+    PROFILE_SAI_METHOD(sai_port_api, set_port_attribute);
+
+    sai_vlan_api = copySaiApi(sai_vlan_api);
+    PROFILE_SAI_METHOD(sai_vlan_api, create_vlan);
+    PROFILE_SAI_METHOD(sai_vlan_api, create_vlan_member);
+    PROFILE_SAI_METHOD(sai_vlan_api, get_vlan_attribute);
+    PROFILE_SAI_METHOD(sai_vlan_api, remove_vlan);
+    PROFILE_SAI_METHOD(sai_vlan_api, remove_vlan_member);
+    PROFILE_SAI_METHOD(sai_vlan_api, set_vlan_attribute);
+
+    sai_router_intfs_api = copySaiApi(sai_router_intfs_api);
+    PROFILE_SAI_METHOD(sai_router_intfs_api, create_router_interface);
+    PROFILE_SAI_METHOD(sai_router_intfs_api, remove_router_interface);
+
+    sai_hostif_api = copySaiApi(sai_hostif_api);
+    PROFILE_SAI_METHOD(sai_hostif_api, create_hostif);
+    PROFILE_SAI_METHOD(sai_hostif_api, create_hostif_table_entry);
+    PROFILE_SAI_METHOD(sai_hostif_api, create_hostif_trap);
+    PROFILE_SAI_METHOD(sai_hostif_api, create_hostif_trap_group);
+    PROFILE_SAI_METHOD(sai_hostif_api, remove_hostif_trap_group);
+    PROFILE_SAI_METHOD(sai_hostif_api, set_hostif_attribute);
+    PROFILE_SAI_METHOD(sai_hostif_api, set_hostif_trap_attribute);
+    PROFILE_SAI_METHOD(sai_hostif_api, set_hostif_trap_group_attribute);
+
+    sai_neighbor_api = copySaiApi(sai_neighbor_api);
+    PROFILE_SAI_METHOD(sai_neighbor_api, create_neighbor_entry);
+    PROFILE_SAI_METHOD(sai_neighbor_api, remove_neighbor_entry);
+    PROFILE_SAI_METHOD(sai_neighbor_api, set_neighbor_entry_attribute);
+
+    sai_next_hop_api = copySaiApi(sai_next_hop_api);
+    PROFILE_SAI_METHOD(sai_next_hop_api, create_next_hop);
+    PROFILE_SAI_METHOD(sai_next_hop_api, remove_next_hop);
+
+    sai_next_hop_group_api = copySaiApi(sai_next_hop_group_api);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, create_next_hop_group);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, create_next_hop_group_member);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, create_next_hop_group_members);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, remove_next_hop_group);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, remove_next_hop_group_member);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, remove_next_hop_group_members);
+    PROFILE_SAI_METHOD(sai_next_hop_group_api, set_next_hop_group_member_attribute);
+
+    sai_route_api = copySaiApi(sai_route_api);
+    PROFILE_SAI_METHOD(sai_route_api, create_route_entries);
+    PROFILE_SAI_METHOD(sai_route_api, create_route_entry);
+    PROFILE_SAI_METHOD(sai_route_api, remove_route_entries);
+    PROFILE_SAI_METHOD(sai_route_api, remove_route_entry);
+    PROFILE_SAI_METHOD(sai_route_api, set_route_entries_attribute);
+    PROFILE_SAI_METHOD(sai_route_api, set_route_entry_attribute);
+
+    sai_lag_api = copySaiApi(sai_lag_api);
+    PROFILE_SAI_METHOD(sai_lag_api, create_lag);
+    PROFILE_SAI_METHOD(sai_lag_api, create_lag_member);
+    PROFILE_SAI_METHOD(sai_lag_api, remove_lag);
+    PROFILE_SAI_METHOD(sai_lag_api, remove_lag_member);
+    PROFILE_SAI_METHOD(sai_lag_api, set_lag_attribute);
+
+    sai_policer_api = copySaiApi(sai_policer_api);
+    PROFILE_SAI_METHOD(sai_policer_api, create_policer);
+    PROFILE_SAI_METHOD(sai_policer_api, remove_policer);
+    PROFILE_SAI_METHOD(sai_policer_api, set_policer_attribute);
+
+    sai_tunnel_api = copySaiApi(sai_tunnel_api);
+    PROFILE_SAI_METHOD(sai_tunnel_api, create_tunnel);
+    PROFILE_SAI_METHOD(sai_tunnel_api, create_tunnel_map);
+    PROFILE_SAI_METHOD(sai_tunnel_api, create_tunnel_map_entry);
+    PROFILE_SAI_METHOD(sai_tunnel_api, create_tunnel_term_table_entry);
+    PROFILE_SAI_METHOD(sai_tunnel_api, remove_tunnel);
+    PROFILE_SAI_METHOD(sai_tunnel_api, remove_tunnel_map_entry);
+    PROFILE_SAI_METHOD(sai_tunnel_api, remove_tunnel_term_table_entry);
+    PROFILE_SAI_METHOD(sai_tunnel_api, set_tunnel_attribute);
+    PROFILE_SAI_METHOD(sai_tunnel_api, set_tunnel_map_entry_attribute);
+    PROFILE_SAI_METHOD(sai_tunnel_api, set_tunnel_term_table_entry_attribute);
+
+    sai_queue_api = copySaiApi(sai_queue_api);
+    PROFILE_SAI_METHOD(sai_queue_api, get_queue_attribute);
+    PROFILE_SAI_METHOD(sai_queue_api, get_queue_stats);
+    PROFILE_SAI_METHOD(sai_queue_api, set_queue_attribute);
+
+    sai_scheduler_api = copySaiApi(sai_scheduler_api);
+    PROFILE_SAI_METHOD(sai_scheduler_api, create_scheduler);
+    PROFILE_SAI_METHOD(sai_scheduler_api, remove_scheduler);
+    PROFILE_SAI_METHOD(sai_scheduler_api, set_scheduler_attribute);
+
+    sai_scheduler_group_api = copySaiApi(sai_scheduler_group_api);
+    PROFILE_SAI_METHOD(sai_scheduler_group_api, get_scheduler_group_attribute);
+    PROFILE_SAI_METHOD(sai_scheduler_group_api, set_scheduler_group_attribute);
+
+    sai_wred_api = copySaiApi(sai_wred_api);
+    PROFILE_SAI_METHOD(sai_wred_api, create_wred);
+    PROFILE_SAI_METHOD(sai_wred_api, remove_wred);
+    PROFILE_SAI_METHOD(sai_wred_api, set_wred_attribute);
+
+    sai_qos_map_api = copySaiApi(sai_qos_map_api);
+    PROFILE_SAI_METHOD(sai_qos_map_api, create_qos_map);
+    PROFILE_SAI_METHOD(sai_qos_map_api, remove_qos_map);
+    PROFILE_SAI_METHOD(sai_qos_map_api, set_qos_map_attribute);
+
+    sai_buffer_api = copySaiApi(sai_buffer_api);
+    PROFILE_SAI_METHOD(sai_buffer_api, create_buffer_pool);
+    PROFILE_SAI_METHOD(sai_buffer_api, create_buffer_profile);
+    PROFILE_SAI_METHOD(sai_buffer_api, get_ingress_priority_group_attribute);
+    PROFILE_SAI_METHOD(sai_buffer_api, get_ingress_priority_group_stats);
+    PROFILE_SAI_METHOD(sai_buffer_api, remove_buffer_pool);
+    PROFILE_SAI_METHOD(sai_buffer_api, remove_buffer_profile);
+    PROFILE_SAI_METHOD(sai_buffer_api, set_buffer_pool_attribute);
+    PROFILE_SAI_METHOD(sai_buffer_api, set_buffer_profile_attribute);
+    PROFILE_SAI_METHOD(sai_buffer_api, set_ingress_priority_group_attribute);
+
+    sai_acl_api = copySaiApi(sai_acl_api);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_counter);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_entry);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_range);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_table);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_table_group);
+    PROFILE_SAI_METHOD(sai_acl_api, create_acl_table_group_member);
+    PROFILE_SAI_METHOD(sai_acl_api, get_acl_counter_attribute);
+    PROFILE_SAI_METHOD(sai_acl_api, get_acl_table_attribute);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_counter);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_entry);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_range);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_table);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_table_group);
+    PROFILE_SAI_METHOD(sai_acl_api, remove_acl_table_group_member);
+
+    sai_mirror_api = copySaiApi(sai_mirror_api);
+    PROFILE_SAI_METHOD(sai_mirror_api, set_mirror_session_attribute);
+
+    sai_fdb_api = copySaiApi(sai_fdb_api);
+    PROFILE_SAI_METHOD(sai_fdb_api, create_fdb_entry);
+    PROFILE_SAI_METHOD(sai_fdb_api, flush_fdb_entries);
+    PROFILE_SAI_METHOD(sai_fdb_api, get_fdb_entry_attribute);
+    PROFILE_SAI_METHOD(sai_fdb_api, remove_fdb_entry);
+    PROFILE_SAI_METHOD(sai_fdb_api, set_fdb_entry_attribute);
+
+    sai_dtel_api = copySaiApi(sai_dtel_api);
+    PROFILE_SAI_METHOD(sai_dtel_api, create_dtel);
+    PROFILE_SAI_METHOD(sai_dtel_api, create_dtel_event);
+    PROFILE_SAI_METHOD(sai_dtel_api, create_dtel_int_session);
+    PROFILE_SAI_METHOD(sai_dtel_api, create_dtel_queue_report);
+    PROFILE_SAI_METHOD(sai_dtel_api, create_dtel_report_session);
+    PROFILE_SAI_METHOD(sai_dtel_api, remove_dtel);
+    PROFILE_SAI_METHOD(sai_dtel_api, remove_dtel_event);
+    PROFILE_SAI_METHOD(sai_dtel_api, remove_dtel_int_session);
+    PROFILE_SAI_METHOD(sai_dtel_api, remove_dtel_queue_report);
+    PROFILE_SAI_METHOD(sai_dtel_api, remove_dtel_report_session);
+    PROFILE_SAI_METHOD(sai_dtel_api, set_dtel_attribute);
+    PROFILE_SAI_METHOD(sai_dtel_api, set_dtel_queue_report_attribute);
+
+    sai_bmtor_api = copySaiApi(sai_bmtor_api);
+    PROFILE_SAI_METHOD(sai_bmtor_api, create_table_bitmap_classification_entry);
+    PROFILE_SAI_METHOD(sai_bmtor_api, create_table_bitmap_router_entry);
+    PROFILE_SAI_METHOD(sai_bmtor_api, create_table_meta_tunnel_entry);
+    PROFILE_SAI_METHOD(sai_bmtor_api, remove_table_bitmap_classification_entry);
+    PROFILE_SAI_METHOD(sai_bmtor_api, remove_table_bitmap_router_entry);
+}
+
 void initSaiApi()
 {
     SWSS_LOG_ENTER();
@@ -156,6 +395,8 @@ void initSaiApi()
     sai_log_set(SAI_API_ACL,                    SAI_LOG_LEVEL_NOTICE);
     sai_log_set(SAI_API_DTEL,                   SAI_LOG_LEVEL_NOTICE);
     sai_log_set((sai_api_t)SAI_API_BMTOR,       SAI_LOG_LEVEL_NOTICE);
+
+    profileSaiApi();
 }
 
 void initSaiRedis(const string &record_location)
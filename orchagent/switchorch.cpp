@@ -39,6 +39,14 @@ SwitchOrch::SwitchOrch(DBConnector *db, string tableName) :
     m_restartCheckNotificationConsumer = new NotificationConsumer(db, "RESTARTCHECK");
     auto restartCheckNotifier = new Notifier(m_restartCheckNotificationConsumer, this, "RESTARTCHECK");
     Orch::addExecutor(restartCheckNotifier);
+
+    m_profileDumpNotificationConsumer = new NotificationConsumer(db, "PROFILEDUMP");
+    auto profileDumpNotifier = new Notifier(m_profileDumpNotificationConsumer, this, "PROFILEDUMP");
+    Orch::addExecutor(profileDumpNotifier);
+
+    m_pendingTasksNotificationConsumer = new NotificationConsumer(db, "PENDINGTASKS");
+    auto pendingTasksNotifier = new Notifier(m_pendingTasksNotificationConsumer, this, "PENDINGTASKS");
+    Orch::addExecutor(pendingTasksNotifier);
 }
 
 void SwitchOrch::doTask(Consumer &consumer)
@@ -153,6 +161,34 @@ void SwitchOrch::doTask(NotificationConsumer& consumer)
 
     consumer.pop(op, data, values);
 
+    if (&consumer == m_profileDumpNotificationConsumer)
+    {
+        SWSS_LOG_NOTICE("PROFILEDUMP notification for %s ", op.c_str());
+        if (op == "orchagent")
+        {
+            m_profileDumpRequested = true;
+        }
+        return;
+    }
+
+    if (&consumer == m_pendingTasksNotificationConsumer)
+    {
+        SWSS_LOG_NOTICE("PENDINGTASKS notification for %s ", op.c_str());
+        if (op == "orchagent")
+        {
+            m_pendingTasksQuery.requested = true;
+            m_pendingTasksQuery.full = false;
+            for (auto &i : values)
+            {
+                if (fvField(i) == "Full" && fvValue(i) == "true")
+                {
+                    m_pendingTasksQuery.full = true;
+                }
+            }
+        }
+        return;
+    }
+
     if (&consumer != m_restartCheckNotificationConsumer)
     {
         return;
@@ -161,6 +197,7 @@ void SwitchOrch::doTask(NotificationConsumer& consumer)
     m_warmRestartCheck.checkRestartReadyState = false;
     m_warmRestartCheck.noFreeze = false;
     m_warmRestartCheck.skipPendingTaskCheck = false;
+    m_warmRestartCheck.dumpPendingTasks = false;
 
     SWSS_LOG_NOTICE("RESTARTCHECK notification for %s ", op.c_str());
     if (op == "orchagent")
@@ -180,6 +217,10 @@ void SwitchOrch::doTask(NotificationConsumer& consumer)
             {
                 m_warmRestartCheck.skipPendingTaskCheck = true;
             }
+            if (fvField(i) == "DumpPendingTasks" && fvValue(i) == "true")
+            {
+                m_warmRestartCheck.dumpPendingTasks = true;
+            }
         }
         SWSS_LOG_NOTICE("%s", s.c_str());
     }
@@ -192,6 +233,20 @@ void SwitchOrch::restartCheckReply(const string &op, const string &data, std::ve
     checkRestartReadyDone();
 }
 
+void SwitchOrch::profileDumpReply(const string &op, const string &data, std::vector<FieldValueTuple> &values)
+{
+    NotificationProducer profileDumpReply(m_db, "PROFILEDUMPREPLY");
+    profileDumpReply.send(op, data, values);
+    m_profileDumpRequested = false;
+}
+
+void SwitchOrch::pendingTasksQueryReply(const string &op, const string &data, std::vector<FieldValueTuple> &values)
+{
+    NotificationProducer pendingTasksReply(m_db, "PENDINGTASKSREPLY");
+    pendingTasksReply.send(op, data, values);
+    m_pendingTasksQuery.requested = false;
+}
+
 bool SwitchOrch::setAgingFDB(uint32_t sec)
 {
     sai_attribute_t attr;
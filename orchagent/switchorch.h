@@ -7,6 +7,13 @@ struct WarmRestartCheck
     bool    checkRestartReadyState;
     bool    noFreeze;
     bool    skipPendingTaskCheck;
+    bool    dumpPendingTasks;
+};
+
+struct PendingTasksQuery
+{
+    bool    requested;
+    bool    full;
 };
 
 class SwitchOrch : public Orch
@@ -17,17 +24,31 @@ public:
     bool checkRestartReady() { return m_warmRestartCheck.checkRestartReadyState; }
     bool checkRestartNoFreeze() { return m_warmRestartCheck.noFreeze; }
     bool skipPendingTaskCheck() { return m_warmRestartCheck.skipPendingTaskCheck; }
+    bool checkRestartDumpPendingTasks() { return m_warmRestartCheck.dumpPendingTasks; }
     void checkRestartReadyDone() { m_warmRestartCheck.checkRestartReadyState = false; }
     void restartCheckReply(const string &op, const string &data, std::vector<FieldValueTuple> &values);
+    bool checkProfileDump() { return m_profileDumpRequested; }
+    void profileDumpReply(const string &op, const string &data, std::vector<FieldValueTuple> &values);
+    bool checkPendingTasksQuery() { return m_pendingTasksQuery.requested; }
+    bool checkPendingTasksQueryFull() { return m_pendingTasksQuery.full; }
+    void pendingTasksQueryReply(const string &op, const string &data, std::vector<FieldValueTuple> &values);
     bool setAgingFDB(uint32_t sec);
 private:
     void doTask(Consumer &consumer);
 
     NotificationConsumer* m_restartCheckNotificationConsumer;
+    NotificationConsumer* m_profileDumpNotificationConsumer;
+    NotificationConsumer* m_pendingTasksNotificationConsumer;
     void doTask(NotificationConsumer& consumer);
     DBConnector *m_db;
 
     // Information contained in the request from
     // external program for orchagent pre-shutdown state check
-    WarmRestartCheck m_warmRestartCheck = {false, false, false};
+    WarmRestartCheck m_warmRestartCheck = {false, false, false, false};
+
+    // Whether an external program asked for the profiling counters
+    bool m_profileDumpRequested = false;
+
+    // Request from external program for the pending tasks of orchagent
+    PendingTasksQuery m_pendingTasksQuery = {false, false};
 };
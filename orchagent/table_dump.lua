@@ -0,0 +1,22 @@
+-- KEYS - keys of the table to read, e.g. "ROUTE_TABLE:10.0.0.0/24"
+-- ARGV[1] - length of the table name and separator prefixing the keys
+-- return flat list of: key, number of fields and values, field, value, ...
+-- keys are returned without the table name and separator, keys removed
+-- since they were scanned are skipped
+
+local prefix_len = tonumber(ARGV[1])
+
+local rets = {}
+
+for i = 1, #KEYS do
+    local fvs = redis.call('HGETALL', KEYS[i])
+    if #fvs > 0 then
+        table.insert(rets, string.sub(KEYS[i], prefix_len + 1))
+        table.insert(rets, #fvs)
+        for j = 1, #fvs do
+            table.insert(rets, fvs[j])
+        end
+    end
+end
+
+return rets
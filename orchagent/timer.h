@@ -20,6 +20,7 @@ public:
 
     void execute()
     {
+        ExecutorProfileScope profile(m_stats);
         m_orch->doTask(*getSelectableTimer());
     }
 };
@@ -298,7 +298,7 @@ bool TunnelDecapOrch::addDecapTunnel(string key, string type, IpAddresses dst_ip
 
 /**
  * Function Description:
- *    @brief adds a decap tunnel termination entry to ASIC_DB
+ *    @brief creates the decap tunnel termination entries of a tunnel
  *
  * Arguments:
  *    @param[in] tunnelKey - key of the tunnel from APP_DB
@@ -308,7 +308,7 @@ bool TunnelDecapOrch::addDecapTunnel(string key, string type, IpAddresses dst_ip
  * Return Values:
  *    @return true on success and false if there's an error
  */
-bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, IpAddresses dst_ip, sai_object_id_t tunnel_id)
+bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, const IpAddresses &dst_ip, sai_object_id_t tunnel_id)
 {
     SWSS_LOG_ENTER();
 
@@ -332,48 +332,73 @@ bool TunnelDecapOrch::addDecapTunnelTermEntries(string tunnelKey, IpAddresses ds
     attr.value.oid = tunnel_id;
     tunnel_table_entry_attrs.push_back(attr);
 
-    TunnelEntry *tunnel_info = &tunnelTable.find(tunnelKey)->second;
+    const TunnelTermTable &tunnel_terms = tunnelTable.find(tunnelKey)->second.tunnel_term_info;
 
-    // loop through the IP list and create a new tunnel table entry for every IP (in network byte order)
-    set<IpAddress> tunnel_ips = dst_ip.getIpAddresses();
-    for (auto it = tunnel_ips.begin(); it != tunnel_ips.end(); ++it)
+    // loop through the IP list and create a new tunnel table entry for every IP not terminated yet
+    for (const auto &ia : dst_ip.getIpAddresses())
     {
-        const IpAddress& ia = *it;
         string ip = ia.to_string();
 
-        // check if the there's an entry already for the ip
+        // the tunnel already has an entry for the ip
+        if (tunnel_terms.find(ip) != tunnel_terms.end())
+        {
+            continue;
+        }
+
+        // check if the there's an entry already for the ip in another tunnel
         if (existingIps.find(ip) != existingIps.end())
         {
             SWSS_LOG_ERROR("%s already exists. Did not create entry.", ip.c_str());
+            continue;
         }
-        else
+
+        if (!addDecapTunnelTermEntry(tunnelKey, ia, tunnel_table_entry_attrs))
         {
-            attr.id = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP;
-            copy(attr.value.ipaddr, ia);
-            tunnel_table_entry_attrs.push_back(attr);
-
-            // create the tunnel table entry
-            sai_object_id_t tunnel_term_table_entry_id;
-            sai_status_t status = sai_tunnel_api->create_tunnel_term_table_entry(&tunnel_term_table_entry_id, gSwitchId, (uint32_t)tunnel_table_entry_attrs.size(), tunnel_table_entry_attrs.data());
-            if (status != SAI_STATUS_SUCCESS)
-            {
-                SWSS_LOG_ERROR("Failed to create tunnel entry table for ip: %s", ip.c_str());
-                return false;
-            }
+            return false;
+        }
+    }
+    return true;
+}
 
-            // insert into ip to entry mapping
-            existingIps.insert(ip);
+/**
+ * Function Description:
+ *    @brief creates a decap tunnel termination entry
+ *
+ * Arguments:
+ *    @param[in] tunnelKey - key of the tunnel from APP_DB
+ *    @param[in] ip - destination ip address to decap
+ *    @param[in] attrs - tunnel term entry attributes, but the destination ip
+ *
+ * Return Values:
+ *    @return true on success and false if there's an error
+ */
+bool TunnelDecapOrch::addDecapTunnelTermEntry(string tunnelKey, const IpAddress &ip, const vector<sai_attribute_t> &attrs)
+{
+    string ip_str = ip.to_string();
 
-            // insert entry id and ip into tunnel mapping
-            tunnel_info->tunnel_term_info.push_back({ tunnel_term_table_entry_id, ip });
+    vector<sai_attribute_t> tunnel_table_entry_attrs(attrs);
+    sai_attribute_t attr;
+    attr.id = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP;
+    copy(attr.value.ipaddr, ip);
+    tunnel_table_entry_attrs.push_back(attr);
 
-            // pop the last element for the next loop
-            tunnel_table_entry_attrs.pop_back();
+    // create the tunnel table entry
+    sai_object_id_t tunnel_term_id;
+    sai_status_t status = sai_tunnel_api->create_tunnel_term_table_entry(&tunnel_term_id, gSwitchId,
+            (uint32_t)tunnel_table_entry_attrs.size(), tunnel_table_entry_attrs.data());
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        SWSS_LOG_ERROR("Failed to create tunnel entry table for ip: %s", ip_str.c_str());
+        return false;
+    }
 
-            SWSS_LOG_NOTICE("Created tunnel entry for ip: %s", ip.c_str());
-        }
+    // insert into ip to entry mapping
+    existingIps.insert(ip_str);
 
-    }
+    // insert entry id and ip into tunnel mapping
+    tunnelTable[tunnelKey].tunnel_term_info[ip_str] = { tunnel_term_id, ip_str };
+
+    SWSS_LOG_NOTICE("Created tunnel entry for ip: %s", ip_str.c_str());
     return true;
 }
 
@@ -458,35 +483,35 @@ bool TunnelDecapOrch::setTunnelAttribute(string field, string value, sai_object_
  * Return Values:
  *    @return true on success and false if there's an error
  */
-bool TunnelDecapOrch::setIpAttribute(string key, IpAddresses new_ip_addresses, sai_object_id_t tunnel_id)
+bool TunnelDecapOrch::setIpAttribute(string key, const IpAddresses &new_ip_addresses, sai_object_id_t tunnel_id)
 {
     TunnelEntry *tunnel_info = &tunnelTable.find(key)->second;
 
-    // make a copy of tunnel_term_info to loop through
-    vector<TunnelTermEntry> tunnel_term_info_copy(tunnel_info->tunnel_term_info);
-
-    tunnel_info->tunnel_term_info.clear();
+    unordered_set<string> new_ips;
+    for (const auto &ia : new_ip_addresses.getIpAddresses())
+    {
+        new_ips.insert(ia.to_string());
+    }
 
-    // loop through original ips and remove ips not in the new ip_addresses
-    for (auto it = tunnel_term_info_copy.begin(); it != tunnel_term_info_copy.end(); ++it)
+    // collect the original ips not in the new ip_addresses, the entries are removed below
+    vector<string> removed_ips;
+    for (const auto &term : tunnel_info->tunnel_term_info)
     {
-        TunnelTermEntry tunnel_entry_info = *it;
-        string ip = tunnel_entry_info.ip_address;
-        if (!new_ip_addresses.contains(ip))
+        if (new_ips.find(term.first) == new_ips.end())
         {
-            if (!removeDecapTunnelTermEntry(tunnel_entry_info.tunnel_term_id, ip))
-            {
-                return false;
-            }
+            removed_ips.push_back(term.first);
         }
-        else
+    }
+
+    for (const auto &ip : removed_ips)
+    {
+        if (!removeDecapTunnelTermEntry(key, ip))
         {
-            // add the data into the tunnel_term_info
-            tunnel_info->tunnel_term_info.push_back({ tunnel_entry_info.tunnel_term_id, ip });
+            return false;
         }
     }
 
-    // add all the new ip addresses
+    // add the ip addresses the tunnel doesn't have yet
     if(!addDecapTunnelTermEntries(key, new_ip_addresses, tunnel_id))
     {
         return false;
@@ -508,20 +533,23 @@ bool TunnelDecapOrch::setIpAttribute(string key, IpAddresses new_ip_addresses, s
 bool TunnelDecapOrch::removeDecapTunnel(string key)
 {
     sai_status_t status;
+
     TunnelEntry *tunnel_info = &tunnelTable.find(key)->second;
 
-    // loop through the tunnel entry ids related to the tunnel and remove them before removing the tunnel
-    for (auto it = tunnel_info->tunnel_term_info.begin(); it != tunnel_info->tunnel_term_info.end(); ++it)
+    vector<string> ips;
+    for (const auto &term : tunnel_info->tunnel_term_info)
+    {
+        ips.push_back(term.first);
+    }
+
+    for (const auto &ip : ips)
     {
-        TunnelTermEntry tunnel_entry_info = *it;
-        if (!removeDecapTunnelTermEntry(tunnel_entry_info.tunnel_term_id, tunnel_entry_info.ip_address))
+        if (!removeDecapTunnelTermEntry(key, ip))
         {
             return false;
         }
     }
 
-    tunnel_info->tunnel_term_info = {};
-
     status = sai_tunnel_api->remove_tunnel(tunnel_info->tunnel_id);
     if (status != SAI_STATUS_SUCCESS)
     {
@@ -543,25 +571,34 @@ bool TunnelDecapOrch::removeDecapTunnel(string key)
 
 /**
  * Function Description:
- *    @brief remove decap tunnel termination entry
+ *    @brief removes a decap tunnel termination entry
  *
  * Arguments:
- *    @param[in] key - key of the tunnel from APP_DB
+ *    @param[in] tunnelKey - key of the tunnel from APP_DB
+ *    @param[in] ip - destination ip address of the entry
  *
  * Return Values:
  *    @return true on success and false if there's an error
  */
-bool TunnelDecapOrch::removeDecapTunnelTermEntry(sai_object_id_t tunnel_term_id, string ip)
+bool TunnelDecapOrch::removeDecapTunnelTermEntry(string tunnelKey, string ip)
 {
-    sai_status_t status;
+    TunnelTermTable &tunnel_terms = tunnelTable.find(tunnelKey)->second.tunnel_term_info;
+
+    auto it = tunnel_terms.find(ip);
+    if (it == tunnel_terms.end())
+    {
+        return true;
+    }
 
-    status = sai_tunnel_api->remove_tunnel_term_table_entry(tunnel_term_id);
+    sai_status_t status = sai_tunnel_api->remove_tunnel_term_table_entry(it->second.tunnel_term_id);
     if (status != SAI_STATUS_SUCCESS)
     {
-        SWSS_LOG_ERROR("Failed to remove tunnel table entry: %lu", tunnel_term_id);
+        SWSS_LOG_ERROR("Failed to remove tunnel table entry: %lu", it->second.tunnel_term_id);
         return false;
     }
 
+    tunnel_terms.erase(it);
+
     // making sure to remove all instances of the ip address
     existingIps.erase(ip);
     SWSS_LOG_NOTICE("Removed decap tunnel term entry with ip address: %s", ip.c_str());
@@ -2,6 +2,7 @@
 #define SWSS_TUNNELDECAPORCH_H
 
 #include <arpa/inet.h>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "orch.h"
@@ -11,19 +12,22 @@
 
 struct TunnelTermEntry
 {
-    sai_object_id_t            tunnel_term_id;
+    sai_object_id_t            tunnel_term_id;         // tunnel term entry id
     string                     ip_address;
 };
 
+/* TunnelTermTable: destination ip string, tunnel term entry */
+typedef unordered_map<string, TunnelTermEntry> TunnelTermTable;
+
 struct TunnelEntry
 {
     sai_object_id_t            tunnel_id;              // tunnel id
     sai_object_id_t            overlay_intf_id;        // overlay interface id
-    vector<TunnelTermEntry>    tunnel_term_info;       // tunnel_entry ids related to the tunnel abd ips related to the tunnel (all ips for tunnel entries that refer to this tunnel)
+    TunnelTermTable            tunnel_term_info;       // tunnel term entries of the tunnel, by destination ip
 };
 
 /* TunnelTable: key string, tunnel object id */
-typedef map<string, TunnelEntry> TunnelTable;
+typedef unordered_map<string, TunnelEntry> TunnelTable;
 
 /* ExistingIps: ips that currently have term entries */
 typedef unordered_set<string> ExistingIps;
@@ -40,11 +44,12 @@ private:
     bool addDecapTunnel(string key, string type, IpAddresses dst_ip, IpAddress* p_src_ip, string dscp, string ecn, string ttl);
     bool removeDecapTunnel(string key);
 
-    bool addDecapTunnelTermEntries(string tunnelKey, IpAddresses dst_ip, sai_object_id_t tunnel_id);
-    bool removeDecapTunnelTermEntry(sai_object_id_t tunnel_term_id, string ip);
+    bool addDecapTunnelTermEntries(string tunnelKey, const IpAddresses &dst_ip, sai_object_id_t tunnel_id);
+    bool addDecapTunnelTermEntry(string tunnelKey, const IpAddress &ip, const vector<sai_attribute_t> &attrs);
+    bool removeDecapTunnelTermEntry(string tunnelKey, string ip);
 
     bool setTunnelAttribute(string field, string value, sai_object_id_t existing_tunnel_id);
-    bool setIpAttribute(string key, IpAddresses new_ip_addresses, sai_object_id_t tunnel_id);
+    bool setIpAttribute(string key, const IpAddresses &new_ip_addresses, sai_object_id_t tunnel_id);
 
     void doTask(Consumer& consumer);
 };
@@ -393,9 +393,10 @@ void VxlanTunnel::insertMapperEntry(sai_object_id_t encap, sai_object_id_t decap
 
 std::pair<sai_object_id_t, sai_object_id_t> VxlanTunnel::getMapperEntry(uint32_t vni)
 {
-    if (tunnel_map_entries_.find(vni) != tunnel_map_entries_.end())
+    auto it = tunnel_map_entries_.find(vni);
+    if (it != tunnel_map_entries_.end())
     {
-        return tunnel_map_entries_[vni];
+        return it->second;
     }
 
     return std::make_pair(SAI_NULL_OBJECT_ID, SAI_NULL_OBJECT_ID);
@@ -423,7 +424,7 @@ sai_object_id_t VxlanTunnel::getNextHop(IpAddress& ipAddr, MacAddress macAddress
         return SAI_NULL_OBJECT_ID;
     }
 
-    return nh_tunnels_.at(key).nh_id;
+    return it->second.nh_id;
 }
 
 void VxlanTunnel::incNextHopRefCount(IpAddress& ipAddr, MacAddress macAddress, uint32_t vni)
@@ -449,20 +450,20 @@ bool VxlanTunnel::removeNextHop(IpAddress& ipAddr, MacAddress macAddress, uint32
         return false;
     }
 
-    SWSS_LOG_INFO("NH tunnel for ip '%s' ref_count '%d'", ipAddr.to_string().c_str(), nh_tunnels_[key].ref_count);
+    SWSS_LOG_INFO("NH tunnel for ip '%s' ref_count '%d'", ipAddr.to_string().c_str(), it->second.ref_count);
 
     //Decrement ref count if already exists
-    nh_tunnels_[key].ref_count --;
+    it->second.ref_count --;
 
-    if (!nh_tunnels_[key].ref_count)
+    if (!it->second.ref_count)
     {
-        if (sai_next_hop_api->remove_next_hop(nh_tunnels_[key].nh_id) != SAI_STATUS_SUCCESS)
+        if (sai_next_hop_api->remove_next_hop(it->second.nh_id) != SAI_STATUS_SUCCESS)
         {
             string err_msg = "NH tunnel delete failed for " + ipAddr.to_string();
             throw std::runtime_error(err_msg);
         }
 
-        nh_tunnels_.erase(key);
+        nh_tunnels_.erase(it);
     }
 
     SWSS_LOG_INFO("NH tunnel for ip '%s', mac '%s' updated/deleted",
@@ -54,11 +54,32 @@ struct nh_key_t
 
 struct nh_key_hash
 {
+    /* FNV-1a over the raw key fields, the key is hashed for every tunnel route */
+    static size_t hashBytes(size_t hash, const void *data, size_t len)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < len; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
     size_t operator() (const nh_key_t& key) const
     {
-        stringstream ss;
-        ss << key.ip_addr.to_string() << key.mac_address.to_string() << std::to_string(key.vni);
-        return std::hash<std::string>() (ss.str());
+        const ip_addr_t ip = key.ip_addr.getIp();
+        size_t hash = 14695981039346656037ULL;
+
+        if (ip.family == AF_INET)
+        {
+            hash = hashBytes(hash, &ip.ip_addr.ipv4_addr, sizeof(ip.ip_addr.ipv4_addr));
+        }
+        else
+        {
+            hash = hashBytes(hash, ip.ip_addr.ipv6_addr, sizeof(ip.ip_addr.ipv6_addr));
+        }
+        hash = hashBytes(hash, key.mac_address.getMac(), ETHER_ADDR_LEN);
+        return hashBytes(hash, &key.vni, sizeof(key.vni));
     }
 };
 
@@ -68,7 +89,9 @@ struct nh_tunnel_t
     int             ref_count;
 };
 
-typedef std::map<uint32_t, std::pair<sai_object_id_t, sai_object_id_t>> TunnelMapEntries;
+/* TunnelMapEntries: vni, encap and decap tunnel map entries */
+typedef std::unordered_map<uint32_t, std::pair<sai_object_id_t, sai_object_id_t>> TunnelMapEntries;
+/* TunnelNHs: tunnel next hops of a tunnel, shared by all the VNETs using the tunnel */
 typedef std::unordered_map<nh_key_t, nh_tunnel_t, nh_key_hash> TunnelNHs;
 
 class VxlanTunnel
@@ -193,7 +216,8 @@ const request_description_t vxlan_tunnel_map_request_description = {
             { "vni", "vlan" }
 };
 
-typedef std::map<std::string, sai_object_id_t> VxlanTunnelMapTable;
+/* VxlanTunnelMapTable: tunnel map entry full key, tunnel map entry */
+typedef std::unordered_map<std::string, sai_object_id_t> VxlanTunnelMapTable;
 
 class VxlanTunnelMapRequest : public Request
 {
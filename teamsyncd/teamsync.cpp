@@ -19,10 +19,11 @@ using namespace swss;
 /* Taken from drivers/net/team/team.c */
 #define TEAM_DRV_NAME "team"
 
-TeamSync::TeamSync(DBConnector *db, DBConnector *stateDb, Select *select) :
+TeamSync::TeamSync(RedisPipeline *pipeline, DBConnector *stateDb, Select *select) :
     m_select(select),
-    m_lagTable(db, APP_LAG_TABLE_NAME),
-    m_lagMemberTable(db, APP_LAG_MEMBER_TABLE_NAME),
+    m_pipeline(pipeline),
+    m_lagTable(pipeline, APP_LAG_TABLE_NAME, true),
+    m_lagMemberTable(pipeline, APP_LAG_MEMBER_TABLE_NAME, true),
     m_stateLagTable(stateDb, STATE_LAG_TABLE_NAME)
 {
     WarmStart::initialize(TEAMSYNCD_APP_NAME, "teamd");
@@ -54,7 +55,45 @@ void TeamSync::periodic()
         }
     }
 
+    doChangeTask();
     doSelectableTask();
+
+    /* Write the LAG and LAG member updates of this wakeup at once */
+    m_pipeline->flush();
+}
+
+void TeamSync::doChangeTask()
+{
+    for (const auto &lagName : m_changedLags)
+    {
+        auto it = m_teamSelectables.find(lagName);
+        if (it != m_teamSelectables.end())
+        {
+            it->second->onChange();
+        }
+    }
+
+    m_changedLags.clear();
+}
+
+bool TeamSync::getIfName(struct team_handle *team, uint32_t ifindex, string &ifname)
+{
+    auto it = m_ifNames.find(ifindex);
+    if (it != m_ifNames.end())
+    {
+        ifname = it->second;
+        return true;
+    }
+
+    char name[TeamPortSync::MAX_IFNAME + 1] = {0};
+    if (!team_ifindex2ifname(team, ifindex, name, TeamPortSync::MAX_IFNAME))
+    {
+        return false;
+    }
+
+    ifname = name;
+    m_ifNames[ifindex] = ifname;
+    return true;
 }
 
 void TeamSync::doSelectableTask()
@@ -101,6 +140,17 @@ void TeamSync::onMsg(int nlmsg_type, struct nl_object *obj)
         return;
 
     string lagName = rtnl_link_get_name(link);
+    uint32_t ifindex = static_cast<uint32_t>(rtnl_link_get_ifindex(link));
+
+    /* Cache the names of all links, used to resolve the LAG members */
+    if (nlmsg_type == RTM_DELLINK)
+    {
+        m_ifNames.erase(ifindex);
+    }
+    else
+    {
+        m_ifNames[ifindex] = lagName;
+    }
 
     /* Listens to LAG messages */
     char *type = rtnl_link_get_type(link);
@@ -150,7 +200,7 @@ void TeamSync::addLag(const string &lagName, int ifindex, bool admin_state,
     }
 
     /* Create the team instance */
-    auto sync = make_shared<TeamPortSync>(lagName, ifindex, &m_lagMemberTable);
+    auto sync = make_shared<TeamPortSync>(lagName, ifindex, this);
     m_teamSelectables[lagName] = sync;
     m_selectablesToAdd.insert(lagName);
 }
@@ -158,10 +208,13 @@ void TeamSync::addLag(const string &lagName, int ifindex, bool admin_state,
 void TeamSync::removeLag(const string &lagName)
 {
     /* Delete all members */
-    auto selectable = m_teamSelectables[lagName];
-    for (auto it : selectable->m_lagMembers)
+    auto selectable = m_teamSelectables.find(lagName);
+    if (selectable != m_teamSelectables.end())
     {
-        m_lagMemberTable.del(lagName + ":" + it.first);
+        for (auto it : selectable->second->m_lagMembers)
+        {
+            m_lagMemberTable.del(lagName + ":" + it.first);
+        }
     }
 
     /* Delete the LAG */
@@ -170,9 +223,11 @@ void TeamSync::removeLag(const string &lagName)
     SWSS_LOG_INFO("Remove %s", lagName.c_str());
 
     /* Return when the team instance hasn't been tracked before */
-    if (m_teamSelectables.find(lagName) == m_teamSelectables.end())
+    if (selectable == m_teamSelectables.end())
         return;
 
+    m_changedLags.erase(lagName);
+
     if (m_warmstart)
     {
         m_stateLagTablePreserved.erase(lagName);
@@ -190,9 +245,9 @@ const struct team_change_handler TeamSync::TeamPortSync::gPortChangeHandler = {
     .type_mask  = TEAM_PORT_CHANGE | TEAM_OPTION_CHANGE
 };
 
-TeamSync::TeamPortSync::TeamPortSync(const string &lagName, int ifindex,
-                                     ProducerStateTable *lagMemberTable) :
-    m_lagMemberTable(lagMemberTable),
+TeamSync::TeamPortSync::TeamPortSync(const string &lagName, int ifindex, TeamSync *sync) :
+    m_sync(sync),
+    m_lagMemberTable(&sync->m_lagMemberTable),
     m_lagName(lagName),
     m_ifindex(ifindex)
 {
@@ -246,13 +301,13 @@ int TeamSync::TeamPortSync::onChange()
     team_for_each_port(port, m_team)
     {
         uint32_t ifindex;
-        char ifname[MAX_IFNAME + 1] = {0};
+        string ifname;
         bool enabled;
 
         ifindex = team_get_port_ifindex(port);
 
         /* Skip if interface is not found */
-        if (!team_ifindex2ifname(m_team, ifindex, ifname, MAX_IFNAME))
+        if (!m_sync->getIfName(m_team, ifindex, ifname))
         {
             SWSS_LOG_INFO("Interface ifindex(%u) is not found", ifindex);
             continue;
@@ -265,7 +320,7 @@ int TeamSync::TeamPortSync::onChange()
         }
 
         team_get_port_enabled(m_team, ifindex, &enabled);
-        tmp_lag_members[string(ifname)] = enabled;
+        tmp_lag_members[ifname] = enabled;
     }
 
     /* Compare old and new LAG members and set/del accordingly */
@@ -298,7 +353,10 @@ int TeamSync::TeamPortSync::onChange()
 int TeamSync::TeamPortSync::teamdHandler(struct team_handle *team, void *arg,
                                          team_change_type_mask_t type_mask)
 {
-    return ((TeamSync::TeamPortSync *)arg)->onChange();
+    /* Coalesce the changes, the members are synced once per wakeup */
+    auto sync = (TeamSync::TeamPortSync *)arg;
+    sync->m_sync->m_changedLags.insert(sync->m_lagName);
+    return 0;
 }
 
 int TeamSync::TeamPortSync::getFd()
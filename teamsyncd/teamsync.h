@@ -4,8 +4,10 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include "dbconnector.h"
 #include "producerstatetable.h"
+#include "redispipeline.h"
 #include "selectable.h"
 #include "select.h"
 #include "netmsg.h"
@@ -22,7 +24,7 @@ namespace swss {
 class TeamSync : public NetMsg
 {
 public:
-    TeamSync(DBConnector *db, DBConnector *stateDb, Select *select);
+    TeamSync(RedisPipeline *pipeline, DBConnector *stateDb, Select *select);
 
     void periodic();
 
@@ -33,21 +35,23 @@ public:
     {
     public:
         enum { MAX_IFNAME = 64 };
-        TeamPortSync(const std::string &lagName, int ifindex,
-                     ProducerStateTable *lagMemberTable);
+        TeamPortSync(const std::string &lagName, int ifindex, TeamSync *sync);
         ~TeamPortSync();
 
         int getFd() override;
         void readData() override;
 
+        /* Sync the LAG members with the team instance */
+        int onChange();
+
         /* member_name -> enabled|disabled */
         std::map<std::string, bool> m_lagMembers;
     protected:
-        int onChange();
         static int teamdHandler(struct team_handle *th, void *arg,
                                 team_change_type_mask_t type_mask);
         static const struct team_change_handler gPortChangeHandler;
     private:
+        TeamSync *m_sync;
         ProducerStateTable *m_lagMemberTable;
         struct team_handle *m_team;
         std::string m_lagName;
@@ -65,8 +69,15 @@ protected:
     /* Handle all selectables add/removal events */
     void doSelectableTask();
 
+    /* Sync the members of the LAGs changed since the last call */
+    void doChangeTask();
+
+    /* Resolve a port name, from the link notifications when possible */
+    bool getIfName(struct team_handle *team, uint32_t ifindex, std::string &ifname);
+
 private:
     Select *m_select;
+    RedisPipeline *m_pipeline;
     ProducerStateTable m_lagTable;
     ProducerStateTable m_lagMemberTable;
     Table m_stateLagTable;
@@ -80,6 +91,12 @@ private:
     std::set<std::string> m_selectablesToAdd;
     std::set<std::string> m_selectablesToRemove;
     std::map<std::string, std::shared_ptr<TeamPortSync> > m_teamSelectables;
+
+    /* LAGs whose team instance notified changes, synced by doChangeTask */
+    std::set<std::string> m_changedLags;
+
+    /* ifindex -> name of the kernel links */
+    std::unordered_map<uint32_t, std::string> m_ifNames;
 };
 
 }
@@ -9,13 +9,17 @@
 using namespace std;
 using namespace swss;
 
+/* Events handled before syncing the changed LAGs */
+#define MAX_EVENTS_PER_SYNC 1024
+
 int main(int argc, char **argv)
 {
     swss::Logger::linkToDbNative(TEAMSYNCD_APP_NAME);
     DBConnector db(APPL_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    RedisPipeline pipeline(&db);
     DBConnector stateDb(STATE_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
     Select s;
-    TeamSync sync(&db, &stateDb, &s);
+    TeamSync sync(&pipeline, &stateDb, &s);
 
     NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &sync);
     NetDispatcher::getInstance().registerMessageHandler(RTM_DELLINK, &sync);
@@ -35,6 +39,16 @@ int main(int argc, char **argv)
             {
                 Selectable *temps;
                 s.select(&temps, 1000); // block for a second
+
+                /* Handle the events already pending, so that they are synced together */
+                for (int i = 0; i < MAX_EVENTS_PER_SYNC; i++)
+                {
+                    if (s.select(&temps, 0) != Select::OBJECT)
+                    {
+                        break;
+                    }
+                }
+
                 sync.periodic();
             }
         }
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "orchtest.h"
+
+using namespace std;
+using namespace swss;
+
+extern sai_acl_api_t *sai_acl_api;
+
+class AclOrchTest : public ::testing::Test, public OrchTest
+{
+protected:
+    void SetUp() override
+    {
+        init();
+    }
+
+    void TearDown() override
+    {
+        deinit();
+    }
+
+    void setTable(const string &table)
+    {
+        doTask(gAclOrch, CFG_ACL_TABLE_NAME,
+                { table, SET_COMMAND, { { "policy_desc", table }, { "type", "L3" }, { "ports", "Ethernet0" } } });
+    }
+
+    void setRule(const string &table, const string &rule, const string &action)
+    {
+        doTask(gAclOrch, CFG_ACL_RULE_TABLE_NAME,
+                { table + "|" + rule, SET_COMMAND, {
+                    { "PRIORITY", "10" },
+                    { "SRC_IP", "10.0.0.1/32" },
+                    { "PACKET_ACTION", action } } });
+    }
+
+    void delRule(const string &table, const string &rule)
+    {
+        doTask(gAclOrch, CFG_ACL_RULE_TABLE_NAME, { table + "|" + rule, DEL_COMMAND, {} });
+    }
+
+    /* Packet action of the only ACL entry */
+    sai_packet_action_t getPacketAction()
+    {
+        vector<sai_object_id_t> entries = StubSai::getInstance().getObjects(SAI_OBJECT_TYPE_ACL_ENTRY);
+        EXPECT_EQ(entries.size(), 1u);
+        if (entries.size() != 1)
+        {
+            return SAI_PACKET_ACTION_FORWARD;
+        }
+
+        sai_attribute_t attr;
+        attr.id = SAI_ACL_ENTRY_ATTR_ACTION_PACKET_ACTION;
+        EXPECT_EQ(sai_acl_api->get_acl_entry_attribute(entries[0], 1, &attr), SAI_STATUS_SUCCESS);
+        return static_cast<sai_packet_action_t>(attr.value.aclaction.parameter.s32);
+    }
+
+    size_t pendingRuleTasks()
+    {
+        return getPendingTaskCount(gAclOrch, CFG_ACL_RULE_TABLE_NAME);
+    }
+};
+
+TEST_F(AclOrchTest, rule_create_update_remove)
+{
+    StubSai &sai = StubSai::getInstance();
+
+    setTable("DATAACL");
+    ASSERT_NE(gAclOrch->getTableById("DATAACL"), SAI_NULL_OBJECT_ID);
+
+    setRule("DATAACL", "RULE_1", "FORWARD");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_ENTRY), 1u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_COUNTER), 1u);
+    EXPECT_EQ(getPacketAction(), SAI_PACKET_ACTION_FORWARD);
+
+    /* An update replaces the entry and its counter */
+    setRule("DATAACL", "RULE_1", "DROP");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_ENTRY), 1u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_COUNTER), 1u);
+    EXPECT_EQ(getPacketAction(), SAI_PACKET_ACTION_DROP);
+
+    delRule("DATAACL", "RULE_1");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_ENTRY), 0u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ACL_COUNTER), 0u);
+    EXPECT_EQ(pendingRuleTasks(), 0u);
+}
+
+TEST_F(AclOrchTest, rule_waits_for_table)
+{
+    setRule("DATAACL", "RULE_1", "DROP");
+    EXPECT_EQ(StubSai::getInstance().getObjectCount(SAI_OBJECT_TYPE_ACL_ENTRY), 0u);
+    EXPECT_EQ(pendingRuleTasks(), 1u);
+
+    /* Rules are run before tables, the pending one is created on the next run */
+    setTable("DATAACL");
+    gAclOrch->doTask();
+    EXPECT_EQ(getPacketAction(), SAI_PACKET_ACTION_DROP);
+    EXPECT_EQ(pendingRuleTasks(), 0u);
+}
+
+TEST_F(AclOrchTest, invalid_rule_is_dropped)
+{
+    setTable("DATAACL");
+
+    /* A rule without any match is rejected rather than retried */
+    doTask(gAclOrch, CFG_ACL_RULE_TABLE_NAME,
+            { "DATAACL|RULE_1", SET_COMMAND, { { "PRIORITY", "10" }, { "PACKET_ACTION", "DROP" } } });
+    EXPECT_EQ(StubSai::getInstance().getObjectCount(SAI_OBJECT_TYPE_ACL_ENTRY), 0u);
+    EXPECT_EQ(pendingRuleTasks(), 0u);
+}
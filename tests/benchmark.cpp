@@ -0,0 +1,406 @@
+/*
+ * Micro-benchmarks of the orchagent hot paths. The route, next hop group,
+ * FDB and ACL ones run the real orchs on top of the stub SAI, see
+ * orchtest.h, so a local redis server is needed. Each benchmark prints one
+ * JSON object per line, so that the results can be collected and compared
+ * over releases:
+ *
+ *   benchmark [-f <name filter>] [-s <scale divider>]
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "orchtest.h"
+#include "prefixtrie.h"
+#include "request_parser.h"
+
+using namespace std;
+using namespace swss;
+
+static string name_filter;
+static size_t scale = 1;
+
+static OrchTest orchs;
+
+/* Run fn, which performs ops operations, and print its results */
+static void run(const string &name, size_t size, size_t ops, const function<void()> &fn)
+{
+    if (!name_filter.empty() && name.find(name_filter) == string::npos)
+    {
+        return;
+    }
+
+    StubSai &sai = StubSai::getInstance();
+    uint64_t calls = sai.getCallCount();
+    uint64_t bulk_calls = sai.getBulkCallCount();
+
+    auto start = chrono::steady_clock::now();
+    fn();
+    auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    cout << "{\"name\": \"" << name << "\""
+         << ", \"size\": " << size
+         << ", \"ops\": " << ops
+         << ", \"total_ns\": " << elapsed
+         << ", \"ns_per_op\": " << (ops ? static_cast<double>(elapsed) / static_cast<double>(ops) : 0.0)
+         << ", \"sai_calls\": " << sai.getCallCount() - calls
+         << ", \"sai_bulk_calls\": " << sai.getBulkCallCount() - bulk_calls
+         << "}" << endl;
+}
+
+/* Synthetic generators */
+
+static string prefixString(size_t index)
+{
+    uint32_t addr = 0x0a000000 + static_cast<uint32_t>(index << 8);
+    return to_string(addr >> 24) + "." + to_string((addr >> 16) & 0xff) + "." +
+           to_string((addr >> 8) & 0xff) + ".0/24";
+}
+
+static string macString(size_t index)
+{
+    char mac[18];
+    snprintf(mac, sizeof(mac), "02:00:00:%02zx:%02zx:%02zx",
+             (index >> 16) & 0xff, (index >> 8) & 0xff, index & 0xff);
+    return mac;
+}
+
+/* Run the tasks on the orch, and report the ones left pending */
+static void doTasks(Orch *orch, const string &tableName, const vector<KeyOpFieldsValuesTuple> &tasks)
+{
+    orchs.doTasks(orch, tableName, tasks);
+
+    size_t pending = orchs.getPendingTaskCount(orch, tableName);
+    if (pending)
+    {
+        cerr << pending << " tasks of " << tableName << " left pending" << endl;
+    }
+}
+
+/* Benchmarks */
+
+static const request_description_t route_request_description = {
+    { REQ_T_IP_PREFIX },
+    {
+        { "nexthop",    REQ_T_STRING },
+        { "ifname",     REQ_T_STRING },
+        { "weight",     REQ_T_STRING },
+        { "blackhole",  REQ_T_BOOL },
+    },
+    { }
+};
+
+class RouteRequest : public Request
+{
+public:
+    RouteRequest() : Request(route_request_description, ':') { }
+};
+
+static void benchRequestParse(size_t count)
+{
+    vector<KeyOpFieldsValuesTuple> tuples;
+    for (size_t i = 0; i < count; i++)
+    {
+        tuples.emplace_back(prefixString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "nexthop", "10.255.0.1,10.255.0.2" },
+                { "ifname", "Ethernet0,Ethernet4" },
+                { "weight", "1,2" },
+                { "blackhole", "false" } });
+    }
+
+    RouteRequest request;
+    run("request_parse", count, count, [&]()
+    {
+        for (const auto &tuple : tuples)
+        {
+            request.parse(tuple);
+            request.clear();
+        }
+    });
+}
+
+/* Consumer without a table, fed directly with popped tasks */
+class BenchConsumer : public Consumer
+{
+public:
+    BenchConsumer() : Consumer(nullptr, nullptr, "BENCH") { }
+
+    using Consumer::addToSync;
+};
+
+/* Tasks popped from a table, new ones then updates merged into the pending ones */
+static void benchConsumerMerge(size_t count)
+{
+    deque<KeyOpFieldsValuesTuple> sets;
+    deque<KeyOpFieldsValuesTuple> updates;
+    for (size_t i = 0; i < count; i++)
+    {
+        sets.emplace_back(prefixString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "nexthop", "10.255.0.1,10.255.0.2" },
+                { "ifname", "Ethernet0,Ethernet4" } });
+        updates.emplace_back(prefixString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "nexthop", "10.255.0.1,10.255.0.3" },
+                { "ifname", "Ethernet0,Ethernet8" },
+                { "weight", "1,2" } });
+    }
+
+    BenchConsumer consumer;
+    run("consumer_add", count, count, [&]()
+    {
+        consumer.addToSync(sets);
+    });
+
+    run("consumer_merge", count, count, [&]()
+    {
+        consumer.addToSync(updates);
+    });
+}
+
+static void benchRouteIndex(size_t count)
+{
+    PrefixTrie<size_t> trie;
+    vector<IpPrefix> prefixes;
+    for (size_t i = 0; i < count; i++)
+    {
+        prefixes.emplace_back(prefixString(i));
+    }
+
+    run("route_index_add", count, count, [&]()
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            trie.insert(prefixes[i], i);
+        }
+    });
+
+    size_t found = 0;
+    run("route_index_covering", count, count, [&]()
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            trie.visitCovering(prefixes[i].getIp(), [&found](size_t &) { found++; });
+        }
+    });
+
+    run("route_index_remove", count, count, [&]()
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            trie.erase(prefixes[i]);
+        }
+    });
+}
+
+static void benchRoute(size_t count)
+{
+    vector<KeyOpFieldsValuesTuple> sets;
+    vector<KeyOpFieldsValuesTuple> dels;
+    for (size_t i = 0; i < count; i++)
+    {
+        sets.emplace_back(prefixString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "nexthop", "192.168.0.1,192.168.1.1" },
+                { "ifname", "Ethernet0,Ethernet4" } });
+        dels.emplace_back(prefixString(i), DEL_COMMAND, vector<FieldValueTuple>{});
+    }
+
+    run("route_add", count, count, [&]()
+    {
+        doTasks(gRouteOrch, APP_ROUTE_TABLE_NAME, sets);
+    });
+
+    run("route_remove", count, count, [&]()
+    {
+        doTasks(gRouteOrch, APP_ROUTE_TABLE_NAME, dels);
+    });
+}
+
+/*
+ * One route per group, each group holding a member behind Ethernet0, which
+ * goes down and up in turn as with a flapping link. The orchs are told as
+ * PortsOrch does on a port oper status change.
+ */
+static void benchNextHopGroupFlap(size_t groups, size_t flaps)
+{
+    vector<KeyOpFieldsValuesTuple> sets;
+    vector<KeyOpFieldsValuesTuple> dels;
+    for (size_t i = 0; i < groups; i++)
+    {
+        string ip = "192.168.1." + to_string(i + 2);
+        orchs.addNeighbor("Ethernet4", ip, macString(i + 2));
+
+        sets.emplace_back(prefixString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "nexthop", "192.168.0.1," + ip },
+                { "ifname", "Ethernet0,Ethernet4" } });
+        dels.emplace_back(prefixString(i), DEL_COMMAND, vector<FieldValueTuple>{});
+    }
+    doTasks(gRouteOrch, APP_ROUTE_TABLE_NAME, sets);
+
+    run("nhg_member_flap", groups, flaps * groups * 2, [&]()
+    {
+        for (size_t flap = 0; flap < flaps; flap++)
+        {
+            gNeighOrch->ifChangeInformNextHop("Ethernet0", false);
+            gNeighOrch->ifChangeInformNextHop("Ethernet0", true);
+        }
+    });
+
+    doTasks(gRouteOrch, APP_ROUTE_TABLE_NAME, dels);
+}
+
+/* MAC addresses configured then removed, and learnt then aged out all at once */
+static void benchFdb(size_t count)
+{
+    vector<KeyOpFieldsValuesTuple> sets;
+    vector<KeyOpFieldsValuesTuple> dels;
+    for (size_t i = 0; i < count; i++)
+    {
+        sets.emplace_back("Vlan2:" + macString(i), SET_COMMAND, vector<FieldValueTuple>{
+                { "port", "Ethernet0" },
+                { "type", "static" } });
+        dels.emplace_back("Vlan2:" + macString(i), DEL_COMMAND, vector<FieldValueTuple>{});
+    }
+
+    run("fdb_add", count, count, [&]()
+    {
+        doTasks(gFdbOrch, APP_FDB_TABLE_NAME, sets);
+    });
+
+    run("fdb_remove", count, count, [&]()
+    {
+        doTasks(gFdbOrch, APP_FDB_TABLE_NAME, dels);
+    });
+
+    Port vlan, port;
+    gPortsOrch->getPort("Vlan2", vlan);
+    gPortsOrch->getPort("Ethernet0", port);
+
+    vector<sai_fdb_entry_t> entries(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        memset(&entries[i], 0, sizeof(entries[i]));
+        entries[i].switch_id = gSwitchId;
+        entries[i].bv_id = vlan.m_vlan_info.vlan_oid;
+        memcpy(entries[i].mac_address, MacAddress(macString(i)).getMac(), sizeof(sai_mac_t));
+    }
+
+    run("fdb_learn", count, count, [&]()
+    {
+        for (const auto &entry : entries)
+        {
+            gFdbOrch->update(SAI_FDB_EVENT_LEARNED, &entry, port.m_bridge_port_id);
+        }
+    });
+
+    run("fdb_age", count, count, [&]()
+    {
+        for (const auto &entry : entries)
+        {
+            gFdbOrch->update(SAI_FDB_EVENT_AGED, &entry, port.m_bridge_port_id);
+        }
+    });
+}
+
+/* ACL rules created, then their action updated, then removed */
+static void benchAclRule(size_t count)
+{
+    auto rules = [count](const string &op, const string &action)
+    {
+        vector<KeyOpFieldsValuesTuple> tasks;
+        for (size_t i = 0; i < count; i++)
+        {
+            vector<FieldValueTuple> fvs;
+            if (op == SET_COMMAND)
+            {
+                fvs = {
+                    { "PRIORITY", to_string(i + 1) },
+                    { "SRC_IP", prefixString(i) },
+                    { "PACKET_ACTION", action } };
+            }
+            tasks.emplace_back("DATAACL|RULE_" + to_string(i), op, fvs);
+        }
+        return tasks;
+    };
+
+    vector<KeyOpFieldsValuesTuple> creates = rules(SET_COMMAND, "FORWARD");
+    vector<KeyOpFieldsValuesTuple> updates = rules(SET_COMMAND, "DROP");
+    vector<KeyOpFieldsValuesTuple> dels = rules(DEL_COMMAND, "");
+
+    run("acl_rule_create", count, count, [&]()
+    {
+        doTasks(gAclOrch, CFG_ACL_RULE_TABLE_NAME, creates);
+    });
+
+    run("acl_rule_update", count, count, [&]()
+    {
+        doTasks(gAclOrch, CFG_ACL_RULE_TABLE_NAME, updates);
+    });
+
+    run("acl_rule_remove", count, count, [&]()
+    {
+        doTasks(gAclOrch, CFG_ACL_RULE_TABLE_NAME, dels);
+    });
+}
+
+static void usage()
+{
+    cout << "Usage: benchmark [-f <name filter>] [-s <scale divider>]" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "f:s:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'f':
+                name_filter = optarg;
+                break;
+            case 's':
+                scale = max(1UL, stoul(optarg));
+                break;
+            default:
+                usage();
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    Logger::setMinPrio(Logger::SWSS_ERROR);
+
+    /* Two routed ports with a neighbor each, Ethernet0 in Vlan2, and an ACL table bound to it */
+    orchs.init(2);
+    orchs.addInterface("Ethernet0", "192.168.0.0/24");
+    orchs.addInterface("Ethernet4", "192.168.1.0/24");
+    orchs.addNeighbor("Ethernet0", "192.168.0.1", "00:00:00:00:00:01");
+    orchs.addNeighbor("Ethernet4", "192.168.1.1", "00:00:00:00:00:02");
+    orchs.doTask(gPortsOrch, APP_VLAN_TABLE_NAME, { "Vlan2", SET_COMMAND, {} });
+    orchs.doTask(gPortsOrch, APP_VLAN_MEMBER_TABLE_NAME,
+            { "Vlan2:Ethernet0", SET_COMMAND, { { "tagging_mode", "tagged" } } });
+    orchs.doTask(gAclOrch, CFG_ACL_TABLE_NAME,
+            { "DATAACL", SET_COMMAND, { { "policy_desc", "DATAACL" }, { "type", "L3" }, { "ports", "Ethernet0" } } });
+
+    benchRequestParse(100000 / scale);
+    benchConsumerMerge(100000 / scale);
+
+    for (size_t count : { 100000UL, 1000000UL })
+    {
+        benchRouteIndex(count / scale);
+        benchRoute(count / scale);
+    }
+
+    benchNextHopGroupFlap(200, 1000 / scale);
+    benchFdb(100000 / scale);
+    benchAclRule(10000 / scale);
+
+    orchs.deinit();
+    return 0;
+}
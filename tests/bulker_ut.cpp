@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "bulker.h"
+
+using namespace std;
+
+static vector<string> calls;
+static sai_status_t bulk_status;
+
+static sai_status_t create_route_entry(const sai_route_entry_t *, uint32_t, const sai_attribute_t *)
+{
+    calls.push_back("create");
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t remove_route_entry(const sai_route_entry_t *)
+{
+    calls.push_back("remove");
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t create_route_entries(uint32_t count, const sai_route_entry_t *, const uint32_t *,
+        const sai_attribute_t **, sai_bulk_op_error_mode_t, sai_status_t *statuses)
+{
+    calls.push_back("create_bulk:" + to_string(count));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        statuses[i] = bulk_status == SAI_STATUS_SUCCESS && i == 1 ? SAI_STATUS_FAILURE : SAI_STATUS_SUCCESS;
+    }
+    return bulk_status;
+}
+
+static sai_status_t remove_route_entries(uint32_t count, const sai_route_entry_t *,
+        sai_bulk_op_error_mode_t, sai_status_t *)
+{
+    calls.push_back("remove_bulk:" + to_string(count));
+    return bulk_status;
+}
+
+static sai_route_api_t make_route_api()
+{
+    sai_route_api_t api = {};
+    api.create_route_entry = create_route_entry;
+    api.remove_route_entry = remove_route_entry;
+    api.create_route_entries = create_route_entries;
+    api.remove_route_entries = remove_route_entries;
+    return api;
+}
+
+TEST(bulker, route_runs_in_order)
+{
+    sai_route_api_t api = make_route_api();
+    EntityBulker<sai_route_api_t> bulker(&api);
+    sai_route_entry_t entry = {};
+    vector<sai_status_t> results;
+
+    calls.clear();
+    bulk_status = SAI_STATUS_SUCCESS;
+
+    for (int i = 0; i < 3; i++)
+    {
+        bulker.create(entry, {}, [&](sai_status_t status) { results.push_back(status); });
+    }
+    bulker.remove(entry);
+    bulker.create(entry, {});
+    EXPECT_EQ(bulker.size(), 5u);
+
+    bulker.flush();
+    EXPECT_EQ(bulker.size(), 0u);
+
+    vector<string> expected = { "create_bulk:3", "remove_bulk:1", "create_bulk:1" };
+    EXPECT_EQ(calls, expected);
+
+    vector<sai_status_t> expected_results = { SAI_STATUS_SUCCESS, SAI_STATUS_FAILURE, SAI_STATUS_SUCCESS };
+    EXPECT_EQ(results, expected_results);
+}
+
+TEST(bulker, route_fallback_to_single_calls)
+{
+    sai_route_api_t api = make_route_api();
+    EntityBulker<sai_route_api_t> bulker(&api);
+    sai_route_entry_t entry = {};
+
+    calls.clear();
+    bulk_status = SAI_STATUS_NOT_IMPLEMENTED;
+
+    bulker.create(entry, {});
+    bulker.create(entry, {});
+    bulker.remove(entry);
+    bulker.flush();
+
+    vector<string> expected = { "create_bulk:2", "create", "create", "remove_bulk:1", "remove" };
+    EXPECT_EQ(calls, expected);
+}
+
+TEST(bulker, callback_queues_operation)
+{
+    sai_route_api_t api = make_route_api();
+    EntityBulker<sai_route_api_t> bulker(&api);
+    sai_route_entry_t entry = {};
+
+    calls.clear();
+    bulk_status = SAI_STATUS_NOT_IMPLEMENTED;
+
+    bulker.create(entry, {}, [&](sai_status_t) { bulker.remove(entry); });
+    bulker.flush();
+
+    vector<string> expected = { "create_bulk:1", "create", "remove_bulk:1", "remove" };
+    EXPECT_EQ(calls, expected);
+    EXPECT_EQ(bulker.size(), 0u);
+}
+
+TEST(bulker, failed_bulk_call_fails_unfilled_entries)
+{
+    sai_route_api_t api = make_route_api();
+    EntityBulker<sai_route_api_t> bulker(&api);
+    sai_route_entry_t entry = {};
+    vector<sai_status_t> results;
+
+    calls.clear();
+    bulk_status = SAI_STATUS_INSUFFICIENT_RESOURCES;
+
+    for (int i = 0; i < 2; i++)
+    {
+        bulker.remove(entry, [&](sai_status_t status) { results.push_back(status); });
+    }
+    bulker.flush();
+
+    vector<sai_status_t> expected_results = { SAI_STATUS_INSUFFICIENT_RESOURCES, SAI_STATUS_INSUFFICIENT_RESOURCES };
+    EXPECT_EQ(results, expected_results);
+}
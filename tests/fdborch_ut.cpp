@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "orchtest.h"
+
+using namespace std;
+using namespace swss;
+
+class FdbOrchTest : public ::testing::Test, public OrchTest
+{
+protected:
+    void SetUp() override
+    {
+        init();
+
+        doTask(gPortsOrch, APP_VLAN_TABLE_NAME, { "Vlan2", SET_COMMAND, {} });
+        addVlanMember("Ethernet0");
+    }
+
+    void TearDown() override
+    {
+        deinit();
+    }
+
+    void addVlanMember(const string &alias)
+    {
+        doTask(gPortsOrch, APP_VLAN_MEMBER_TABLE_NAME,
+                { "Vlan2:" + alias, SET_COMMAND, { { "tagging_mode", "tagged" } } });
+    }
+
+    void setFdb(const string &mac, const string &alias)
+    {
+        doTask(gFdbOrch, APP_FDB_TABLE_NAME,
+                { "Vlan2:" + mac, SET_COMMAND, { { "port", alias }, { "type", "static" } } });
+    }
+
+    void delFdb(const string &mac)
+    {
+        doTask(gFdbOrch, APP_FDB_TABLE_NAME, { "Vlan2:" + mac, DEL_COMMAND, {} });
+    }
+
+    sai_fdb_entry_t fdbEntry(const string &mac)
+    {
+        Port vlan;
+        gPortsOrch->getPort("Vlan2", vlan);
+
+        sai_fdb_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+
+        entry.switch_id = gSwitchId;
+        entry.bv_id = vlan.m_vlan_info.vlan_oid;
+        memcpy(entry.mac_address, MacAddress(mac).getMac(), sizeof(sai_mac_t));
+        return entry;
+    }
+
+    bool hasFdb(const string &mac)
+    {
+        return StubSai::getInstance().hasFdb(fdbEntry(mac));
+    }
+
+    sai_object_id_t getBridgePortId(const string &alias)
+    {
+        Port port;
+        gPortsOrch->getPort(alias, port);
+        return port.m_bridge_port_id;
+    }
+};
+
+TEST_F(FdbOrchTest, fdb_add_remove)
+{
+    setFdb("00:00:00:00:00:01", "Ethernet0");
+    EXPECT_TRUE(hasFdb("00:00:00:00:00:01"));
+    EXPECT_EQ(getPendingTaskCount(gFdbOrch, APP_FDB_TABLE_NAME), 0u);
+
+    delFdb("00:00:00:00:00:01");
+    EXPECT_FALSE(hasFdb("00:00:00:00:00:01"));
+    EXPECT_EQ(getPendingTaskCount(gFdbOrch, APP_FDB_TABLE_NAME), 0u);
+}
+
+TEST_F(FdbOrchTest, fdb_waits_for_vlan_member)
+{
+    /* The entry is saved until its port gets a bridge port */
+    setFdb("00:00:00:00:00:01", "Ethernet4");
+    EXPECT_FALSE(hasFdb("00:00:00:00:00:01"));
+
+    addVlanMember("Ethernet4");
+    EXPECT_TRUE(hasFdb("00:00:00:00:00:01"));
+}
+
+TEST_F(FdbOrchTest, learned_fdb_is_stored)
+{
+    Table stateTable(m_stateDb.get(), STATE_FDB_TABLE_NAME);
+    string key = "Vlan2:00:00:00:00:00:01";
+    vector<FieldValueTuple> fvs;
+
+    sai_fdb_entry_t entry = fdbEntry("00:00:00:00:00:01");
+    gFdbOrch->update(SAI_FDB_EVENT_LEARNED, &entry, getBridgePortId("Ethernet0"));
+
+    ASSERT_TRUE(stateTable.get(key, fvs));
+    map<string, string> values(fvs.begin(), fvs.end());
+    EXPECT_EQ(values["port"], "Ethernet0");
+    EXPECT_EQ(values["type"], "dynamic");
+
+    gFdbOrch->update(SAI_FDB_EVENT_AGED, &entry, getBridgePortId("Ethernet0"));
+    EXPECT_FALSE(stateTable.get(key, fvs));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "memorystats.h"
+
+using namespace std;
+using namespace swss;
+
+TEST(memorystats, strings)
+{
+    EXPECT_EQ(heapBytes(string("Ethernet0")), 0u);
+
+    string alias(100, 'x');
+    EXPECT_EQ(heapBytes(alias), alias.capacity() + 1);
+}
+
+TEST(memorystats, containers)
+{
+    vector<uint32_t> ids = { 1, 2, 3 };
+    EXPECT_EQ(heapBytes(ids), ids.capacity() * sizeof(uint32_t));
+
+    map<uint32_t, string> names;
+    EXPECT_EQ(heapBytes(names), 0u);
+
+    names[1] = "short";
+    uint64_t node = sizeof(pair<const uint32_t, string>) + MEMORY_TREE_NODE_OVERHEAD;
+    EXPECT_EQ(heapBytes(names), node);
+
+    names[2] = string(100, 'x');
+    EXPECT_EQ(heapBytes(names), 2 * node + names[2].capacity() + 1);
+
+    MemoryStats stats = containerMemoryStats(names);
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.bytes, sizeof(names) + heapBytes(names));
+}
+
+TEST(memorystats, pending_tasks)
+{
+    typedef tuple<string, string, vector<pair<string, string>>> Task;
+    string value(64, 'x');
+    Task task("10.0.0.0/24", "SET", { { "nexthop", value } });
+
+    vector<pair<string, string>> &fvs = get<2>(task);
+    EXPECT_EQ(heapBytes(task), fvs.capacity() * sizeof(pair<string, string>) + value.capacity() + 1);
+
+    IpAddresses nexthops("10.0.0.1,10.0.0.2");
+    EXPECT_EQ(heapBytes(nexthops), 2 * (sizeof(IpAddress) + MEMORY_TREE_NODE_OVERHEAD));
+}
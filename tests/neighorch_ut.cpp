@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+
+#include "orchtest.h"
+#include "swssnet.h"
+
+using namespace std;
+using namespace swss;
+
+extern sai_neighbor_api_t *sai_neighbor_api;
+
+class NeighOrchTest : public ::testing::Test, public OrchTest
+{
+protected:
+    void SetUp() override
+    {
+        init();
+
+        addInterface("Ethernet0", "10.0.0.0/24");
+    }
+
+    void TearDown() override
+    {
+        deinit();
+    }
+
+    void setNeighbor(const string &alias, const string &ip, const string &mac)
+    {
+        doTask(gNeighOrch, APP_NEIGH_TABLE_NAME,
+                { alias + ":" + ip, SET_COMMAND, { { "neigh", mac }, { "family", "IPv4" } } });
+    }
+
+    void delNeighbor(const string &alias, const string &ip)
+    {
+        doTask(gNeighOrch, APP_NEIGH_TABLE_NAME, { alias + ":" + ip, DEL_COMMAND, {} });
+    }
+
+    sai_neighbor_entry_t neighborEntry(const string &alias, const string &ip)
+    {
+        Port port;
+        gPortsOrch->getPort(alias, port);
+
+        sai_neighbor_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+
+        entry.switch_id = gSwitchId;
+        entry.rif_id = port.m_rif_id;
+        copy(entry.ip_address, IpAddress(ip));
+        return entry;
+    }
+
+    bool hasNeighbor(const string &alias, const string &ip)
+    {
+        return StubSai::getInstance().hasNeighbor(neighborEntry(alias, ip));
+    }
+
+    MacAddress getNeighborMac(const string &alias, const string &ip)
+    {
+        sai_neighbor_entry_t entry = neighborEntry(alias, ip);
+
+        sai_attribute_t attr;
+        attr.id = SAI_NEIGHBOR_ENTRY_ATTR_DST_MAC_ADDRESS;
+        EXPECT_EQ(sai_neighbor_api->get_neighbor_entry_attribute(&entry, 1, &attr), SAI_STATUS_SUCCESS);
+        return MacAddress(attr.value.mac);
+    }
+
+    size_t pendingNeighborTasks()
+    {
+        return getPendingTaskCount(gNeighOrch, APP_NEIGH_TABLE_NAME);
+    }
+};
+
+TEST_F(NeighOrchTest, neighbor_add_update_remove)
+{
+    StubSai &sai = StubSai::getInstance();
+
+    setNeighbor("Ethernet0", "10.0.0.1", "00:00:00:00:00:01");
+    EXPECT_TRUE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_TRUE(gNeighOrch->hasNextHop(IpAddress("10.0.0.1")));
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP), 1u);
+
+    /* A new MAC address updates the entry in place */
+    setNeighbor("Ethernet0", "10.0.0.1", "00:00:00:00:00:02");
+    EXPECT_EQ(getNeighborMac("Ethernet0", "10.0.0.1"), MacAddress("00:00:00:00:00:02"));
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP), 1u);
+
+    delNeighbor("Ethernet0", "10.0.0.1");
+    EXPECT_FALSE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_FALSE(gNeighOrch->hasNextHop(IpAddress("10.0.0.1")));
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP), 0u);
+    EXPECT_EQ(pendingNeighborTasks(), 0u);
+}
+
+TEST_F(NeighOrchTest, neighbor_waits_for_interface)
+{
+    setNeighbor("Ethernet4", "10.0.1.1", "00:00:00:00:00:01");
+    EXPECT_EQ(pendingNeighborTasks(), 1u);
+
+    /* The pending task is retried once the router interface exists */
+    addInterface("Ethernet4", "10.0.1.0/24");
+    gNeighOrch->doTask();
+    EXPECT_TRUE(hasNeighbor("Ethernet4", "10.0.1.1"));
+    EXPECT_EQ(pendingNeighborTasks(), 0u);
+}
+
+TEST_F(NeighOrchTest, referenced_neighbor_is_kept)
+{
+    setNeighbor("Ethernet0", "10.0.0.1", "00:00:00:00:00:01");
+    doTask(gRouteOrch, APP_ROUTE_TABLE_NAME,
+            { "192.168.1.0/24", SET_COMMAND, { { "nexthop", "10.0.0.1" }, { "ifname", "Ethernet0" } } });
+
+    /* The removal waits for the route using the next hop to go away */
+    delNeighbor("Ethernet0", "10.0.0.1");
+    EXPECT_TRUE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_EQ(pendingNeighborTasks(), 1u);
+
+    doTask(gRouteOrch, APP_ROUTE_TABLE_NAME, { "192.168.1.0/24", DEL_COMMAND, {} });
+    gNeighOrch->doTask();
+    EXPECT_FALSE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_EQ(pendingNeighborTasks(), 0u);
+}
+
+TEST_F(NeighOrchTest, failed_neighbor_is_retried)
+{
+    StubSai::getInstance().failNext(SAI_STATUS_INSUFFICIENT_RESOURCES);
+
+    setNeighbor("Ethernet0", "10.0.0.1", "00:00:00:00:00:01");
+    EXPECT_FALSE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_EQ(pendingNeighborTasks(), 1u);
+
+    gNeighOrch->doTask();
+    EXPECT_TRUE(hasNeighbor("Ethernet0", "10.0.0.1"));
+    EXPECT_EQ(pendingNeighborTasks(), 0u);
+}
@@ -0,0 +1,197 @@
+#include <fstream>
+#include <stdexcept>
+
+#include "orchtest.h"
+#include "saihelper.h"
+
+using namespace std;
+using namespace swss;
+
+/* Globals of orchagent's main.cpp, which is not linked in */
+sai_object_id_t gVirtualRouterId;
+sai_object_id_t gUnderlayIfId;
+sai_object_id_t gSwitchId = SAI_NULL_OBJECT_ID;
+MacAddress gMacAddress;
+MacAddress gVxlanMacAddress;
+int gBatchSize = 128;
+int gResilientEcmpBuckets = 0;
+bool gSairedisRecord = false;
+bool gSwssRecord = false;
+bool gLogRotate = false;
+ofstream gRecordOfs;
+string gRecordFile;
+
+void syncd_apply_view()
+{
+}
+
+extern sai_switch_api_t *sai_switch_api;
+extern sai_hostif_api_t *sai_hostif_api;
+
+/* Range of the ACL rule priorities, which the stub switch does not report by itself */
+#define ORCH_TEST_ACL_MIN_PRIORITY 0
+#define ORCH_TEST_ACL_MAX_PRIORITY 999999
+
+void OrchTest::init(uint32_t portCount)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.reset();
+    sai.setPortCount(portCount);
+
+    initSaiApi();
+
+    sai_attribute_t attr;
+    attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+    attr.value.booldata = true;
+    if (sai_switch_api->create_switch(&gSwitchId, 1, &attr) != SAI_STATUS_SUCCESS)
+    {
+        throw runtime_error("Failed to create the switch");
+    }
+
+    attr.id = SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID;
+    sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+    gVirtualRouterId = attr.value.oid;
+    gMacAddress = MacAddress("00:01:02:03:04:05");
+
+    attr.id = SAI_SWITCH_ATTR_ACL_ENTRY_MINIMUM_PRIORITY;
+    attr.value.u32 = ORCH_TEST_ACL_MIN_PRIORITY;
+    sai.setAttribute(gSwitchId, attr);
+    attr.id = SAI_SWITCH_ATTR_ACL_ENTRY_MAXIMUM_PRIORITY;
+    attr.value.u32 = ORCH_TEST_ACL_MAX_PRIORITY;
+    sai.setAttribute(gSwitchId, attr);
+
+    m_applDb = make_shared<DBConnector>(APPL_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    m_configDb = make_shared<DBConnector>(CONFIG_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+    m_stateDb = make_shared<DBConnector>(STATE_DB, DBConnector::DEFAULT_UNIXSOCKET, 0);
+
+    vector<table_name_with_pri_t> ports_tables = {
+        { APP_PORT_TABLE_NAME,        0 },
+        { APP_VLAN_TABLE_NAME,        0 },
+        { APP_VLAN_MEMBER_TABLE_NAME, 0 }
+    };
+
+    gCrmOrch = new CrmOrch(m_configDb.get(), CFG_CRM_TABLE_NAME);
+    gPortsOrch = new PortsOrch(m_applDb.get(), ports_tables);
+    gFdbOrch = new FdbOrch(TableConnector(m_applDb.get(), APP_FDB_TABLE_NAME),
+                           TableConnector(m_stateDb.get(), STATE_FDB_TABLE_NAME), gPortsOrch);
+    m_vrfOrch = new VRFOrch(m_applDb.get(), APP_VRF_TABLE_NAME);
+    gIntfsOrch = new IntfsOrch(m_applDb.get(), APP_INTF_TABLE_NAME, m_vrfOrch);
+    gNeighOrch = new NeighOrch(m_applDb.get(), APP_NEIGH_TABLE_NAME, gIntfsOrch);
+    gRouteOrch = new RouteOrch(m_applDb.get(), APP_ROUTE_TABLE_NAME, gNeighOrch);
+    m_mirrorOrch = new MirrorOrch(TableConnector(m_stateDb.get(), APP_MIRROR_SESSION_TABLE_NAME),
+                                  TableConnector(m_configDb.get(), CFG_MIRROR_SESSION_TABLE_NAME),
+                                  gPortsOrch, gRouteOrch, gNeighOrch, gFdbOrch);
+
+    vector<TableConnector> acl_table_connectors = {
+        TableConnector(m_configDb.get(), CFG_ACL_TABLE_NAME),
+        TableConnector(m_configDb.get(), CFG_ACL_RULE_TABLE_NAME)
+    };
+    gAclOrch = new AclOrch(acl_table_connectors, TableConnector(m_stateDb.get(), "SWITCH_CAPABILITY"),
+                           gPortsOrch, m_mirrorOrch, gNeighOrch, gRouteOrch, NULL);
+
+    /* Front panel ports are known from the port configuration, with their host interface */
+    vector<sai_object_id_t> ports(portCount);
+    attr.id = SAI_SWITCH_ATTR_PORT_LIST;
+    attr.value.objlist.count = portCount;
+    attr.value.objlist.list = ports.data();
+    sai_switch_api->get_switch_attribute(gSwitchId, 1, &attr);
+
+    for (uint32_t i = 0; i < portCount; i++)
+    {
+        Port port(portName(i), Port::PHY);
+        port.m_port_id = ports[i];
+        sai_hostif_api->create_hostif(&port.m_hif_id, gSwitchId, 0, nullptr);
+        gPortsOrch->setPort(port.m_alias, port);
+    }
+
+    doTask(gPortsOrch, APP_PORT_TABLE_NAME, { "PortInitDone", SET_COMMAND, {} });
+    if (!gPortsOrch->isPortReady())
+    {
+        throw runtime_error("Ports are not ready");
+    }
+}
+
+void OrchTest::deinit()
+{
+    delete gAclOrch;
+    delete m_mirrorOrch;
+    delete gRouteOrch;
+    delete gNeighOrch;
+    delete gIntfsOrch;
+    delete m_vrfOrch;
+    delete gFdbOrch;
+    delete gPortsOrch;
+    delete gCrmOrch;
+
+    gAclOrch = nullptr;
+    m_mirrorOrch = nullptr;
+    gRouteOrch = nullptr;
+    gNeighOrch = nullptr;
+    gIntfsOrch = nullptr;
+    m_vrfOrch = nullptr;
+    gFdbOrch = nullptr;
+    gPortsOrch = nullptr;
+    gCrmOrch = nullptr;
+
+    sai_api_uninitialize();
+}
+
+Consumer *OrchTest::getConsumer(Orch *orch, const string &tableName)
+{
+    vector<Consumer *> consumers;
+    orch->getConsumers(consumers);
+
+    for (Consumer *consumer : consumers)
+    {
+        if (consumer->getTableName() == tableName)
+        {
+            return consumer;
+        }
+    }
+
+    throw runtime_error("No consumer of " + tableName);
+}
+
+size_t OrchTest::getPendingTaskCount(Orch *orch, const string &tableName)
+{
+    return getConsumer(orch, tableName)->m_toSync.size();
+}
+
+void OrchTest::doTask(Orch *orch, const string &tableName, const KeyOpFieldsValuesTuple &task)
+{
+    doTasks(orch, tableName, { task });
+}
+
+void OrchTest::doTasks(Orch *orch, const string &tableName, const vector<KeyOpFieldsValuesTuple> &tasks)
+{
+    Consumer *consumer = getConsumer(orch, tableName);
+
+    for (const auto &task : tasks)
+    {
+        consumer->m_toSync.emplace(kfvKey(task), task);
+    }
+
+    orch->doTask();
+    orch->flushBulkers();
+}
+
+void OrchTest::addInterface(const string &alias, const string &prefix)
+{
+    doTask(gIntfsOrch, APP_INTF_TABLE_NAME, { alias + ":" + prefix, SET_COMMAND, {} });
+
+    Port port;
+    if (!gPortsOrch->getPort(alias, port) || !port.m_rif_id)
+    {
+        throw runtime_error("Failed to create the router interface of " + alias);
+    }
+}
+
+void OrchTest::addNeighbor(const string &alias, const string &ip, const string &mac)
+{
+    doTask(gNeighOrch, APP_NEIGH_TABLE_NAME,
+            { alias + ":" + ip, SET_COMMAND, { { "neigh", mac }, { "family", "IPv4" } } });
+    if (!gNeighOrch->hasNextHop(IpAddress(ip)))
+    {
+        throw runtime_error("Failed to create the neighbor " + ip + " on " + alias);
+    }
+}
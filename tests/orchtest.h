@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+ * Real orchs, from PortsOrch up to AclOrch, run on top of the stub SAI for
+ * the orch unit tests and the benchmarks. Tasks are queued on the consumers
+ * as if they were read from the databases, then run by doTask(). The orchs
+ * still open their tables on construction, so a local redis server must be
+ * reachable: only the SAI side, syncd and sairedis, is replaced.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "orchdaemon.h"
+#include "stubsai.h"
+
+class OrchTest
+{
+public:
+    /*
+     * Create the switch with portCount front panel ports, named Ethernet0,
+     * Ethernet4..., and the orchs, then mark the ports ready.
+     * Throws runtime_error when the stub SAI rejects the switch.
+     */
+    void init(uint32_t portCount = 2);
+    void deinit();
+
+    static std::string portName(uint32_t index)
+    {
+        return "Ethernet" + std::to_string(index * 4);
+    }
+
+    Consumer *getConsumer(Orch *orch, const std::string &tableName);
+    size_t getPendingTaskCount(Orch *orch, const std::string &tableName);
+
+    /* Queue the tasks on the consumer of the table and let the orch run them */
+    void doTask(Orch *orch, const std::string &tableName, const KeyOpFieldsValuesTuple &task);
+    void doTasks(Orch *orch, const std::string &tableName, const std::vector<KeyOpFieldsValuesTuple> &tasks);
+
+    /* Router interface on the port, and an IPv4 neighbor behind it, both must be programmed */
+    void addInterface(const std::string &alias, const std::string &prefix);
+    void addNeighbor(const std::string &alias, const std::string &ip, const std::string &mac);
+
+protected:
+    std::shared_ptr<DBConnector> m_applDb;
+    std::shared_ptr<DBConnector> m_configDb;
+    std::shared_ptr<DBConnector> m_stateDb;
+
+    VRFOrch *m_vrfOrch = nullptr;
+    MirrorOrch *m_mirrorOrch = nullptr;
+};
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "prefixtrie.h"
+
+using namespace std;
+using namespace swss;
+
+static vector<string> covering(PrefixTrie<string> &trie, const string &address)
+{
+    vector<string> values;
+    trie.visitCovering(IpAddress(address), [&values](string &value) { values.push_back(value); });
+    return values;
+}
+
+static vector<string> covered(PrefixTrie<string> &trie, const string &prefix)
+{
+    vector<string> values;
+    trie.visitCovered(IpPrefix(prefix), [&values](string &value) { values.push_back(value); });
+    return values;
+}
+
+TEST(prefixtrie, covering_prefixes)
+{
+    PrefixTrie<string> trie;
+
+    for (auto prefix : { "0.0.0.0/0", "10.0.0.0/8", "10.1.0.0/16", "10.1.1.0/24", "10.2.0.0/16", "::/0", "10::/16" })
+    {
+        trie.insert(IpPrefix(prefix), prefix);
+    }
+    EXPECT_EQ(trie.size(), 7u);
+
+    vector<string> expected = { "0.0.0.0/0", "10.0.0.0/8", "10.1.0.0/16", "10.1.1.0/24" };
+    EXPECT_EQ(covering(trie, "10.1.1.1"), expected);
+
+    expected = { "0.0.0.0/0", "10.0.0.0/8" };
+    EXPECT_EQ(covering(trie, "10.3.0.1"), expected);
+
+    expected = { "::/0", "10::/16" };
+    EXPECT_EQ(covering(trie, "10::1"), expected);
+
+    expected = { "0.0.0.0/0" };
+    EXPECT_EQ(covering(trie, "192.168.0.1"), expected);
+}
+
+TEST(prefixtrie, covered_entries)
+{
+    PrefixTrie<string> trie;
+
+    for (auto address : { "10.1.1.1", "10.1.2.1", "10.2.0.1", "20.0.0.1", "fc00::1" })
+    {
+        trie.insert(IpAddress(address), address);
+    }
+
+    vector<string> expected = { "10.1.1.1", "10.1.2.1" };
+    EXPECT_EQ(covered(trie, "10.1.0.0/16"), expected);
+
+    expected = { "10.1.1.1", "10.1.2.1", "10.2.0.1", "20.0.0.1" };
+    EXPECT_EQ(covered(trie, "0.0.0.0/0"), expected);
+
+    expected = { "fc00::1" };
+    EXPECT_EQ(covered(trie, "fc00::/7"), expected);
+
+    EXPECT_TRUE(covered(trie, "10.3.0.0/16").empty());
+    EXPECT_TRUE(covered(trie, "10.1.1.2/32").empty());
+}
+
+TEST(prefixtrie, erase_keeps_other_prefixes)
+{
+    PrefixTrie<string> trie;
+
+    for (auto prefix : { "10.0.0.0/8", "10.1.0.0/16", "10.1.1.0/24", "10.1.2.0/24" })
+    {
+        trie.insert(IpPrefix(prefix), prefix);
+    }
+
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.0.0/16")));
+    EXPECT_FALSE(trie.erase(IpPrefix("10.1.0.0/16")));
+    EXPECT_FALSE(trie.erase(IpPrefix("10.1.3.0/24")));
+    EXPECT_EQ(trie.find(IpPrefix("10.1.0.0/16")), nullptr);
+
+    vector<string> expected = { "10.0.0.0/8", "10.1.2.0/24" };
+    EXPECT_EQ(covering(trie, "10.1.2.1"), expected);
+
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.1.0/24")));
+    EXPECT_TRUE(trie.erase(IpPrefix("10.0.0.0/8")));
+    ASSERT_NE(trie.find(IpPrefix("10.1.2.0/24")), nullptr);
+    EXPECT_EQ(*trie.find(IpPrefix("10.1.2.0/24")), "10.1.2.0/24");
+
+    trie.insert(IpPrefix("10.1.2.0/24"), "replaced");
+    EXPECT_EQ(*trie.find(IpPrefix("10.1.2.0/24")), "replaced");
+    EXPECT_EQ(trie.size(), 1u);
+
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.2.0/24")));
+    EXPECT_TRUE(trie.empty());
+    EXPECT_TRUE(covering(trie, "10.1.2.1").empty());
+}
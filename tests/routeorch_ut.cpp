@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+
+#include "orchtest.h"
+#include "swssnet.h"
+
+using namespace std;
+using namespace swss;
+
+class RouteOrchTest : public ::testing::Test, public OrchTest
+{
+protected:
+    void SetUp() override
+    {
+        init();
+
+        addInterface("Ethernet0", "10.0.0.0/24");
+        addNeighbor("Ethernet0", "10.0.0.1", "00:00:00:00:00:01");
+        addNeighbor("Ethernet0", "10.0.0.2", "00:00:00:00:00:02");
+    }
+
+    void TearDown() override
+    {
+        deinit();
+    }
+
+    void setRoute(const string &prefix, const string &nexthops)
+    {
+        doTask(gRouteOrch, APP_ROUTE_TABLE_NAME,
+                { prefix, SET_COMMAND, { { "nexthop", nexthops }, { "ifname", "Ethernet0" } } });
+    }
+
+    void delRoute(const string &prefix)
+    {
+        doTask(gRouteOrch, APP_ROUTE_TABLE_NAME, { prefix, DEL_COMMAND, {} });
+    }
+
+    bool hasRoute(const string &prefix)
+    {
+        sai_route_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+
+        entry.switch_id = gSwitchId;
+        entry.vr_id = gVirtualRouterId;
+        copy(entry.destination, IpPrefix(prefix));
+        return StubSai::getInstance().hasRoute(entry);
+    }
+
+    size_t pendingRouteTasks()
+    {
+        return getPendingTaskCount(gRouteOrch, APP_ROUTE_TABLE_NAME);
+    }
+};
+
+TEST_F(RouteOrchTest, route_to_next_hop)
+{
+    setRoute("192.168.1.0/24", "10.0.0.1");
+    EXPECT_TRUE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 0u);
+
+    delRoute("192.168.1.0/24");
+    EXPECT_FALSE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 0u);
+}
+
+TEST_F(RouteOrchTest, route_to_next_hop_group)
+{
+    StubSai &sai = StubSai::getInstance();
+
+    setRoute("192.168.1.0/24", "10.0.0.1,10.0.0.2");
+    setRoute("192.168.2.0/24", "10.0.0.1,10.0.0.2");
+    EXPECT_TRUE(hasRoute("192.168.1.0/24"));
+    EXPECT_TRUE(hasRoute("192.168.2.0/24"));
+
+    /* Both routes share the group */
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP), 1u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER), 2u);
+
+    delRoute("192.168.1.0/24");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP), 1u);
+
+    /* The group is removed along with its last route */
+    delRoute("192.168.2.0/24");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP), 0u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER), 0u);
+}
+
+TEST_F(RouteOrchTest, route_waits_for_next_hop)
+{
+    setRoute("192.168.1.0/24", "10.0.0.3");
+    EXPECT_FALSE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 1u);
+
+    /* The pending task is retried once the neighbor is resolved */
+    addNeighbor("Ethernet0", "10.0.0.3", "00:00:00:00:00:03");
+    gRouteOrch->doTask();
+    EXPECT_TRUE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 0u);
+}
+
+TEST_F(RouteOrchTest, failed_route_is_retried)
+{
+    StubSai::getInstance().failNext(SAI_STATUS_INSUFFICIENT_RESOURCES);
+
+    setRoute("192.168.1.0/24", "10.0.0.1");
+    EXPECT_FALSE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 1u);
+
+    gRouteOrch->doTask();
+    EXPECT_TRUE(hasRoute("192.168.1.0/24"));
+    EXPECT_EQ(pendingRouteTasks(), 0u);
+}
+
+TEST_F(RouteOrchTest, group_members_follow_interface_status)
+{
+    StubSai &sai = StubSai::getInstance();
+
+    setRoute("192.168.1.0/24", "10.0.0.1,10.0.0.2");
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER), 2u);
+
+    /* The members are removed while the interface is down, the route stays */
+    EXPECT_TRUE(gNeighOrch->ifChangeInformNextHop("Ethernet0", false));
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER), 0u);
+    EXPECT_TRUE(hasRoute("192.168.1.0/24"));
+
+    EXPECT_TRUE(gNeighOrch->ifChangeInformNextHop("Ethernet0", true));
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER), 2u);
+}
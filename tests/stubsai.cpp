@@ -0,0 +1,853 @@
+#include <string.h>
+
+#include <type_traits>
+
+extern "C" {
+#include "saimetadata.h"
+}
+
+#include "stubsai.h"
+
+using namespace std;
+
+/* Object ids carry their object type, like the ones of sairedis */
+#define STUB_SAI_OID_TYPE_SHIFT     48
+#define STUB_SAI_OID_INDEX_MASK     ((1ULL << STUB_SAI_OID_TYPE_SHIFT) - 1)
+
+#define STUB_SAI_DEFAULT_PORT_COUNT 32
+
+template <typename L>
+static void storeList(const L &list, StubSaiAttr &stored)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(list.list);
+
+    stored.list.clear();
+    if (data)
+    {
+        stored.list.assign(data, data + list.count * sizeof(*list.list));
+    }
+    stored.value.objlist.list = nullptr;
+}
+
+template <typename L>
+static sai_status_t loadList(const StubSaiAttr &stored, L &list)
+{
+    typedef typename remove_pointer<decltype(list.list)>::type element_t;
+    uint32_t count = static_cast<uint32_t>(stored.list.size() / sizeof(element_t));
+
+    if (list.count < count)
+    {
+        list.count = count;
+        return SAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    if (count)
+    {
+        memcpy(list.list, stored.list.data(), stored.list.size());
+    }
+    list.count = count;
+    return SAI_STATUS_SUCCESS;
+}
+
+#define STUB_SAI_LIST_TYPES(handler) \
+    handler(SAI_ATTR_VALUE_TYPE_OBJECT_LIST,    objlist) \
+    handler(SAI_ATTR_VALUE_TYPE_UINT8_LIST,     u8list) \
+    handler(SAI_ATTR_VALUE_TYPE_INT8_LIST,      s8list) \
+    handler(SAI_ATTR_VALUE_TYPE_UINT16_LIST,    u16list) \
+    handler(SAI_ATTR_VALUE_TYPE_INT16_LIST,     s16list) \
+    handler(SAI_ATTR_VALUE_TYPE_UINT32_LIST,    u32list) \
+    handler(SAI_ATTR_VALUE_TYPE_INT32_LIST,     s32list) \
+    handler(SAI_ATTR_VALUE_TYPE_VLAN_LIST,      vlanlist) \
+    handler(SAI_ATTR_VALUE_TYPE_QOS_MAP_LIST,   qosmap)
+
+static sai_attr_value_type_t attrValueType(sai_object_type_t type, sai_attr_id_t id)
+{
+    const sai_attr_metadata_t *meta = sai_metadata_get_attr_metadata(type, id);
+
+    /* Attributes outside of the metadata, e.g. the sairedis ones, are scalars */
+    return meta ? meta->attrvaluetype : SAI_ATTR_VALUE_TYPE_UINT64;
+}
+
+StubSai &StubSai::getInstance()
+{
+    static StubSai instance;
+    return instance;
+}
+
+StubSai::StubSai() :
+    m_portCount(STUB_SAI_DEFAULT_PORT_COUNT)
+{
+    reset();
+}
+
+void StubSai::reset()
+{
+    m_stores.clear();
+    m_nextIndex.clear();
+
+    m_callLatency = chrono::nanoseconds(0);
+    m_objectLatency = chrono::nanoseconds(0);
+
+    m_failStatus = SAI_STATUS_SUCCESS;
+    m_failCount = 0;
+
+    m_calls = 0;
+    m_bulkCalls = 0;
+}
+
+void StubSai::setLatency(chrono::nanoseconds callLatency, chrono::nanoseconds objectLatency)
+{
+    m_callLatency = callLatency;
+    m_objectLatency = objectLatency;
+}
+
+void StubSai::failNext(sai_status_t status, uint32_t count)
+{
+    m_failStatus = status;
+    m_failCount = count;
+}
+
+size_t StubSai::getObjectCount(sai_object_type_t type) const
+{
+    auto it = m_stores.find(type);
+    return it == m_stores.end() ? 0 : it->second.size();
+}
+
+bool StubSai::hasObject(sai_object_id_t oid) const
+{
+    auto it = m_stores.find(sai_object_type_query(oid));
+    return it != m_stores.end() && it->second.count(key(oid));
+}
+
+bool StubSai::hasRoute(const sai_route_entry_t &entry) const
+{
+    auto it = m_stores.find(SAI_OBJECT_TYPE_ROUTE_ENTRY);
+    return it != m_stores.end() && it->second.count(key(entry));
+}
+
+bool StubSai::hasNeighbor(const sai_neighbor_entry_t &entry) const
+{
+    auto it = m_stores.find(SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
+    return it != m_stores.end() && it->second.count(key(entry));
+}
+
+bool StubSai::hasFdb(const sai_fdb_entry_t &entry) const
+{
+    auto it = m_stores.find(SAI_OBJECT_TYPE_FDB_ENTRY);
+    return it != m_stores.end() && it->second.count(key(entry));
+}
+
+vector<sai_object_id_t> StubSai::getObjects(sai_object_type_t type) const
+{
+    vector<sai_object_id_t> oids;
+
+    auto it = m_stores.find(type);
+    if (it == m_stores.end())
+    {
+        return oids;
+    }
+
+    for (const auto &object : it->second)
+    {
+        sai_object_id_t oid;
+        memcpy(&oid, object.first.data(), sizeof(oid));
+        oids.push_back(oid);
+    }
+
+    return oids;
+}
+
+sai_status_t StubSai::setAttribute(sai_object_id_t oid, const sai_attribute_t &attr)
+{
+    sai_object_type_t type = sai_object_type_query(oid);
+
+    StubSaiAttrs *attrs = find(type, key(oid));
+    if (!attrs)
+    {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    copyIn(type, attr, (*attrs)[attr.id]);
+    return SAI_STATUS_SUCCESS;
+}
+
+void StubSai::call(uint32_t count, bool bulk)
+{
+    m_calls++;
+    if (bulk)
+    {
+        m_bulkCalls++;
+    }
+
+    auto latency = m_callLatency + m_objectLatency * count;
+    if (latency.count() == 0)
+    {
+        return;
+    }
+
+    /* Spin, sleeping is too coarse for the latencies of a SAI call */
+    auto end = chrono::steady_clock::now() + latency;
+    while (chrono::steady_clock::now() < end);
+}
+
+sai_status_t StubSai::injectedStatus()
+{
+    if (m_failCount == 0)
+    {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    m_failCount--;
+    return m_failStatus;
+}
+
+sai_object_id_t StubSai::allocate(sai_object_type_t type)
+{
+    uint64_t index = ++m_nextIndex[type];
+    return (static_cast<uint64_t>(type) << STUB_SAI_OID_TYPE_SHIFT) | (index & STUB_SAI_OID_INDEX_MASK);
+}
+
+StubSaiAttrs *StubSai::find(sai_object_type_t type, const string &key)
+{
+    auto store = m_stores.find(type);
+    if (store == m_stores.end())
+    {
+        return nullptr;
+    }
+
+    auto it = store->second.find(key);
+    return it == store->second.end() ? nullptr : &it->second;
+}
+
+/*
+ * The switch comes with the objects created by the vendor SAI: the CPU port,
+ * the front panel ports with one lane each, the default VLAN, 1Q bridge and
+ * virtual router.
+ */
+sai_status_t StubSai::createSwitch(sai_object_id_t *oid, uint32_t count, const sai_attribute_t *attrs)
+{
+    sai_status_t status = create(SAI_OBJECT_TYPE_SWITCH, oid, count, attrs);
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    sai_object_id_t switch_id = *oid;
+    sai_attribute_t attr;
+
+    auto createDefault = [&](sai_object_type_t type, sai_attr_id_t switch_attr_id) -> sai_object_id_t
+    {
+        sai_object_id_t id;
+        create(type, &id, 0, nullptr);
+
+        attr.id = switch_attr_id;
+        attr.value.oid = id;
+        setAttribute(switch_id, attr);
+        return id;
+    };
+
+    createDefault(SAI_OBJECT_TYPE_PORT, SAI_SWITCH_ATTR_CPU_PORT);
+    createDefault(SAI_OBJECT_TYPE_VIRTUAL_ROUTER, SAI_SWITCH_ATTR_DEFAULT_VIRTUAL_ROUTER_ID);
+    sai_object_id_t vlan_id = createDefault(SAI_OBJECT_TYPE_VLAN, SAI_SWITCH_ATTR_DEFAULT_VLAN_ID);
+    sai_object_id_t bridge_id = createDefault(SAI_OBJECT_TYPE_BRIDGE, SAI_SWITCH_ATTR_DEFAULT_1Q_BRIDGE_ID);
+
+    attr.id = SAI_VLAN_ATTR_VLAN_ID;
+    attr.value.u16 = 1;
+    setAttribute(vlan_id, attr);
+
+    attr.id = SAI_VLAN_ATTR_MEMBER_LIST;
+    attr.value.objlist.count = 0;
+    attr.value.objlist.list = nullptr;
+    setAttribute(vlan_id, attr);
+
+    attr.id = SAI_BRIDGE_ATTR_PORT_LIST;
+    setAttribute(bridge_id, attr);
+
+    vector<sai_object_id_t> ports;
+    for (uint32_t i = 0; i < m_portCount; i++)
+    {
+        sai_object_id_t port_id;
+        uint32_t lane = i * 4;
+
+        attr.id = SAI_PORT_ATTR_HW_LANE_LIST;
+        attr.value.u32list.count = 1;
+        attr.value.u32list.list = &lane;
+        create(SAI_OBJECT_TYPE_PORT, &port_id, 1, &attr);
+
+        ports.push_back(port_id);
+    }
+
+    attr.id = SAI_SWITCH_ATTR_PORT_NUMBER;
+    attr.value.u32 = m_portCount;
+    setAttribute(switch_id, attr);
+
+    attr.id = SAI_SWITCH_ATTR_PORT_LIST;
+    attr.value.objlist.count = static_cast<uint32_t>(ports.size());
+    attr.value.objlist.list = ports.data();
+    setAttribute(switch_id, attr);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t StubSai::create(sai_object_type_t type, sai_object_id_t *oid, uint32_t count, const sai_attribute_t *attrs)
+{
+    sai_object_id_t id = allocate(type);
+
+    sai_status_t status = create(type, key(id), count, attrs);
+    if (status == SAI_STATUS_SUCCESS)
+    {
+        *oid = id;
+    }
+
+    return status;
+}
+
+sai_status_t StubSai::create(sai_object_type_t type, const string &key, uint32_t count, const sai_attribute_t *attrs)
+{
+    sai_status_t status = injectedStatus();
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    auto &store = m_stores[type];
+    if (store.count(key))
+    {
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    StubSaiAttrs &stored = store[key];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        copyIn(type, attrs[i], stored[attrs[i].id]);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t StubSai::remove(sai_object_type_t type, const string &key)
+{
+    sai_status_t status = injectedStatus();
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    auto store = m_stores.find(type);
+    if (store == m_stores.end() || !store->second.erase(key))
+    {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t StubSai::set(sai_object_type_t type, const string &key, const sai_attribute_t *attr)
+{
+    sai_status_t status = injectedStatus();
+    if (status != SAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    StubSaiAttrs *attrs = find(type, key);
+    if (!attrs)
+    {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    copyIn(type, *attr, (*attrs)[attr->id]);
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t StubSai::get(sai_object_type_t type, const string &key, uint32_t count, sai_attribute_t *attrs)
+{
+    StubSaiAttrs *stored = find(type, key);
+    if (!stored)
+    {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    sai_status_t result = SAI_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto it = stored->find(attrs[i].id);
+        if (it == stored->end())
+        {
+            return SAI_STATUS_NOT_SUPPORTED;
+        }
+
+        sai_status_t status = copyOut(type, it->second, attrs[i]);
+        if (status != SAI_STATUS_SUCCESS)
+        {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+void StubSai::copyIn(sai_object_type_t type, const sai_attribute_t &attr, StubSaiAttr &stored)
+{
+    stored.value = attr.value;
+    stored.list.clear();
+
+    switch (attrValueType(type, attr.id))
+    {
+#define STUB_SAI_STORE_LIST(value_type, member) \
+        case value_type: \
+            storeList(attr.value.member, stored); \
+            break;
+
+        STUB_SAI_LIST_TYPES(STUB_SAI_STORE_LIST)
+#undef STUB_SAI_STORE_LIST
+
+        default:
+            /* Other values are copied as is, lists inside ACL fields are not kept */
+            break;
+    }
+}
+
+sai_status_t StubSai::copyOut(sai_object_type_t type, const StubSaiAttr &stored, sai_attribute_t &attr)
+{
+    switch (attrValueType(type, attr.id))
+    {
+#define STUB_SAI_LOAD_LIST(value_type, member) \
+        case value_type: \
+            return loadList(stored, attr.value.member);
+
+        STUB_SAI_LIST_TYPES(STUB_SAI_LOAD_LIST)
+#undef STUB_SAI_LOAD_LIST
+
+        default:
+            attr.value = stored.value;
+            return SAI_STATUS_SUCCESS;
+    }
+}
+
+string StubSai::key(sai_object_id_t oid)
+{
+    return string(reinterpret_cast<const char *>(&oid), sizeof(oid));
+}
+
+/* Entries are serialized field by field, their structures have padding */
+template <typename T>
+static void append(string &key, const T &field)
+{
+    key.append(reinterpret_cast<const char *>(&field), sizeof(field));
+}
+
+static void append(string &key, const sai_ip_address_t &ip)
+{
+    append(key, ip.addr_family);
+    if (ip.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        append(key, ip.addr.ip4);
+    }
+    else
+    {
+        append(key, ip.addr.ip6);
+    }
+}
+
+string StubSai::key(const sai_route_entry_t &entry)
+{
+    string key;
+
+    append(key, entry.switch_id);
+    append(key, entry.vr_id);
+    append(key, entry.destination.addr_family);
+    if (entry.destination.addr_family == SAI_IP_ADDR_FAMILY_IPV4)
+    {
+        append(key, entry.destination.addr.ip4);
+        append(key, entry.destination.mask.ip4);
+    }
+    else
+    {
+        append(key, entry.destination.addr.ip6);
+        append(key, entry.destination.mask.ip6);
+    }
+
+    return key;
+}
+
+string StubSai::key(const sai_neighbor_entry_t &entry)
+{
+    string key;
+
+    append(key, entry.switch_id);
+    append(key, entry.rif_id);
+    append(key, entry.ip_address);
+
+    return key;
+}
+
+string StubSai::key(const sai_fdb_entry_t &entry)
+{
+    string key;
+
+    append(key, entry.switch_id);
+    append(key, entry.mac_address);
+    append(key, entry.bv_id);
+
+    return key;
+}
+
+/* API functions, one instance per object type */
+
+template <sai_object_type_t OT>
+static sai_status_t stub_create(sai_object_id_t *oid, sai_object_id_t, uint32_t count, const sai_attribute_t *attrs)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.create(OT, oid, count, attrs);
+}
+
+template <sai_object_type_t OT>
+static sai_status_t stub_remove(sai_object_id_t oid)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.remove(OT, StubSai::key(oid));
+}
+
+template <sai_object_type_t OT>
+static sai_status_t stub_set(sai_object_id_t oid, const sai_attribute_t *attr)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.set(OT, StubSai::key(oid), attr);
+}
+
+template <sai_object_type_t OT>
+static sai_status_t stub_get(sai_object_id_t oid, uint32_t count, sai_attribute_t *attrs)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.get(OT, StubSai::key(oid), count, attrs);
+}
+
+template <sai_object_type_t OT, typename E>
+static sai_status_t stub_create_entry(const E *entry, uint32_t count, const sai_attribute_t *attrs)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.create(OT, StubSai::key(*entry), count, attrs);
+}
+
+template <sai_object_type_t OT, typename E>
+static sai_status_t stub_remove_entry(const E *entry)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.remove(OT, StubSai::key(*entry));
+}
+
+template <sai_object_type_t OT, typename E>
+static sai_status_t stub_set_entry(const E *entry, const sai_attribute_t *attr)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.set(OT, StubSai::key(*entry), attr);
+}
+
+template <sai_object_type_t OT, typename E>
+static sai_status_t stub_get_entry(const E *entry, uint32_t count, sai_attribute_t *attrs)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.get(OT, StubSai::key(*entry), count, attrs);
+}
+
+static sai_status_t stub_get_stats(sai_object_id_t, uint32_t count, const sai_stat_id_t *, uint64_t *counters)
+{
+    StubSai::getInstance().call();
+    memset(counters, 0, count * sizeof(*counters));
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t stub_create_switch(sai_object_id_t *oid, uint32_t count, const sai_attribute_t *attrs)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai.call();
+    return sai.createSwitch(oid, count, attrs);
+}
+
+static sai_status_t stub_flush_fdb_entries(sai_object_id_t, uint32_t, const sai_attribute_t *)
+{
+    StubSai::getInstance().call();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Run a bulk operation one object at a time. With the stop on error mode, the
+ * objects after the first failure are not executed.
+ */
+template <typename F>
+static sai_status_t stub_bulk(uint32_t count, sai_bulk_op_error_mode_t mode, sai_status_t *statuses, F op)
+{
+    StubSai::getInstance().call(count, true);
+
+    sai_status_t result = SAI_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (result != SAI_STATUS_SUCCESS && mode == SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+        {
+            statuses[i] = SAI_STATUS_NOT_EXECUTED;
+            continue;
+        }
+
+        statuses[i] = op(i);
+        if (statuses[i] != SAI_STATUS_SUCCESS)
+        {
+            result = SAI_STATUS_FAILURE;
+        }
+    }
+
+    return result;
+}
+
+static sai_status_t stub_create_route_entries(uint32_t count, const sai_route_entry_t *entries,
+        const uint32_t *attr_counts, const sai_attribute_t **attr_lists,
+        sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+{
+    StubSai &sai = StubSai::getInstance();
+    return stub_bulk(count, mode, statuses, [&](uint32_t i)
+    {
+        return sai.create(SAI_OBJECT_TYPE_ROUTE_ENTRY, StubSai::key(entries[i]), attr_counts[i], attr_lists[i]);
+    });
+}
+
+static sai_status_t stub_remove_route_entries(uint32_t count, const sai_route_entry_t *entries,
+        sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+{
+    StubSai &sai = StubSai::getInstance();
+    return stub_bulk(count, mode, statuses, [&](uint32_t i)
+    {
+        return sai.remove(SAI_OBJECT_TYPE_ROUTE_ENTRY, StubSai::key(entries[i]));
+    });
+}
+
+static sai_status_t stub_set_route_entries_attribute(uint32_t count, const sai_route_entry_t *entries,
+        const sai_attribute_t *attrs, sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+{
+    StubSai &sai = StubSai::getInstance();
+    return stub_bulk(count, mode, statuses, [&](uint32_t i)
+    {
+        return sai.set(SAI_OBJECT_TYPE_ROUTE_ENTRY, StubSai::key(entries[i]), &attrs[i]);
+    });
+}
+
+static sai_status_t stub_create_next_hop_group_members(sai_object_id_t, uint32_t count,
+        const uint32_t *attr_counts, const sai_attribute_t **attr_lists,
+        sai_bulk_op_error_mode_t mode, sai_object_id_t *object_ids, sai_status_t *statuses)
+{
+    StubSai &sai = StubSai::getInstance();
+    return stub_bulk(count, mode, statuses, [&](uint32_t i) -> sai_status_t
+    {
+        object_ids[i] = SAI_NULL_OBJECT_ID;
+        return sai.create(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, &object_ids[i], attr_counts[i], attr_lists[i]);
+    });
+}
+
+static sai_status_t stub_remove_next_hop_group_members(uint32_t count, const sai_object_id_t *object_ids,
+        sai_bulk_op_error_mode_t mode, sai_status_t *statuses)
+{
+    StubSai &sai = StubSai::getInstance();
+    return stub_bulk(count, mode, statuses, [&](uint32_t i)
+    {
+        return sai.remove(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, StubSai::key(object_ids[i]));
+    });
+}
+
+/* API tables */
+
+#define STUB_SAI_OBJECT_API(api, name, type) \
+    api.create_##name = stub_create<type>; \
+    api.remove_##name = stub_remove<type>; \
+    api.set_##name##_attribute = stub_set<type>; \
+    api.get_##name##_attribute = stub_get<type>;
+
+#define STUB_SAI_ENTRY_API(api, name, type, entry_t) \
+    api.create_##name = stub_create_entry<type, entry_t>; \
+    api.remove_##name = stub_remove_entry<type, entry_t>; \
+    api.set_##name##_attribute = stub_set_entry<type, entry_t>; \
+    api.get_##name##_attribute = stub_get_entry<type, entry_t>;
+
+static sai_switch_api_t switch_api;
+static sai_port_api_t port_api;
+static sai_bridge_api_t bridge_api;
+static sai_vlan_api_t vlan_api;
+static sai_lag_api_t lag_api;
+static sai_fdb_api_t fdb_api;
+static sai_hostif_api_t hostif_api;
+static sai_mirror_api_t mirror_api;
+static sai_virtual_router_api_t virtual_router_api;
+static sai_router_interface_api_t router_interface_api;
+static sai_neighbor_api_t neighbor_api;
+static sai_next_hop_api_t next_hop_api;
+static sai_next_hop_group_api_t next_hop_group_api;
+static sai_route_api_t route_api;
+static sai_acl_api_t acl_api;
+static sai_policer_api_t policer_api;
+static sai_tunnel_api_t tunnel_api;
+static sai_queue_api_t queue_api;
+static sai_scheduler_api_t scheduler_api;
+static sai_scheduler_group_api_t scheduler_group_api;
+static sai_wred_api_t wred_api;
+static sai_qos_map_api_t qos_map_api;
+static sai_buffer_api_t buffer_api;
+static sai_dtel_api_t dtel_api;
+
+static void initApis()
+{
+    switch_api.create_switch = stub_create_switch;
+    switch_api.remove_switch = stub_remove<SAI_OBJECT_TYPE_SWITCH>;
+    switch_api.set_switch_attribute = stub_set<SAI_OBJECT_TYPE_SWITCH>;
+    switch_api.get_switch_attribute = stub_get<SAI_OBJECT_TYPE_SWITCH>;
+
+    STUB_SAI_OBJECT_API(port_api, port, SAI_OBJECT_TYPE_PORT)
+    port_api.get_port_stats = stub_get_stats;
+
+    STUB_SAI_OBJECT_API(bridge_api, bridge, SAI_OBJECT_TYPE_BRIDGE)
+    STUB_SAI_OBJECT_API(bridge_api, bridge_port, SAI_OBJECT_TYPE_BRIDGE_PORT)
+
+    STUB_SAI_OBJECT_API(vlan_api, vlan, SAI_OBJECT_TYPE_VLAN)
+    STUB_SAI_OBJECT_API(vlan_api, vlan_member, SAI_OBJECT_TYPE_VLAN_MEMBER)
+
+    STUB_SAI_OBJECT_API(lag_api, lag, SAI_OBJECT_TYPE_LAG)
+    STUB_SAI_OBJECT_API(lag_api, lag_member, SAI_OBJECT_TYPE_LAG_MEMBER)
+
+    STUB_SAI_ENTRY_API(fdb_api, fdb_entry, SAI_OBJECT_TYPE_FDB_ENTRY, sai_fdb_entry_t)
+    fdb_api.flush_fdb_entries = stub_flush_fdb_entries;
+
+    STUB_SAI_OBJECT_API(hostif_api, hostif, SAI_OBJECT_TYPE_HOSTIF)
+    STUB_SAI_OBJECT_API(hostif_api, hostif_table_entry, SAI_OBJECT_TYPE_HOSTIF_TABLE_ENTRY)
+    STUB_SAI_OBJECT_API(hostif_api, hostif_trap_group, SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP)
+    STUB_SAI_OBJECT_API(hostif_api, hostif_trap, SAI_OBJECT_TYPE_HOSTIF_TRAP)
+
+    STUB_SAI_OBJECT_API(mirror_api, mirror_session, SAI_OBJECT_TYPE_MIRROR_SESSION)
+
+    STUB_SAI_OBJECT_API(virtual_router_api, virtual_router, SAI_OBJECT_TYPE_VIRTUAL_ROUTER)
+    STUB_SAI_OBJECT_API(router_interface_api, router_interface, SAI_OBJECT_TYPE_ROUTER_INTERFACE)
+
+    STUB_SAI_ENTRY_API(neighbor_api, neighbor_entry, SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, sai_neighbor_entry_t)
+
+    STUB_SAI_OBJECT_API(next_hop_api, next_hop, SAI_OBJECT_TYPE_NEXT_HOP)
+
+    STUB_SAI_OBJECT_API(next_hop_group_api, next_hop_group, SAI_OBJECT_TYPE_NEXT_HOP_GROUP)
+    STUB_SAI_OBJECT_API(next_hop_group_api, next_hop_group_member, SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER)
+    next_hop_group_api.create_next_hop_group_members = stub_create_next_hop_group_members;
+    next_hop_group_api.remove_next_hop_group_members = stub_remove_next_hop_group_members;
+
+    STUB_SAI_ENTRY_API(route_api, route_entry, SAI_OBJECT_TYPE_ROUTE_ENTRY, sai_route_entry_t)
+    route_api.create_route_entries = stub_create_route_entries;
+    route_api.remove_route_entries = stub_remove_route_entries;
+    route_api.set_route_entries_attribute = stub_set_route_entries_attribute;
+
+    STUB_SAI_OBJECT_API(acl_api, acl_table, SAI_OBJECT_TYPE_ACL_TABLE)
+    STUB_SAI_OBJECT_API(acl_api, acl_entry, SAI_OBJECT_TYPE_ACL_ENTRY)
+    STUB_SAI_OBJECT_API(acl_api, acl_counter, SAI_OBJECT_TYPE_ACL_COUNTER)
+    STUB_SAI_OBJECT_API(acl_api, acl_range, SAI_OBJECT_TYPE_ACL_RANGE)
+    STUB_SAI_OBJECT_API(acl_api, acl_table_group, SAI_OBJECT_TYPE_ACL_TABLE_GROUP)
+    STUB_SAI_OBJECT_API(acl_api, acl_table_group_member, SAI_OBJECT_TYPE_ACL_TABLE_GROUP_MEMBER)
+
+    STUB_SAI_OBJECT_API(policer_api, policer, SAI_OBJECT_TYPE_POLICER)
+
+    STUB_SAI_OBJECT_API(tunnel_api, tunnel_map, SAI_OBJECT_TYPE_TUNNEL_MAP)
+    STUB_SAI_OBJECT_API(tunnel_api, tunnel, SAI_OBJECT_TYPE_TUNNEL)
+    STUB_SAI_OBJECT_API(tunnel_api, tunnel_term_table_entry, SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY)
+    STUB_SAI_OBJECT_API(tunnel_api, tunnel_map_entry, SAI_OBJECT_TYPE_TUNNEL_MAP_ENTRY)
+
+    STUB_SAI_OBJECT_API(queue_api, queue, SAI_OBJECT_TYPE_QUEUE)
+    queue_api.get_queue_stats = stub_get_stats;
+
+    STUB_SAI_OBJECT_API(scheduler_api, scheduler, SAI_OBJECT_TYPE_SCHEDULER)
+    STUB_SAI_OBJECT_API(scheduler_group_api, scheduler_group, SAI_OBJECT_TYPE_SCHEDULER_GROUP)
+    STUB_SAI_OBJECT_API(wred_api, wred, SAI_OBJECT_TYPE_WRED)
+    STUB_SAI_OBJECT_API(qos_map_api, qos_map, SAI_OBJECT_TYPE_QOS_MAP)
+
+    STUB_SAI_OBJECT_API(buffer_api, buffer_pool, SAI_OBJECT_TYPE_BUFFER_POOL)
+    STUB_SAI_OBJECT_API(buffer_api, ingress_priority_group, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP)
+    STUB_SAI_OBJECT_API(buffer_api, buffer_profile, SAI_OBJECT_TYPE_BUFFER_PROFILE)
+    buffer_api.get_ingress_priority_group_stats = stub_get_stats;
+
+    STUB_SAI_OBJECT_API(dtel_api, dtel, SAI_OBJECT_TYPE_DTEL)
+    STUB_SAI_OBJECT_API(dtel_api, dtel_queue_report, SAI_OBJECT_TYPE_DTEL_QUEUE_REPORT)
+    STUB_SAI_OBJECT_API(dtel_api, dtel_int_session, SAI_OBJECT_TYPE_DTEL_INT_SESSION)
+    STUB_SAI_OBJECT_API(dtel_api, dtel_report_session, SAI_OBJECT_TYPE_DTEL_REPORT_SESSION)
+    STUB_SAI_OBJECT_API(dtel_api, dtel_event, SAI_OBJECT_TYPE_DTEL_EVENT)
+}
+
+/* SAI entry points, replacing the ones of libsairedis */
+
+sai_status_t sai_api_initialize(uint64_t, const sai_service_method_table_t *)
+{
+    initApis();
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_api_uninitialize(void)
+{
+    StubSai::getInstance().reset();
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_log_set(sai_api_t, sai_log_level_t)
+{
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t sai_api_query(sai_api_t api, void **api_method_table)
+{
+    switch (api)
+    {
+        case SAI_API_SWITCH:            *api_method_table = &switch_api; break;
+        case SAI_API_PORT:              *api_method_table = &port_api; break;
+        case SAI_API_BRIDGE:            *api_method_table = &bridge_api; break;
+        case SAI_API_VLAN:              *api_method_table = &vlan_api; break;
+        case SAI_API_LAG:               *api_method_table = &lag_api; break;
+        case SAI_API_FDB:               *api_method_table = &fdb_api; break;
+        case SAI_API_HOSTIF:            *api_method_table = &hostif_api; break;
+        case SAI_API_MIRROR:            *api_method_table = &mirror_api; break;
+        case SAI_API_VIRTUAL_ROUTER:    *api_method_table = &virtual_router_api; break;
+        case SAI_API_ROUTER_INTERFACE:  *api_method_table = &router_interface_api; break;
+        case SAI_API_NEIGHBOR:          *api_method_table = &neighbor_api; break;
+        case SAI_API_NEXT_HOP:          *api_method_table = &next_hop_api; break;
+        case SAI_API_NEXT_HOP_GROUP:    *api_method_table = &next_hop_group_api; break;
+        case SAI_API_ROUTE:             *api_method_table = &route_api; break;
+        case SAI_API_ACL:               *api_method_table = &acl_api; break;
+        case SAI_API_POLICER:           *api_method_table = &policer_api; break;
+        case SAI_API_TUNNEL:            *api_method_table = &tunnel_api; break;
+        case SAI_API_QUEUE:             *api_method_table = &queue_api; break;
+        case SAI_API_SCHEDULER:         *api_method_table = &scheduler_api; break;
+        case SAI_API_SCHEDULER_GROUP:   *api_method_table = &scheduler_group_api; break;
+        case SAI_API_WRED:              *api_method_table = &wred_api; break;
+        case SAI_API_QOS_MAP:           *api_method_table = &qos_map_api; break;
+        case SAI_API_BUFFER:            *api_method_table = &buffer_api; break;
+        case SAI_API_DTEL:              *api_method_table = &dtel_api; break;
+        default:
+            *api_method_table = nullptr;
+            return SAI_STATUS_NOT_SUPPORTED;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_object_type_t sai_object_type_query(sai_object_id_t object_id)
+{
+    return static_cast<sai_object_type_t>(object_id >> STUB_SAI_OID_TYPE_SHIFT);
+}
+
+sai_object_id_t sai_switch_id_query(sai_object_id_t object_id)
+{
+    StubSai &sai = StubSai::getInstance();
+
+    if (object_id == SAI_NULL_OBJECT_ID || !sai.hasObject(object_id))
+    {
+        return SAI_NULL_OBJECT_ID;
+    }
+
+    /* Only one switch is supported */
+    return (static_cast<uint64_t>(SAI_OBJECT_TYPE_SWITCH) << STUB_SAI_OID_TYPE_SHIFT) | 1;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+ * In-process SAI implementation, linked in place of libsairedis so that unit
+ * tests and benchmarks can program SAI objects without syncd.
+ * The orchs run on top of it still need redis for their tables, see orchtest.h.
+ * Objects are kept in one store per object type, with their attributes, and
+ * the route and next hop group member bulk APIs are supported. A latency can
+ * be added to every call to model the cost of the real backend.
+ */
+
+extern "C" {
+#include "sai.h"
+}
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Attribute value, with a copy of the list it points to if any */
+struct StubSaiAttr
+{
+    sai_attribute_value_t   value;
+    std::vector<uint8_t>    list;       // list elements, value's list pointer is not used
+};
+
+typedef std::map<sai_attr_id_t, StubSaiAttr> StubSaiAttrs;
+
+/* StubSaiStore: object key, attributes */
+typedef std::unordered_map<std::string, StubSaiAttrs> StubSaiStore;
+
+class StubSai
+{
+public:
+    static StubSai &getInstance();
+
+    /* Remove all the objects and reset the counters and latencies */
+    void reset();
+
+    /* Latency of every call, and of every object of a bulk call */
+    void setLatency(std::chrono::nanoseconds callLatency,
+                    std::chrono::nanoseconds objectLatency = std::chrono::nanoseconds(0));
+
+    /* Number of front panel ports created along with the switch */
+    void setPortCount(uint32_t count)
+    {
+        m_portCount = count;
+    }
+
+    /* Status returned by the next create/remove/set, to inject failures */
+    void failNext(sai_status_t status, uint32_t count = 1);
+
+    size_t getObjectCount(sai_object_type_t type) const;
+    bool hasObject(sai_object_id_t oid) const;
+    bool hasRoute(const sai_route_entry_t &entry) const;
+    bool hasNeighbor(const sai_neighbor_entry_t &entry) const;
+    bool hasFdb(const sai_fdb_entry_t &entry) const;
+
+    /* Objects of the type, e.g. to look up the ones an orch created */
+    std::vector<sai_object_id_t> getObjects(sai_object_type_t type) const;
+
+    /* Set an attribute without going through the API, e.g. a read-only one */
+    sai_status_t setAttribute(sai_object_id_t oid, const sai_attribute_t &attr);
+
+    /* Number of API calls and of bulk API calls since the last reset */
+    uint64_t getCallCount() const
+    {
+        return m_calls;
+    }
+
+    uint64_t getBulkCallCount() const
+    {
+        return m_bulkCalls;
+    }
+
+    sai_status_t createSwitch(sai_object_id_t *oid, uint32_t count, const sai_attribute_t *attrs);
+    sai_status_t create(sai_object_type_t type, sai_object_id_t *oid, uint32_t count, const sai_attribute_t *attrs);
+    sai_status_t create(sai_object_type_t type, const std::string &key, uint32_t count, const sai_attribute_t *attrs);
+    sai_status_t remove(sai_object_type_t type, const std::string &key);
+    sai_status_t set(sai_object_type_t type, const std::string &key, const sai_attribute_t *attr);
+    sai_status_t get(sai_object_type_t type, const std::string &key, uint32_t count, sai_attribute_t *attrs);
+
+    /* Account for a call of count objects, adding the configured latency */
+    void call(uint32_t count = 1, bool bulk = false);
+
+    static std::string key(sai_object_id_t oid);
+    static std::string key(const sai_route_entry_t &entry);
+    static std::string key(const sai_neighbor_entry_t &entry);
+    static std::string key(const sai_fdb_entry_t &entry);
+
+private:
+    StubSai();
+
+    std::map<sai_object_type_t, StubSaiStore> m_stores;
+    std::map<sai_object_type_t, uint64_t> m_nextIndex;
+
+    std::chrono::nanoseconds m_callLatency;
+    std::chrono::nanoseconds m_objectLatency;
+    uint32_t m_portCount;
+
+    sai_status_t m_failStatus;
+    uint32_t m_failCount;
+
+    uint64_t m_calls;
+    uint64_t m_bulkCalls;
+
+    sai_object_id_t allocate(sai_object_type_t type);
+    StubSaiAttrs *find(sai_object_type_t type, const std::string &key);
+    sai_status_t injectedStatus();
+
+    static void copyIn(sai_object_type_t type, const sai_attribute_t &attr, StubSaiAttr &stored);
+    static sai_status_t copyOut(sai_object_type_t type, const StubSaiAttr &stored, sai_attribute_t &attr);
+};
@@ -0,0 +1,134 @@
+#include <arpa/inet.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "bulker.h"
+#include "stubsai.h"
+
+using namespace std;
+
+class StubSaiTest : public ::testing::Test
+{
+protected:
+    sai_switch_api_t *switch_api;
+    sai_route_api_t *route_api;
+    sai_object_id_t switch_id;
+
+    void SetUp() override
+    {
+        StubSai::getInstance().setPortCount(4);
+
+        sai_api_initialize(0, nullptr);
+        sai_api_query(SAI_API_SWITCH, (void **)&switch_api);
+        sai_api_query(SAI_API_ROUTE, (void **)&route_api);
+
+        sai_attribute_t attr;
+        attr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+        attr.value.booldata = true;
+        ASSERT_EQ(switch_api->create_switch(&switch_id, 1, &attr), SAI_STATUS_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        sai_api_uninitialize();
+    }
+
+    sai_route_entry_t route(uint32_t index)
+    {
+        sai_route_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+
+        entry.switch_id = switch_id;
+        entry.destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+        entry.destination.addr.ip4 = htonl(0x0a000000 | (index << 8));
+        entry.destination.mask.ip4 = htonl(0xffffff00);
+        return entry;
+    }
+};
+
+TEST_F(StubSaiTest, switch_default_objects)
+{
+    sai_object_id_t ports[8];
+    sai_attribute_t attr;
+
+    attr.id = SAI_SWITCH_ATTR_PORT_LIST;
+    attr.value.objlist.count = 2;
+    attr.value.objlist.list = ports;
+    EXPECT_EQ(switch_api->get_switch_attribute(switch_id, 1, &attr), SAI_STATUS_BUFFER_OVERFLOW);
+    EXPECT_EQ(attr.value.objlist.count, 4u);
+
+    attr.value.objlist.count = 8;
+    ASSERT_EQ(switch_api->get_switch_attribute(switch_id, 1, &attr), SAI_STATUS_SUCCESS);
+    ASSERT_EQ(attr.value.objlist.count, 4u);
+    EXPECT_EQ(sai_object_type_query(ports[0]), SAI_OBJECT_TYPE_PORT);
+
+    attr.id = SAI_SWITCH_ATTR_CPU_PORT;
+    ASSERT_EQ(switch_api->get_switch_attribute(switch_id, 1, &attr), SAI_STATUS_SUCCESS);
+    EXPECT_TRUE(StubSai::getInstance().hasObject(attr.value.oid));
+
+    /* CPU port and front panel ports */
+    EXPECT_EQ(StubSai::getInstance().getObjectCount(SAI_OBJECT_TYPE_PORT), 5u);
+}
+
+TEST_F(StubSaiTest, route_entries)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai_route_entry_t entry = route(1);
+
+    sai_attribute_t attr;
+    attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_DROP;
+
+    EXPECT_EQ(route_api->create_route_entry(&entry, 1, &attr), SAI_STATUS_SUCCESS);
+    EXPECT_EQ(route_api->create_route_entry(&entry, 1, &attr), SAI_STATUS_ITEM_ALREADY_EXISTS);
+    EXPECT_TRUE(sai.hasRoute(entry));
+
+    attr.value.s32 = SAI_PACKET_ACTION_FORWARD;
+    EXPECT_EQ(route_api->set_route_entry_attribute(&entry, &attr), SAI_STATUS_SUCCESS);
+
+    attr.value.s32 = SAI_PACKET_ACTION_DROP;
+    EXPECT_EQ(route_api->get_route_entry_attribute(&entry, 1, &attr), SAI_STATUS_SUCCESS);
+    EXPECT_EQ(attr.value.s32, SAI_PACKET_ACTION_FORWARD);
+
+    EXPECT_EQ(route_api->remove_route_entry(&entry), SAI_STATUS_SUCCESS);
+    EXPECT_EQ(route_api->remove_route_entry(&entry), SAI_STATUS_ITEM_NOT_FOUND);
+    EXPECT_FALSE(sai.hasRoute(entry));
+}
+
+TEST_F(StubSaiTest, route_bulker)
+{
+    StubSai &sai = StubSai::getInstance();
+    EntityBulker<sai_route_api_t> bulker(route_api);
+    vector<sai_status_t> results;
+
+    sai_attribute_t attr;
+    attr.id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+    attr.value.s32 = SAI_PACKET_ACTION_DROP;
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        bulker.create(route(i), { attr });
+    }
+    bulker.create(route(0), { attr }, [&](sai_status_t status) { results.push_back(status); });
+
+    uint64_t calls = sai.getCallCount();
+    bulker.flush();
+
+    EXPECT_EQ(sai.getCallCount() - calls, 1u);
+    EXPECT_EQ(sai.getObjectCount(SAI_OBJECT_TYPE_ROUTE_ENTRY), 100u);
+
+    vector<sai_status_t> expected = { SAI_STATUS_ITEM_ALREADY_EXISTS };
+    EXPECT_EQ(results, expected);
+}
+
+TEST_F(StubSaiTest, injected_failure)
+{
+    StubSai &sai = StubSai::getInstance();
+    sai_route_entry_t entry = route(1);
+
+    sai.failNext(SAI_STATUS_INSUFFICIENT_RESOURCES);
+    EXPECT_EQ(route_api->create_route_entry(&entry, 0, nullptr), SAI_STATUS_INSUFFICIENT_RESOURCES);
+    EXPECT_EQ(route_api->create_route_entry(&entry, 0, nullptr), SAI_STATUS_SUCCESS);
+}